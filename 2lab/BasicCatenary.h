@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "Catenary.h"
+#include "hyperbolic.h"
+
+namespace curve {
+
+	// Catenary computed in T throughout: float, double or long double.
+	// float halves the memory traffic and doubles the SIMD lanes of the
+	// batch kernels at about 7 significant digits, long double has no
+	// kernels and loops over the scalar forms.
+	template <class T>
+	class BasicCatenary {
+		static_assert(std::is_floating_point<T>::value, "BasicCatenary needs a floating point type");
+
+		// the batch kernels exist for float and double
+		static constexpr bool vectorized = std::is_same<T, float>::value || std::is_same<T, double>::value;
+
+		struct unchecked {};
+		constexpr BasicCatenary(T ia, unchecked) noexcept : a(ia) {}
+
+		T a;
+
+	public:
+		typedef T value_type;
+		typedef std::pair<std::pair<T, T>, std::pair<T, T>> centers;
+
+		constexpr BasicCatenary() noexcept : a(1) {}
+		// the only way to a curve other than a == 1, nothing if a is zero or not finite
+		static constexpr std::optional<BasicCatenary> make(T ia) noexcept {
+			return ia != 0 && ia - ia == 0 ? std::optional<BasicCatenary>(BasicCatenary(ia, unchecked{})) : std::nullopt;
+		}
+
+		constexpr T get_a() const noexcept { return a; }
+		T y(T x) const { return a * std::cosh(x / a); }
+		T l(T x) const { return a * std::sinh(x / a); }
+		T R(T x) const {
+			const T ch = std::cosh(x / a);
+			return a * ch * ch;
+		}
+		T S(T x1, T x2) const { return a * a * (std::sinh(x2 / a) - std::sinh(x1 / a)); }
+		centers CurvatureCenterCoords(T x) const {
+			const T ch = std::cosh(x / a),
+				sh = std::sinh(x / a),
+				x_expr = std::abs(a) * sh * ch,
+				y_expr = std::abs(a) * ch,
+				y = a * ch;
+			return std::make_pair(
+				std::make_pair(x + x_expr, y - y_expr),
+				std::make_pair(x - x_expr, y + y_expr)
+			);
+		}
+
+		// the double curve with the same coefficient, rounded to double
+		Catenary runtime() const { return Catenary(static_cast<double>(a)); }
+
+		// batch forms, out[i] is the scalar result for xs[i]
+		void y(const T* xs, T* out, std::size_t n) const {
+			if constexpr (vectorized) kernels::ordinate(a, xs, out, n);
+			else for (std::size_t i = 0; i < n; ++i) out[i] = y(xs[i]);
+		}
+		void l(const T* xs, T* out, std::size_t n) const {
+			if constexpr (vectorized) kernels::arc_length(a, xs, out, n);
+			else for (std::size_t i = 0; i < n; ++i) out[i] = l(xs[i]);
+		}
+		void R(const T* xs, T* out, std::size_t n) const {
+			if constexpr (vectorized) kernels::curvature_radius(a, xs, out, n);
+			else for (std::size_t i = 0; i < n; ++i) out[i] = R(xs[i]);
+		}
+		void S(const T* x1s, const T* x2s, T* out, std::size_t n) const {
+			if constexpr (vectorized) kernels::area(a, x1s, x2s, out, n);
+			else for (std::size_t i = 0; i < n; ++i) out[i] = S(x1s[i], x2s[i]);
+		}
+	};
+
+}
@@ -1,44 +1,298 @@
 #include "pch.h"
 #include "Catenary.h"
+#include "hyperbolic.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
 
 double curve::Catenary::S(double x1, double x2) const {
 	return pow(a, 2) * (sinh(x2 / a) - sinh(x1 / a)); 
 }
 
+void curve::Catenary::y(const double* xs, double* out, std::size_t n) const {
+	kernels::ordinate(a, xs, out, n);
+}
+
+void curve::Catenary::l(const double* xs, double* out, std::size_t n) const {
+	kernels::arc_length(a, xs, out, n);
+}
+
+void curve::Catenary::R(const double* xs, double* out, std::size_t n) const {
+	kernels::curvature_radius(a, xs, out, n);
+}
+
+void curve::Catenary::S(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	kernels::area(a, x1s, x2s, out, n);
+}
+
+curve::precision curve::select_precision(double a, double x_min, double x_max, int power, double rel_tolerance) {
+	const double u_max = x_max / std::abs(a);
+	// smaller x, a or x / a lose digits as float subnormals (sinh(x / a)
+	// is x / a down there), larger results overflow, and so does the
+	// cosh(x / a)^power the kernels form before scaling by a < 1
+	const bool fits = std::abs(a) >= FLT_MIN / FLT_EPSILON
+		&& (x_min == 0 || (x_min >= FLT_MIN / FLT_EPSILON && x_min / std::abs(a) >= FLT_MIN / FLT_EPSILON))
+		&& power * u_max < std::log(FLT_MAX) - 1
+		&& std::log(std::abs(a)) + power * u_max < std::log(FLT_MAX) - 1;
+	return fits && power * (3 + 2 * u_max) * FLT_EPSILON <= rel_tolerance ? precision::float32 : precision::float64;
+}
+
+namespace {
+
+	// runs the float kernel over the blocks of xs select_precision passes
+	// and the double one over the rest
+	template <class Single, class Double>
+	void tolerant(double a, const double* xs, double* out, std::size_t n, int power, double rel_tolerance,
+		Single single, Double full)
+	{
+		constexpr std::size_t block = 256;
+		float xf[block], of[block];
+
+		for (std::size_t i = 0; i < n; i += block) {
+			const std::size_t m = std::min(block, n - i);
+			double x_min, x_max;
+			// NaN and infinities are left to the double kernel
+			if (curve::kernels::magnitude_range(xs + i, m, x_min, x_max)
+				&& curve::select_precision(a, x_min, x_max, power, rel_tolerance) == curve::precision::float32)
+			{
+				for (std::size_t j = 0; j < m; ++j) xf[j] = static_cast<float>(xs[i + j]);
+				single(static_cast<float>(a), xf, of, m);
+				for (std::size_t j = 0; j < m; ++j) out[i + j] = of[j];
+			}
+			else full(a, xs + i, out + i, m);
+		}
+	}
+
+	typedef void(*single_kernel)(float, const float*, float*, std::size_t);
+	typedef void(*double_kernel)(double, const double*, double*, std::size_t);
+
+}
+
+void curve::Catenary::y(const double* xs, double* out, std::size_t n, double rel_tolerance) const {
+	tolerant(a, xs, out, n, 1, rel_tolerance,
+		static_cast<single_kernel>(kernels::ordinate), static_cast<double_kernel>(kernels::ordinate));
+}
+
+void curve::Catenary::l(const double* xs, double* out, std::size_t n, double rel_tolerance) const {
+	tolerant(a, xs, out, n, 1, rel_tolerance,
+		static_cast<single_kernel>(kernels::arc_length), static_cast<double_kernel>(kernels::arc_length));
+}
+
+void curve::Catenary::R(const double* xs, double* out, std::size_t n, double rel_tolerance) const {
+	tolerant(a, xs, out, n, 2, rel_tolerance,
+		static_cast<single_kernel>(kernels::curvature_radius), static_cast<double_kernel>(kernels::curvature_radius));
+}
+
 curve::coords_pair curve::Catenary::CurvatureCenterCoords(double x) const {
+	return evaluate(x).centers;
+}
+
+namespace {
 
-	double x_expr = (sinh(x / a) + pow(sinh(x / a), 3)) / abs(cosh(x / a) / a),
-		y_expr = (1 + pow(sinh(x / a), 2)) / abs(cosh(x / a) / a);
+	// radius of curvature is a * cosh^2, the normal is (-sinh, cosh) / cosh,
+	// so the centers lie |a| * (sinh * cosh, cosh) away from the point
+	inline curve::Catenary::point make_point(double a, double x, double ch, double sh) {
+		const double x_expr = std::abs(a) * sh * ch,
+			y_expr = std::abs(a) * ch,
+			y = a * ch;
 
-	return std::make_pair(
-		std::make_pair(x + x_expr, y(x) - y_expr),
-		std::make_pair(x - x_expr, y(x) + y_expr)
-	);
+		return curve::Catenary::point{
+			y, a * sh, a * ch * ch,
+			std::make_pair(
+				std::make_pair(x + x_expr, y - y_expr),
+				std::make_pair(x - x_expr, y + y_expr)
+			),
+			a * a * sh
+		};
+	}
+
+}
+
+void curve::Catenary::CurvatureCenterCoords(const double* xs, coord_view first, coord_view second) const {
+	if (second.size < first.size) {
+		throw std::invalid_argument("center buffer too small");
+	}
+
+	constexpr std::size_t block = 256;
+	double ch[block], sh[block];
+	const double r = std::abs(a);
+
+	for (std::size_t i = 0; i < first.size; i += block) {
+		const std::size_t m = std::min(block, first.size - i);
+		kernels::hyperbolic(a, xs + i, ch, sh, m);
+		for (std::size_t j = 0; j < m; ++j) {
+			const double x = xs[i + j],
+				x_expr = r * sh[j] * ch[j],
+				y_expr = r * ch[j],
+				y = a * ch[j];
+			first.xs[i + j] = x + x_expr;
+			first.ys[i + j] = y - y_expr;
+			second.xs[i + j] = x - x_expr;
+			second.ys[i + j] = y + y_expr;
+		}
+	}
 }
 
-void curve::Catenary::set_a(const double ia) {
-	a = ia;
-	acoeff na;
-	try {
-		na = ia;
+curve::Catenary::point curve::Catenary::evaluate(double x) const {
+	const double u = x / a;
+	double ch, sh;
+
+	if (std::abs(u) < 709) {
+		const double em1 = expm1(std::abs(u)), e = em1 + 1;
+		ch = 0.5 * (e + 1 / e);
+		sh = copysign(0.5 * (em1 + em1 / e), u);
 	}
-	catch (const std::invalid_argument& e) {
-		std::cerr << e.what()
-			<< ", 'a' is now set to '1'"
-			<< std::endl;
-		a = 1;
+	else {
+		ch = cosh(u);
+		sh = sinh(u);
 	}
+
+	return make_point(a, x, ch, sh);
 }
 
-curve::Catenary::Catenary(double ia) : a(ia) {
-	acoeff na;
-	try {
-		na = ia;
+void curve::Catenary::evaluate(const double* xs, point* out, std::size_t n) const {
+	constexpr std::size_t block = 256;
+	double ch[block], sh[block];
+
+	for (std::size_t i = 0; i < n; i += block) {
+		const std::size_t m = std::min(block, n - i);
+		kernels::hyperbolic(a, xs + i, ch, sh, m);
+		for (std::size_t j = 0; j < m; ++j)
+			out[i + j] = make_point(a, xs[i + j], ch[j], sh[j]);
 	}
-	catch (const std::invalid_argument& e) {
-		std::cerr << e.what()
-			<< ", 'a' is now set to '1'"
-			<< std::endl;
-		a = 1;
+}
+
+double curve::Catenary::log_y(double x) const {
+	return log(std::abs(a)) + kernels::log_cosh(x / a);
+}
+
+double curve::Catenary::log_R(double x) const {
+	return log(std::abs(a)) + 2 * kernels::log_cosh(x / a);
+}
+
+namespace {
+
+	// m * 2^e brought to |m| in [1, 2)
+	inline curve::scaled rescale(double m, double e) {
+		int k;
+		const double f = frexp(m, &k);
+		return curve::scaled{ 2 * f, e + k - 1 };
 	}
+
+}
+
+curve::scaled curve::Catenary::scaled_y(double x) const {
+	const curve::scaled sa = rescale(a, 0);
+	double e;
+	const double w = kernels::scaled_cosh(x / a, e);
+	return rescale(sa.mantissa * w, sa.exponent + e);
+}
+
+curve::scaled curve::Catenary::scaled_R(double x) const {
+	const curve::scaled sa = rescale(a, 0);
+	double e;
+	const double w = kernels::scaled_cosh(x / a, e);
+	return rescale(sa.mantissa * w * w, sa.exponent + 2 * e);
+}
+
+void curve::Catenary::log_y(const double* xs, double* out, std::size_t n) const {
+	kernels::log_ordinate(a, xs, out, n);
+}
+
+void curve::Catenary::log_R(const double* xs, double* out, std::size_t n) const {
+	kernels::log_curvature_radius(a, xs, out, n);
+}
+
+namespace {
+
+	template <class Kernel>
+	void scaled_blocks(double a, const double* xs, curve::scaled* out, std::size_t n, Kernel kernel) {
+		constexpr std::size_t block = 256;
+		double ms[block], es[block];
+
+		for (std::size_t i = 0; i < n; i += block) {
+			const std::size_t m = std::min(block, n - i);
+			kernel(a, xs + i, ms, es, m);
+			for (std::size_t j = 0; j < m; ++j)
+				out[i + j] = curve::scaled{ ms[j], es[j] };
+		}
+	}
+
+}
+
+void curve::Catenary::scaled_y(const double* xs, scaled* out, std::size_t n) const {
+	scaled_blocks(a, xs, out, n, kernels::scaled_ordinate);
+}
+
+void curve::Catenary::scaled_R(const double* xs, scaled* out, std::size_t n) const {
+	scaled_blocks(a, xs, out, n, kernels::scaled_curvature_radius);
+}
+
+double curve::Catenary::x_of_y(double y) const {
+	return std::abs(a) * acosh(y / a);
+}
+
+double curve::Catenary::x_of_l(double l) const {
+	return a * asinh(l / a);
+}
+
+double curve::Catenary::x2_of_S(double x1, double S) const {
+	return a * asinh(S / (a * a) + sinh(x1 / a));
+}
+
+void curve::Catenary::x_of_y(const double* ys, double* out, std::size_t n) const {
+	kernels::inverse_ordinate(a, ys, out, n);
+}
+
+void curve::Catenary::x_of_l(const double* ls, double* out, std::size_t n) const {
+	kernels::inverse_arc_length(a, ls, out, n);
+}
+
+void curve::Catenary::x2_of_S(const double* x1s, const double* Ss, double* out, std::size_t n) const {
+	kernels::inverse_area(a, x1s, Ss, out, n);
+}
+
+namespace {
+
+	// ln sinh(x) for x > 0 without the overflow of sinh
+	inline double log_sinh(double x) {
+		return x < 20 ? log(sinh(x)) : x - log(2.0) + log1p(-exp(-2 * x));
+	}
+
+}
+
+// sag = a (cosh(h / a) - 1) with h = span / 2; in t = h / a that is
+// (cosh t - 1) / t = sag / h, solved by Halley's method on the log of both
+// sides, F(t) = ln 2 + 2 ln sinh(t / 2) - ln t - ln(sag / h), which is
+// close to linear for large t and to ln t for small t
+double curve::Catenary::fit_a(double span, double sag) {
+	if (!(span > 0) || !(sag > 0) || std::isinf(span) || std::isinf(sag))
+		return NAN;
+
+	const double h = span / 2, k = sag / h, log_k = log(k);
+	double t = k < 1 ? 2 * k : log(2 * k) + log(log(2 * k) + 1);
+
+	for (int i = 0; i < 64; ++i) {
+		const double sh = sinh(t / 2), coth = sh == 0 ? 2 / t : cosh(t / 2) / sh;
+		const double F = log(2.0) + 2 * log_sinh(t / 2) - log(t) - log_k,
+			dF = coth - 1 / t,
+			ddF = 1 / (t * t) - (std::isinf(sh) ? 0 : 1 / (2 * sh * sh));
+		double step = 2 * F * dF / (2 * dF * dF - F * ddF);
+		if (!(step < t)) step = t / 2;
+		t -= step;
+		if (std::abs(step) <= 4 * DBL_EPSILON * t) break;
+	}
+	return h / t;
+}
+
+void curve::Catenary::fit_a(const double* spans, const double* sags, double* out, std::size_t n) {
+	for (std::size_t i = 0; i < n; ++i) out[i] = fit_a(spans[i], sags[i]);
+}
+
+double curve::Catenary::rejected_a() noexcept {
+	std::cerr << "wrong value for 'a', 'a' is now set to '1'" << std::endl;
+	return 1;
 }
\ No newline at end of file
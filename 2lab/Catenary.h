@@ -1,39 +1,118 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+#include "CoordBuffer.h"
+#include "UniformSweep.h"
 
 namespace curve {
 
-	typedef std::pair<double, double> coord;
 	typedef std::pair<coord, coord> coords_pair;
 
+	// mantissa * 2^exponent with |mantissa| in [1, 2) and an integral exponent,
+	// holds the magnitudes y and R reach long after a double overflows
+	struct scaled {
+		double mantissa, exponent;
+
+		// ln|mantissa * 2^exponent|
+		double log() const { return std::log(std::abs(mantissa)) + exponent * 0.69314718055994530942; }
+		// the plain double, +-INFINITY or 0 outside its range
+		double value() const { return std::ldexp(mantissa, static_cast<int>(std::fmax(std::fmin(exponent, 4096), -4096))); }
+	};
+
+	// the arithmetic a batch runs in
+	enum class precision { float32, float64 };
+
+	// float32 if cosh(x / a)^power, a * cosh(x / a)^power and a * sinh(x / a)
+	// all fit a float within rel_tolerance for every x == 0 or
+	// x_min <= |x| <= x_max, the unscaled power mattering for |a| < 1: the float
+	// kernels are good to (3 + 2 |x / a|) float eps relative, the roundings
+	// of x and a included, and power times that for R (power 2)
+	precision select_precision(double a, double x_min, double x_max, int power, double rel_tolerance);
+
 	class Catenary {
-		struct acoeff {
-			double a;
-			acoeff() : a(1) {}
-			acoeff(double a) : a(a) {
-				if (a == 0) {
-					throw std::invalid_argument(
-						"wrong value for 'a'"
-					);
-				}
-			}
+	public:
+
+		// everything known about the curve at one abscissa
+		struct point {
+			double y, l, R;
+			coords_pair centers;
+			double S; // area under the curve over [0, x], S(x1, x2) == p2.S - p1.S
 		};
 
+	private:
+		struct unchecked {};
+		constexpr Catenary(double ia, unchecked) noexcept : a(ia) {}
+
+		// reports a == 0 on std::cerr and returns the 1 used instead, kept out
+		// of line so construction inlines to a compare and a store
+		static double rejected_a() noexcept;
+
 		double a;
 
 	public:
 
-		Catenary() : a(1) {}
-		Catenary(double ia);
-		void set_a(const double ia);
-		double get_a() const { return a; }
+		constexpr Catenary() noexcept : a(1) {}
+		// a == 0 is reported and replaced by 1, see make for a silent check
+		constexpr Catenary(double ia) noexcept : a(ia != 0 ? ia : rejected_a()) {}
+		// the curve, or nothing if a is zero or not finite (ia - ia is NaN then)
+		static constexpr std::optional<Catenary> make(double ia) noexcept {
+			return ia != 0 && ia - ia == 0 ? std::optional<Catenary>(Catenary(ia, unchecked{})) : std::nullopt;
+		}
+		void set_a(const double ia) noexcept { a = ia != 0 ? ia : rejected_a(); }
+		constexpr double get_a() const noexcept { return a; }
 		double y(double x) const { return a * cosh(x / a); }
 		double l(double x) const { return a * sinh(x / a); }
 		double R(double x) const { return a * pow(cosh(x / a), 2); }
 		coords_pair CurvatureCenterCoords(double x) const;
 		double S(double x1, double x2) const;
+		point evaluate(double x) const;
+		// log domain, finite for every finite x: ln|y(x)|, ln|R(x)|,
+		// and y and R themselves as scaled
+		double log_y(double x) const;
+		double log_R(double x) const;
+		scaled scaled_y(double x) const;
+		scaled scaled_R(double x) const;
+		// inverses, NaN where there is no solution: the x >= 0 with
+		// y(x) == y, the x with l(x) == l, the x2 with S(x1, x2) == S
+		double x_of_y(double y) const;
+		double x_of_l(double l) const;
+		double x2_of_S(double x1, double S) const;
+		// a > 0 of the curve hanging between two supports at one height,
+		// span apart, with its vertex sag below them
+		static double fit_a(double span, double sag);
+		// y and l at x0, x0 + h, ... x0 + (n - 1) * h by recurrence, see UniformSweep
+		UniformSweep sweep(double x0, double h, std::size_t n) const { return UniformSweep(a, x0, h, n); }
+
+		// batch forms, out[i] is the scalar result for xs[i]
+		void y(const double* xs, double* out, std::size_t n) const;
+		void l(const double* xs, double* out, std::size_t n) const;
+		void R(const double* xs, double* out, std::size_t n) const;
+		void S(const double* x1s, const double* x2s, double* out, std::size_t n) const;
+		void evaluate(const double* xs, point* out, std::size_t n) const;
+		// centers for xs[0 .. first.size) written straight into SoA storage;
+		// throws std::invalid_argument if second is shorter than first
+		void CurvatureCenterCoords(const double* xs, coord_view first, coord_view second) const;
+		void log_y(const double* xs, double* out, std::size_t n) const;
+		void log_R(const double* xs, double* out, std::size_t n) const;
+		void scaled_y(const double* xs, scaled* out, std::size_t n) const;
+		void scaled_R(const double* xs, scaled* out, std::size_t n) const;
+		void x_of_y(const double* ys, double* out, std::size_t n) const;
+		void x_of_l(const double* ls, double* out, std::size_t n) const;
+		void x2_of_S(const double* x1s, const double* Ss, double* out, std::size_t n) const;
+		static void fit_a(const double* spans, const double* sags, double* out, std::size_t n);
+		// the same within rel_tolerance, each block of xs in float32 where
+		// select_precision allows it, so loose tolerances run twice the lanes
+		void y(const double* xs, double* out, std::size_t n, double rel_tolerance) const;
+		void l(const double* xs, double* out, std::size_t n, double rel_tolerance) const;
+		void R(const double* xs, double* out, std::size_t n, double rel_tolerance) const;
 
 	};
 
+	static_assert(std::is_trivially_copyable<Catenary>::value && sizeof(Catenary) == sizeof(double),
+		"Catenary is passed and stored as a plain double");
+
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "CatenaryArray.h"
+#include "hyperbolic.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace {
+
+	// gathered coefficients are staged through the stack in blocks this long
+	constexpr std::size_t block = 256;
+
+}
+
+curve::CatenaryArray::CatenaryArray(const double* as, std::size_t n) : CatenaryArray() {
+	reserve(n);
+	for (std::size_t i = 0; i < n; ++i) push_back(as[i]);
+}
+
+void curve::CatenaryArray::reserve(std::size_t n) {
+	if (n <= stride) return;
+
+	const std::size_t per_line = alignment / sizeof(double);
+	const std::size_t new_stride = (n + per_line - 1) / per_line * per_line;
+	double* const grown = static_cast<double*>(::operator new(3 * new_stride * sizeof(double), std::align_val_t(alignment)));
+
+	if (data) {
+		for (std::size_t column = 0; column < 3; ++column)
+			std::memcpy(grown + column * new_stride, data + column * stride, count * sizeof(double));
+		::operator delete(data, std::align_val_t(alignment));
+	}
+	data = grown;
+	stride = new_stride;
+}
+
+void curve::CatenaryArray::release() noexcept {
+	if (data) ::operator delete(data, std::align_val_t(alignment));
+	data = nullptr;
+	count = stride = 0;
+}
+
+void curve::CatenaryArray::store(std::size_t i, double a) {
+	// a subnormal a is a valid Catenary, but its 1 / a overflows
+	if (!Catenary::make(a) || !std::isfinite(1 / a)) {
+		throw std::invalid_argument("wrong value for 'a'");
+	}
+	data[i] = a;
+	data[stride + i] = 1 / a;
+	data[2 * stride + i] = a * a;
+}
+
+void curve::CatenaryArray::push_back(double a) {
+	// doubling keeps the copies amortized O(1) per curve
+	if (count == stride) reserve(std::max<std::size_t>(2 * stride, alignment / sizeof(double)));
+	store(count, a);
+	++count;
+}
+
+void curve::CatenaryArray::set_a(std::size_t i, double a) {
+	store(i, a);
+}
+
+void curve::CatenaryArray::y(const double* xs, double* out) const {
+	kernels::ordinate_each(a(), inv_a(), xs, out, count);
+}
+
+void curve::CatenaryArray::l(const double* xs, double* out) const {
+	kernels::arc_length_each(a(), inv_a(), xs, out, count);
+}
+
+void curve::CatenaryArray::R(const double* xs, double* out) const {
+	kernels::curvature_radius_each(a(), inv_a(), xs, out, count);
+}
+
+void curve::CatenaryArray::S(const double* x1s, const double* x2s, double* out) const {
+	kernels::area_each(a2(), inv_a(), x1s, x2s, out, count);
+}
+
+namespace {
+
+	// runs kernel(first, second, xs + i, out + i, m) over blocks with the
+	// columns first and second gathered by idx
+	template <class Kernel>
+	void gathered(const double* first, const double* second, const std::uint32_t* idx,
+		const double* xs, double* out, std::size_t n, Kernel kernel)
+	{
+		double f[block], s[block];
+		for (std::size_t i = 0; i < n; i += block) {
+			const std::size_t m = std::min(block, n - i);
+			for (std::size_t j = 0; j < m; ++j) {
+				f[j] = first[idx[i + j]];
+				s[j] = second[idx[i + j]];
+			}
+			kernel(f, s, xs + i, out + i, m);
+		}
+	}
+
+}
+
+void curve::CatenaryArray::y(const std::uint32_t* idx, const double* xs, double* out, std::size_t n) const {
+	gathered(a(), inv_a(), idx, xs, out, n, kernels::ordinate_each);
+}
+
+void curve::CatenaryArray::l(const std::uint32_t* idx, const double* xs, double* out, std::size_t n) const {
+	gathered(a(), inv_a(), idx, xs, out, n, kernels::arc_length_each);
+}
+
+void curve::CatenaryArray::R(const std::uint32_t* idx, const double* xs, double* out, std::size_t n) const {
+	gathered(a(), inv_a(), idx, xs, out, n, kernels::curvature_radius_each);
+}
+
+void curve::CatenaryArray::S(const std::uint32_t* idx, const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	double a2s[block], inv_as[block];
+	for (std::size_t i = 0; i < n; i += block) {
+		const std::size_t m = std::min(block, n - i);
+		for (std::size_t j = 0; j < m; ++j) {
+			a2s[j] = a2()[idx[i + j]];
+			inv_as[j] = inv_a()[idx[i + j]];
+		}
+		kernels::area_each(a2s, inv_as, x1s + i, x2s + i, out + i, m);
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "Catenary.h"
+
+namespace curve {
+
+	// Many curves, each with its own a, in one allocation: the columns a[],
+	// 1 / a[] and a^2[] one after another, each on a cache line, so per-curve
+	// batches stream three arrays instead of chasing one object per curve.
+	// Per-curve results use the precomputed 1 / a and agree with Catenary to
+	// a few ulp of x / a (a multiply may round differently from the division).
+	class CatenaryArray {
+	public:
+		static constexpr std::size_t alignment = 64;
+
+		CatenaryArray() noexcept : data(nullptr), count(0), stride(0) {}
+		explicit CatenaryArray(std::size_t capacity) : CatenaryArray() { reserve(capacity); }
+		// throws std::invalid_argument if any a is zero, not finite or so
+		// small (subnormal) that 1 / a is not finite
+		CatenaryArray(const double* as, std::size_t n);
+		CatenaryArray(CatenaryArray&& other) noexcept : CatenaryArray() { swap(other); }
+		CatenaryArray& operator=(CatenaryArray&& other) noexcept { swap(other); return *this; }
+		CatenaryArray(const CatenaryArray&) = delete;
+		CatenaryArray& operator=(const CatenaryArray&) = delete;
+		~CatenaryArray() { release(); }
+
+		// keeps the curves, reallocates only to grow
+		void reserve(std::size_t n);
+		// throws std::invalid_argument if a is zero, not finite or 1 / a is not
+		void push_back(double a);
+		void set_a(std::size_t i, double a);
+		void clear() noexcept { count = 0; }
+
+		std::size_t size() const { return count; }
+		std::size_t capacity() const { return stride; }
+		Catenary operator[](std::size_t i) const { return Catenary(data[i]); }
+
+		const double* a() const { return data; }
+		const double* inv_a() const { return data + stride; }
+		const double* a2() const { return data + 2 * stride; }
+
+		// per curve: out[i] is curve i at xs[i], for every i < size()
+		void y(const double* xs, double* out) const;
+		void l(const double* xs, double* out) const;
+		void R(const double* xs, double* out) const;
+		void S(const double* x1s, const double* x2s, double* out) const;
+
+		// gather: out[k] is curve idx[k] at xs[k], for k < n
+		void y(const std::uint32_t* idx, const double* xs, double* out, std::size_t n) const;
+		void l(const std::uint32_t* idx, const double* xs, double* out, std::size_t n) const;
+		void R(const std::uint32_t* idx, const double* xs, double* out, std::size_t n) const;
+		void S(const std::uint32_t* idx, const double* x1s, const double* x2s, double* out, std::size_t n) const;
+
+		void swap(CatenaryArray& other) noexcept {
+			std::swap(data, other.data);
+			std::swap(count, other.count);
+			std::swap(stride, other.stride);
+		}
+
+	private:
+		void release() noexcept;
+		void store(std::size_t i, double a);
+
+		double* data;
+		std::size_t count, stride;
+	};
+
+}
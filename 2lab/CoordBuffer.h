@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace curve {
+
+	typedef std::pair<double, double> coord;
+
+	// Non-owning structure-of-arrays window over coordinates,
+	// xs and ys point to size contiguous values each.
+	template <class T>
+	struct basic_coord_view {
+		T* xs;
+		T* ys;
+		std::size_t size;
+
+		coord operator[](std::size_t i) const { return std::make_pair(xs[i], ys[i]); }
+
+		basic_coord_view subview(std::size_t offset, std::size_t count) const {
+			return basic_coord_view{ xs + offset, ys + offset, count };
+		}
+
+		operator basic_coord_view<const T>() const {
+			return basic_coord_view<const T>{ xs, ys, size };
+		}
+	};
+
+	typedef basic_coord_view<double> coord_view;
+	typedef basic_coord_view<const double> const_coord_view;
+
+	// Owning SoA coordinate storage: one allocation, xs[] followed by ys[],
+	// both starting on a cache line so batch kernels can store straight into it.
+	class CoordBuffer {
+	public:
+		static constexpr std::size_t alignment = 64;
+
+		CoordBuffer() : data(nullptr), count(0), stride(0) {}
+		explicit CoordBuffer(std::size_t n) : CoordBuffer() { resize(n); }
+		CoordBuffer(CoordBuffer&& other) noexcept : CoordBuffer() { swap(other); }
+		CoordBuffer& operator=(CoordBuffer&& other) noexcept { swap(other); return *this; }
+		CoordBuffer(const CoordBuffer&) = delete;
+		CoordBuffer& operator=(const CoordBuffer&) = delete;
+		~CoordBuffer() { release(); }
+
+		// contents are not preserved
+		void resize(std::size_t n) {
+			if (n <= stride) {
+				count = n;
+				return;
+			}
+			release();
+			const std::size_t per_line = alignment / sizeof(double);
+			stride = (n + per_line - 1) / per_line * per_line;
+			data = static_cast<double*>(::operator new(2 * stride * sizeof(double), std::align_val_t(alignment)));
+			count = n;
+		}
+
+		std::size_t size() const { return count; }
+		double* xs() { return data; }
+		double* ys() { return data + stride; }
+		const double* xs() const { return data; }
+		const double* ys() const { return data + stride; }
+
+		coord operator[](std::size_t i) const { return std::make_pair(xs()[i], ys()[i]); }
+
+		coord_view view() { return coord_view{ xs(), ys(), count }; }
+		const_coord_view view() const { return const_coord_view{ xs(), ys(), count }; }
+
+		void swap(CoordBuffer& other) noexcept {
+			std::swap(data, other.data);
+			std::swap(count, other.count);
+			std::swap(stride, other.stride);
+		}
+
+	private:
+		void release() {
+			if (data) ::operator delete(data, std::align_val_t(alignment));
+			data = nullptr;
+			count = stride = 0;
+		}
+
+		double* data;
+		std::size_t count, stride;
+	};
+
+}
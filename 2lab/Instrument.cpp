@@ -0,0 +1,206 @@
+#include "pch.h"
+#include "Instrument.h"
+
+#include <csignal>
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+	const char* const names[] = {
+		"ordinate",
+		"arc_length",
+		"curvature_radius",
+		"curvature_centers",
+		"area",
+		"prompt",
+		"read_line",
+		"refill",
+		"parse",
+		"format",
+		"flush",
+		"map"
+	};
+
+	static_assert(sizeof(names) / sizeof(*names) == instrument::stage_count, "a name for every stage");
+
+	// position of the highest set bit, v > 0
+	unsigned top_bit(std::uint64_t v) {
+#ifdef _MSC_VER
+		unsigned long b;
+		_BitScanReverse64(&b, v);
+		return static_cast<unsigned>(b);
+#else
+		return 63 - static_cast<unsigned>(__builtin_clzll(v));
+#endif
+	}
+
+}
+
+const char* instrument::name(stage s) {
+	return names[static_cast<std::size_t>(s)];
+}
+
+std::size_t instrument::histogram::index(std::uint64_t ns) {
+	if (ns < sub_count) return static_cast<std::size_t>(ns);
+	const unsigned e = top_bit(ns);
+	if (e > max_exponent) return bucket_count - 1;
+	// the sub_bits bits below the top one pick the bucket within [2^e, 2^(e + 1))
+	return static_cast<std::size_t>(sub_count + (e - sub_bits) * sub_count + ((ns >> (e - sub_bits)) & (sub_count - 1)));
+}
+
+std::uint64_t instrument::histogram::lower(std::size_t bucket) {
+	if (bucket < sub_count) return bucket;
+	const unsigned shift = static_cast<unsigned>((bucket - sub_count) / sub_count);
+	return (sub_count + (bucket - sub_count) % sub_count) << shift;
+}
+
+std::uint64_t instrument::histogram::upper(std::size_t bucket) {
+	if (bucket < sub_count) return bucket;
+	const unsigned shift = static_cast<unsigned>((bucket - sub_count) / sub_count);
+	return lower(bucket) + (std::uint64_t(1) << shift) - 1;
+}
+
+void instrument::histogram::record(std::uint64_t ns) {
+	// two read-modify-writes, the count is summed from the buckets on demand
+	buckets[index(ns)].fetch_add(1, std::memory_order_relaxed);
+	total_ns.fetch_add(ns, std::memory_order_relaxed);
+
+	// the extremes rarely move, so the loads usually settle it without a write
+	std::uint64_t m = least.load(std::memory_order_relaxed);
+	while (ns < m && !least.compare_exchange_weak(m, ns, std::memory_order_relaxed)) {}
+	m = greatest.load(std::memory_order_relaxed);
+	while (ns > m && !greatest.compare_exchange_weak(m, ns, std::memory_order_relaxed)) {}
+}
+
+std::uint64_t instrument::histogram::count() const {
+	std::uint64_t n = 0;
+	for (const auto& b : buckets) n += b.load(std::memory_order_relaxed);
+	return n;
+}
+
+void instrument::histogram::reset() {
+	for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+	total_ns.store(0, std::memory_order_relaxed);
+	least.store(UINT64_MAX, std::memory_order_relaxed);
+	greatest.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t instrument::histogram::percentile(double q) const {
+	const std::uint64_t n = count();
+	if (n == 0) return 0;
+
+	// the rank of the quantile, at least the first sample
+	std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(n) + 0.5);
+	if (rank == 0) rank = 1;
+
+	std::uint64_t seen = 0;
+	for (std::size_t i = 0; i < bucket_count; ++i) {
+		seen += at(i);
+		if (seen >= rank) {
+			const std::uint64_t u = upper(i);
+			return u < max() ? u : max();
+		}
+	}
+	return max();
+}
+
+void instrument::profile::reset() {
+	for (auto& s : stages) {
+		s.latency.reset();
+		s.items.store(0, std::memory_order_relaxed);
+	}
+}
+
+void instrument::profile::write_json(std::FILE* f) const {
+	static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+	static const char* const quantile_names[] = { "p50_ns", "p90_ns", "p99_ns", "p999_ns" };
+
+	std::fputs("{\n  \"stages\": [", f);
+	bool first = true;
+
+	for (std::size_t i = 0; i < stage_count; ++i) {
+		const histogram& h = stages[i].latency;
+		const std::uint64_t n = h.count();
+		if (n == 0) continue;
+
+		std::fprintf(f, "%s\n    {\n      \"name\": \"%s\",\n      \"count\": %llu,\n      \"items\": %llu,\n"
+			"      \"total_ns\": %llu,\n      \"min_ns\": %llu,\n      \"mean_ns\": %.1f,\n      \"max_ns\": %llu,\n",
+			first ? "" : ",", names[i],
+			static_cast<unsigned long long>(n),
+			static_cast<unsigned long long>(stages[i].items.load(std::memory_order_relaxed)),
+			static_cast<unsigned long long>(h.sum()),
+			static_cast<unsigned long long>(h.min()),
+			static_cast<double>(h.sum()) / static_cast<double>(n),
+			static_cast<unsigned long long>(h.max()));
+		for (std::size_t k = 0; k < sizeof(quantiles) / sizeof(*quantiles); ++k)
+			std::fprintf(f, "      \"%s\": %llu,\n", quantile_names[k],
+				static_cast<unsigned long long>(h.percentile(quantiles[k])));
+
+		std::fputs("      \"histogram\": [", f);
+		bool first_bucket = true;
+		for (std::size_t b = 0; b < histogram::bucket_count; ++b) {
+			const std::uint64_t c = h.at(b);
+			if (!c) continue;
+			std::fprintf(f, "%s[%llu, %llu]", first_bucket ? "" : ", ",
+				static_cast<unsigned long long>(histogram::upper(b)), static_cast<unsigned long long>(c));
+			first_bucket = false;
+		}
+		std::fputs("]\n    }", f);
+		first = false;
+	}
+
+	std::fputs(first ? "]\n}\n" : "\n  ]\n}\n", f);
+}
+
+#ifdef CURVE_INSTRUMENT
+
+namespace {
+
+	const char* dump_path = nullptr;
+
+	void dump_at_exit() {
+		instrument::dump(dump_path);
+	}
+
+	void dump_on_signal(int sig) {
+		instrument::dump(dump_path);
+		std::signal(sig, SIG_DFL);
+		std::raise(sig);
+	}
+
+}
+
+instrument::profile& instrument::global() {
+	static profile p;
+	return p;
+}
+
+bool instrument::dump(const char* path) {
+	std::FILE* f = path ? std::fopen(path, "w") : stderr;
+	if (!f) return false;
+	global().write_json(f);
+	if (path) std::fclose(f);
+	else std::fflush(f);
+	return true;
+}
+
+void instrument::install(const char* path) {
+	static std::atomic<bool> installed{ false };
+	dump_path = path;
+	if (installed.exchange(true)) return;
+
+	// constructed now, so it outlives the exit handler
+	global();
+	std::atexit(dump_at_exit);
+	std::signal(SIGINT, dump_on_signal);
+	std::signal(SIGTERM, dump_on_signal);
+#ifdef SIGBREAK
+	std::signal(SIGBREAK, dump_on_signal);
+#endif
+}
+
+#endif
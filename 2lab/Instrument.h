@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Latency histograms for the hot paths, compiled in only with CURVE_INSTRUMENT
+// defined (for every translation unit, e.g. in the project's preprocessor
+// definitions). Without it the probes below expand to nothing, or to the
+// bare expression for CURVE_TIMED, and no profile exists at run time.
+//
+//   CURVE_PROBE(flush);                        // times the rest of the block
+//   out.write(CURVE_TIMED(ordinate, c.y(x)));   // times one expression
+//   CURVE_COUNT(refill, got);                   // adds to the stage's items
+//
+// instrument::install(path) dumps the profile as JSON to path (stderr for
+// nullptr) at exit and on SIGINT / SIGTERM.
+namespace instrument {
+
+	// the operations in menu order (as batch::op and curve::query), then
+	// the stages of the I/O around them
+	enum class stage : unsigned {
+		ordinate,
+		arc_length,
+		curvature_radius,
+		curvature_centers,
+		area,
+		prompt,		// sfio::safe_cin, the user's typing included
+		read_line,	// sfio::read_line
+		refill,		// buffered_reader pulling a block, items are bytes
+		parse,		// one batch record from text
+		format,		// buffered_writer turning a double into text
+		flush,		// buffered_writer handing its buffer to fwrite, items are bytes
+		map,		// bulk mapping a job file
+		count
+	};
+
+	constexpr std::size_t stage_count = static_cast<std::size_t>(stage::count);
+
+	const char* name(stage s);
+
+	// HDR-style log-linear histogram of nanoseconds: exact below 16, then 16
+	// buckets per power of two, so any value is known to within 1/16 of
+	// itself up to 2^48 ns (about 3 days). Recording is two relaxed atomic
+	// adds and two compares, threads may record concurrently.
+	class histogram {
+	public:
+		static constexpr unsigned sub_bits = 4;
+		static constexpr std::uint64_t sub_count = 1 << sub_bits;
+		static constexpr unsigned max_exponent = 47;
+		static constexpr std::size_t bucket_count = sub_count + (max_exponent - sub_bits + 1) * sub_count;
+
+		histogram() { reset(); }
+		histogram(const histogram&) = delete;
+		histogram& operator=(const histogram&) = delete;
+
+		void record(std::uint64_t ns);
+		void reset();
+
+		std::uint64_t count() const;
+		std::uint64_t sum() const { return total_ns.load(std::memory_order_relaxed); }
+		// 0 if nothing was recorded
+		std::uint64_t min() const {
+			const std::uint64_t m = least.load(std::memory_order_relaxed);
+			return m == UINT64_MAX ? 0 : m;
+		}
+		std::uint64_t max() const { return greatest.load(std::memory_order_relaxed); }
+		// the upper bound of the bucket holding the q-quantile, q in [0, 1]
+		std::uint64_t percentile(double q) const;
+
+		std::uint64_t at(std::size_t bucket) const { return buckets[bucket].load(std::memory_order_relaxed); }
+		static std::size_t index(std::uint64_t ns);
+		// the least and the greatest value of a bucket
+		static std::uint64_t lower(std::size_t bucket);
+		static std::uint64_t upper(std::size_t bucket);
+
+	private:
+		std::array<std::atomic<std::uint64_t>, bucket_count> buckets;
+		std::atomic<std::uint64_t> total_ns, least, greatest;
+	};
+
+	// one histogram and one item counter per stage
+	class profile {
+	public:
+		void record(stage s, std::uint64_t ns) { stages[static_cast<std::size_t>(s)].latency.record(ns); }
+		void add(stage s, std::uint64_t items) {
+			stages[static_cast<std::size_t>(s)].items.fetch_add(items, std::memory_order_relaxed);
+		}
+
+		const histogram& latency(stage s) const { return stages[static_cast<std::size_t>(s)].latency; }
+		std::uint64_t items(stage s) const { return stages[static_cast<std::size_t>(s)].items.load(std::memory_order_relaxed); }
+
+		void reset();
+		// every stage seen at least once: counts, min / mean / max, the usual
+		// percentiles and the nonzero buckets as [upper bound, count] pairs
+		void write_json(std::FILE* f) const;
+
+	private:
+		struct alignas(64) slot {
+			histogram latency;
+			std::atomic<std::uint64_t> items{ 0 };
+		};
+
+		std::array<slot, stage_count> stages;
+	};
+
+	// times its own lifetime into p
+	class scope {
+	public:
+		typedef std::chrono::steady_clock clock;
+
+		scope(profile& p, stage s) noexcept : p(p), s(s), start(clock::now()) {}
+		~scope() {
+			p.record(s, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count()));
+		}
+
+		scope(const scope&) = delete;
+		scope& operator=(const scope&) = delete;
+
+	private:
+		profile& p;
+		stage s;
+		clock::time_point start;
+	};
+
+#ifdef CURVE_INSTRUMENT
+
+	// the process-wide profile the probes record into
+	profile& global();
+	// dumps global() as JSON to path, or to stderr for nullptr
+	bool dump(const char* path);
+	// dump(path) at exit and on SIGINT / SIGTERM, which are then re-raised;
+	// the signal dump is best effort, stdio is not async-signal-safe
+	void install(const char* path);
+
+	template <class F>
+	auto timed(stage s, F f) -> decltype(f()) {
+		const scope probe(global(), s);
+		return f();
+	}
+
+#define CURVE_PROBE_JOIN_(a, b) a##b
+#define CURVE_PROBE_JOIN(a, b) CURVE_PROBE_JOIN_(a, b)
+#define CURVE_PROBE(name) const ::instrument::scope CURVE_PROBE_JOIN(curve_probe_, __LINE__)(::instrument::global(), ::instrument::stage::name)
+#define CURVE_TIMED(name, ...) ::instrument::timed(::instrument::stage::name, [&] { return __VA_ARGS__; })
+#define CURVE_COUNT(name, n) ::instrument::global().add(::instrument::stage::name, (n))
+
+#else
+
+#define CURVE_PROBE(name) ((void)0)
+#define CURVE_TIMED(name, ...) (__VA_ARGS__)
+#define CURVE_COUNT(name, n) ((void)0)
+
+#endif
+
+}
@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "Integrator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+	// ends per kernel call, staged on the stack
+	constexpr std::size_t block = 256;
+
+	// one end of an interval: x, u = x / a, cosh(u) and sinh(u)
+	struct end {
+		double x, u, ch, sh;
+	};
+
+	// int_0^u t cosh(t) dt = u sinh(u) - (cosh(u) - 1), the bracket taken as
+	// sinh^2 / (cosh + 1) so that nothing cancels near the vertex
+	double first_moment(const end& e) {
+		return e.u * e.sh - e.sh * (e.sh / (e.ch + 1));
+	}
+
+	// int_0^u t^2 cosh(t) dt; the closed form u^2 sinh - 2u cosh + 2 sinh
+	// cancels to u^3 / 3 near the vertex, so there the series is summed
+	double second_moment(const end& e) {
+		if (std::abs(e.u) >= 1) return (e.u * e.u + 2) * e.sh - 2 * e.u * e.ch;
+
+		// sum of u^(2k + 3) / ((2k + 3) (2k)!), k = 0..9 reaches 1e-17
+		const double u2 = e.u * e.u;
+		double term = e.u * u2, sum = 0;
+		for (int k = 0; k < 10; ++k) {
+			sum += term / (2 * k + 3);
+			term *= u2 / ((2 * k + 1) * (2 * k + 2));
+		}
+		return sum;
+	}
+
+}
+
+const double curve::Integrator::legendre_nodes[order / 2] = {
+	0.183434642495649804939476142360184,
+	0.525532409916328985817739049189246,
+	0.796666477413626739591553936475830,
+	0.960289856497536231683560868569473
+};
+
+const double curve::Integrator::legendre_weights[order / 2] = {
+	0.362683783378361982965150449277196,
+	0.313706645877887287337962201986601,
+	0.222381034453374470544355994426241,
+	0.101228536290376259152531354309962
+};
+
+curve::Integrator::Integrator(double a) : a(a) {
+	if (a == 0 || !std::isfinite(a)) {
+		throw std::invalid_argument("wrong value for 'a'");
+	}
+}
+
+std::size_t curve::Integrator::panels(double x1, double x2) const {
+	const double p = std::ceil(std::abs(x2 - x1) / (panel_u * std::abs(a)));
+	// NaN ends get a single panel and a NaN result
+	if (!(p >= 1)) return 1;
+	return p < max_panels ? static_cast<std::size_t>(p) : max_panels;
+}
+
+template <class Combine>
+void curve::Integrator::closed(const double* x1s, const double* x2s, std::size_t n, Combine combine) const {
+	double ch1[block], sh1[block], ch2[block], sh2[block];
+
+	for (std::size_t i = 0; i < n; i += block) {
+		const std::size_t m = std::min(block, n - i);
+		kernels::hyperbolic(a, x1s + i, ch1, sh1, m);
+		kernels::hyperbolic(a, x2s + i, ch2, sh2, m);
+		for (std::size_t j = 0; j < m; ++j) {
+			const end e1{ x1s[i + j], x1s[i + j] / a, ch1[j], sh1[j] },
+				e2{ x2s[i + j], x2s[i + j] / a, ch2[j], sh2[j] };
+			combine(e1, e2, i + j);
+		}
+	}
+}
+
+void curve::Integrator::y_dx(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	kernels::area(a, x1s, x2s, out, n);
+}
+
+void curve::Integrator::y2_dx(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	// a^2 int cosh^2 dx = a^2 / 2 (x + a sinh cosh)
+	const double a2 = a * a;
+	closed(x1s, x2s, n, [&](const end& e1, const end& e2, std::size_t i) {
+		out[i] = a2 / 2 * ((e2.x - e1.x) + a * (e2.sh * e2.ch - e1.sh * e1.ch));
+	});
+}
+
+void curve::Integrator::ds(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	closed(x1s, x2s, n, [&](const end& e1, const end& e2, std::size_t i) {
+		out[i] = a * (e2.sh - e1.sh);
+	});
+}
+
+void curve::Integrator::x_ds(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	const double a2 = a * a;
+	closed(x1s, x2s, n, [&](const end& e1, const end& e2, std::size_t i) {
+		out[i] = a2 * (first_moment(e2) - first_moment(e1));
+	});
+}
+
+void curve::Integrator::y_ds(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	// int a cosh^2 dx, y2_dx over a
+	closed(x1s, x2s, n, [&](const end& e1, const end& e2, std::size_t i) {
+		out[i] = a / 2 * ((e2.x - e1.x) + a * (e2.sh * e2.ch - e1.sh * e1.ch));
+	});
+}
+
+void curve::Integrator::x2_ds(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	const double a3 = a * a * a;
+	closed(x1s, x2s, n, [&](const end& e1, const end& e2, std::size_t i) {
+		out[i] = a3 * (second_moment(e2) - second_moment(e1));
+	});
+}
+
+void curve::Integrator::y2_ds(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	// a^3 int cosh^3 du = a^3 (sinh + sinh^3 / 3)
+	const double a3 = a * a * a;
+	closed(x1s, x2s, n, [&](const end& e1, const end& e2, std::size_t i) {
+		out[i] = a3 * ((e2.sh - e1.sh) + (e2.sh * e2.sh * e2.sh - e1.sh * e1.sh * e1.sh) / 3);
+	});
+}
+
+void curve::Integrator::centroid(const double* x1s, const double* x2s, double* xs, double* ys, std::size_t n) const {
+	closed(x1s, x2s, n, [&](const end& e1, const end& e2, std::size_t i) {
+		const double length = a * (e2.sh - e1.sh);
+		xs[i] = a * a * (first_moment(e2) - first_moment(e1)) / length;
+		ys[i] = a / 2 * ((e2.x - e1.x) + a * (e2.sh * e2.ch - e1.sh * e1.ch)) / length;
+	});
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+
+#include "hyperbolic.h"
+
+namespace curve {
+
+	// Integrals of one catenary over many intervals [x1s[i], x2s[i]], out[i]
+	// signed like the integral (negative for x2 < x1). With u = x / a the arc
+	// element is ds = cosh(u) dx for either sign of a, and every integral
+	// below has a closed form in cosh / sinh at the two ends, so those are
+	// one kernels::hyperbolic call per end and some arithmetic. integrate()
+	// takes any other integrand by composite Gauss-Legendre quadrature.
+	class Integrator {
+	public:
+		// Gauss-Legendre points per panel, and the widest panel in u; eight
+		// points integrate e^(3u), cosh^3 as in y2_ds, over a panel to about 1e-15
+		static constexpr std::size_t order = 8;
+		static constexpr double panel_u = 1;
+
+		// the values integrate() hands the integrand at its nodes
+		struct nodes {
+			const double* x;
+			const double* y;	// a cosh(u)
+			const double* dy;	// sinh(u), the slope
+			const double* ds;	// cosh(u), ds / dx
+			std::size_t n;
+		};
+
+		// throws std::invalid_argument if a is zero or not finite
+		explicit Integrator(double a);
+
+		double get_a() const { return a; }
+
+		// int y dx, the same as Catenary::S
+		void y_dx(const double* x1s, const double* x2s, double* out, std::size_t n) const;
+		// int y^2 dx
+		void y2_dx(const double* x1s, const double* x2s, double* out, std::size_t n) const;
+		// int ds, the arc length
+		void ds(const double* x1s, const double* x2s, double* out, std::size_t n) const;
+		// int x ds and int y ds, the first moments of the arc
+		void x_ds(const double* x1s, const double* x2s, double* out, std::size_t n) const;
+		void y_ds(const double* x1s, const double* x2s, double* out, std::size_t n) const;
+		// int x^2 ds and int y^2 ds, the moments of inertia of the arc about
+		// the y and the x axis
+		void x2_ds(const double* x1s, const double* x2s, double* out, std::size_t n) const;
+		void y2_ds(const double* x1s, const double* x2s, double* out, std::size_t n) const;
+		// the centroid of each arc, (int x ds, int y ds) / int ds
+		void centroid(const double* x1s, const double* x2s, double* xs, double* ys, std::size_t n) const;
+
+		// int f ds over each interval, f given at the quadrature nodes as
+		//   void f(const Integrator::nodes& at, double* values)
+		// writing values[j] for the node j < at.n. Intervals are split into
+		// panels no wider than panel_u * |a|, the nodes of many intervals go to
+		// f at once; dividing by at.ds turns it into an integral over dx.
+		template <class F>
+		void integrate(const double* x1s, const double* x2s, double* out, std::size_t n, F f) const;
+
+	private:
+		// the node buffer integrate() fills before each call of f
+		static constexpr std::size_t capacity = 64 * order;
+		// enough panels to cross the whole range where cosh(u) is finite
+		static constexpr std::size_t max_panels = 1024;
+		// nodes and weights of the rule on [-1, 1], the positive half
+		static const double legendre_nodes[order / 2];
+		static const double legendre_weights[order / 2];
+
+		// panels of [x1, x2], at least one and at most max_panels
+		std::size_t panels(double x1, double x2) const;
+		// combine(end1, end2, i) for every interval, cosh and sinh of both
+		// ends evaluated a block at a time
+		template <class Combine>
+		void closed(const double* x1s, const double* x2s, std::size_t n, Combine combine) const;
+
+		double a;
+	};
+
+	template <class F>
+	void Integrator::integrate(const double* x1s, const double* x2s, double* out, std::size_t n, F f) const {
+		double xs[capacity], ch[capacity], sh[capacity], ys[capacity], values[capacity], weights[capacity];
+		std::size_t owner[capacity];
+		std::size_t used = 0;
+
+		const auto flush = [&] {
+			kernels::hyperbolic(a, xs, ch, sh, used);
+			for (std::size_t k = 0; k < used; ++k) ys[k] = a * ch[k];
+			f(nodes{ xs, ys, sh, ch, used }, values);
+			for (std::size_t k = 0; k < used; ++k) out[owner[k]] += weights[k] * values[k] * ch[k];
+			used = 0;
+		};
+
+		for (std::size_t i = 0; i < n; ++i) {
+			out[i] = 0;
+			const std::size_t p = panels(x1s[i], x2s[i]);
+			const double h = (x2s[i] - x1s[i]) / static_cast<double>(p);
+
+			for (std::size_t k = 0; k < p; ++k) {
+				if (used + order > capacity) flush();
+				const double mid = x1s[i] + (static_cast<double>(k) + 0.5) * h, half = h / 2;
+				for (std::size_t j = 0; j < order / 2; ++j) {
+					const double d = half * legendre_nodes[j], w = half * legendre_weights[j];
+					xs[used] = mid - d;
+					xs[used + 1] = mid + d;
+					weights[used] = weights[used + 1] = w;
+					owner[used] = owner[used + 1] = i;
+					used += 2;
+				}
+			}
+		}
+		if (used) flush();
+	}
+
+}
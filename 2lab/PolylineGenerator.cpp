@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "PolylineGenerator.h"
+#include "Catenary.h"
+#include "UniformSweep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+	// more segments than this do not fit any buffer
+	constexpr double max_segments = 1e15;
+
+}
+
+curve::PolylineGenerator::PolylineGenerator(double tolerance, unsigned threads)
+	: tolerance(tolerance), pool(threads)
+{
+	if (!(tolerance > 0) || !std::isfinite(tolerance)) {
+		throw std::invalid_argument("wrong value for 'tolerance'");
+	}
+}
+
+double curve::PolylineGenerator::step(double a) const {
+	if (a == 0 || !std::isfinite(a)) {
+		throw std::invalid_argument("wrong value for 'a'");
+	}
+
+	// the chord that strays tolerance from a circle of radius |a|, no point
+	// of the catenary curving more; from |a| on it is the flanks that stray
+	// the most, and 2 |a| ln(1 + tolerance / |a|) keeps them within tolerance
+	const double r = std::abs(a);
+	if (tolerance < r) return 2 * std::sqrt(tolerance * (2 * r - tolerance));
+	return 2 * r * std::log1p(tolerance / r);
+}
+
+std::size_t curve::PolylineGenerator::count(double a, double x1, double x2) const {
+	const double h = step(a);
+	if (!std::isfinite(x1) || !std::isfinite(x2)) {
+		throw std::invalid_argument("wrong value for 'x'");
+	}
+
+	const double segments = std::ceil(std::abs(x2 - x1) / h);
+	if (!(segments < max_segments)) {
+		throw std::invalid_argument("too many vertices");
+	}
+	return std::max<std::size_t>(1, static_cast<std::size_t>(segments)) + 1;
+}
+
+std::size_t curve::PolylineGenerator::generate(double a, double x1, double x2, coord_view out, double* s) const {
+	const std::size_t n = count(a, x1, x2);
+	if (out.size < n) {
+		throw std::invalid_argument("polyline buffer too small");
+	}
+	fill(a, x1, x2, n, out.xs, out.ys, s);
+	return n;
+}
+
+void curve::PolylineGenerator::fill(double a, double x1, double x2, std::size_t n, double* xs, double* ys, double* s) const {
+	const UniformSweep sweep(a, x1, (x2 - x1) / static_cast<double>(n - 1), n);
+	sweep.evaluate(ys, s);
+	for (std::size_t i = 0; i < n; ++i) xs[i] = sweep.x(i);
+
+	// the ends exactly, whatever x1 + (n - 1) h rounds to
+	const Catenary c(a);
+	const double l1 = c.l(x1);
+	xs[n - 1] = x2;
+	ys[n - 1] = c.y(x2);
+	s[n - 1] = c.l(x2);
+
+	// l grows with x for either sign of a
+	for (std::size_t i = 0; i < n; ++i) s[i] = std::abs(s[i] - l1);
+}
+
+std::size_t curve::PolylineGenerator::offsets(const span* spans, std::size_t n, std::size_t* first) const {
+	first[0] = 0;
+	for (std::size_t i = 0; i < n; ++i)
+		first[i + 1] = first[i] + count(spans[i].a, spans[i].x1, spans[i].x2);
+	return first[n];
+}
+
+void curve::PolylineGenerator::run(const span* spans, std::size_t n, const std::size_t* first, coord_view out, double* s) {
+	if (out.size < first[n]) {
+		throw std::invalid_argument("polyline buffer too small");
+	}
+
+	pool.parallel_for(n, [=](std::size_t i) {
+		const std::size_t k = first[i];
+		fill(spans[i].a, spans[i].x1, spans[i].x2, first[i + 1] - k, out.xs + k, out.ys + k, s + k);
+	});
+}
+
+void curve::PolylineGenerator::run_serial(const span* spans, std::size_t n, const std::size_t* first, coord_view out, double* s) const {
+	if (out.size < first[n]) {
+		throw std::invalid_argument("polyline buffer too small");
+	}
+
+	for (std::size_t i = 0; i < n; ++i) {
+		const std::size_t k = first[i];
+		fill(spans[i].a, spans[i].x1, spans[i].x2, first[i + 1] - k, out.xs + k, out.ys + k, s + k);
+	}
+}
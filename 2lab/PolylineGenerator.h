@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+
+#include "CoordBuffer.h"
+#include "ThreadPool.h"
+
+namespace curve {
+
+	// Catenaries cut into polylines whose chords stray from the curve by at
+	// most tolerance, the vertices carrying their arc length s from the first
+	// one. A chord c across an arc of radius R strays about c^2 / 8R from it,
+	// so the vertices thin out along the arc as the square root of R(x).
+	// With R = a cosh^2(u) and ds / dx = cosh(u) that is one step in x over
+	// the whole curve, the chord of the osculating circle at the vertex,
+	// where R is smallest: far fewer vertices than an even step in arc
+	// length, and swept by UniformSweep with no transcendental per vertex.
+	class PolylineGenerator {
+	public:
+		// one curve, from x1 to x2 (either way)
+		struct span {
+			double a, x1, x2;
+		};
+
+		// throws std::invalid_argument if tolerance is not positive and finite
+		explicit PolylineGenerator(double tolerance, unsigned threads = std::thread::hardware_concurrency());
+
+		double get_tolerance() const { return tolerance; }
+
+		// the step in x for the curve a; throws std::invalid_argument if a is
+		// zero or not finite
+		double step(double a) const;
+		// vertices of the polyline over [x1, x2], both ends included, at
+		// least 2; throws std::invalid_argument if an end is not finite
+		std::size_t count(double a, double x1, double x2) const;
+
+		// writes the count(a, x1, x2) vertices to out and their arc lengths
+		// to s, and returns how many; throws std::invalid_argument if
+		// out.size is less
+		std::size_t generate(double a, double x1, double x2, coord_view out, double* s) const;
+
+		// first[i] = where the vertices of spans[i] start, for i <= n, so
+		// first[n] is the size of the buffer run needs
+		std::size_t offsets(const span* spans, std::size_t n, std::size_t* first) const;
+		// every curve at once, spans[i] to [first[i], first[i + 1]) of out
+		// and s; run spreads the curves over the pool, with the same output
+		// as run_serial
+		void run(const span* spans, std::size_t n, const std::size_t* first, coord_view out, double* s);
+		void run_serial(const span* spans, std::size_t n, const std::size_t* first, coord_view out, double* s) const;
+
+		unsigned threads() const { return pool.size(); }
+
+	private:
+		void fill(double a, double x1, double x2, std::size_t n, double* xs, double* ys, double* s) const;
+
+		double tolerance;
+		ThreadPool pool;
+	};
+
+}
@@ -0,0 +1,227 @@
+#include "pch.h"
+#include "QueryCache.h"
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+	std::uint64_t bits(double v) {
+		std::uint64_t b;
+		std::memcpy(&b, &v, sizeof(b));
+		return b;
+	}
+
+	// splitmix64 finalizer
+	std::uint64_t mix(std::uint64_t z) {
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	}
+
+}
+
+curve::QueryCache::QueryCache(std::size_t capacity, unsigned shard_hint)
+	: shard_count(1), tally_count(1)
+{
+	if (capacity == 0) {
+		throw std::invalid_argument("empty query cache");
+	}
+
+	// a power of two, so a shard is picked by masking the hash
+	while (shard_count < shard_hint && shard_count < capacity) shard_count *= 2;
+	const std::size_t per_shard = (capacity + shard_count - 1) / shard_count;
+	sets_per_shard = (per_shard + ways - 1) / ways;
+	shards.reset(new shard[shard_count]);
+
+	for (unsigned i = 0; i < shard_count; ++i) {
+		shard& s = shards[i];
+		s.sets.reset(new set[sets_per_shard]);
+		s.slots.reset(new entry[sets_per_shard * ways]);
+		s.hands.reset(new std::uint8_t[sets_per_shard]());
+		for (std::size_t j = 0; j < sets_per_shard; ++j)
+			for (auto& t : s.sets[j].tags) t.store(0, std::memory_order_relaxed);
+	}
+
+	// one counter line per thread, more threads than that share
+	while (tally_count < std::thread::hardware_concurrency() && tally_count < 256) tally_count *= 2;
+	tallies.reset(new tally[tally_count]);
+}
+
+curve::QueryCache::key curve::QueryCache::make_key(double a, query q, double x, double x2) {
+	return key{ bits(a), bits(x), q == query::area ? bits(x2) : 0, static_cast<std::int32_t>(q) };
+}
+
+std::uint64_t curve::QueryCache::hash(const key& k) {
+	return mix(k.a ^ mix(k.x ^ mix(k.x2 ^ static_cast<std::uint64_t>(k.q))));
+}
+
+curve::QueryCache::place curve::QueryCache::locate(const key& k) const {
+	const std::uint64_t h = hash(k);
+	const std::uint32_t high = static_cast<std::uint32_t>(h >> 32);
+	// the shard from the low bits of the high word, the set by scaling all
+	// of it, the tag from the low word
+	return place{ &shards[high & (shard_count - 1)],
+		static_cast<std::size_t>(std::uint64_t(high) * sets_per_shard >> 32),
+		static_cast<std::uint32_t>(h) | 1 };
+}
+
+curve::QueryCache::tally& curve::QueryCache::own_tally() const {
+	static std::atomic<unsigned> next_thread{ 0 };
+	thread_local const unsigned thread = next_thread.fetch_add(1, std::memory_order_relaxed);
+	return tallies[thread & (tally_count - 1)];
+}
+
+bool curve::QueryCache::entry::holds(const key& k) const {
+	return a.load(std::memory_order_relaxed) == k.a && x.load(std::memory_order_relaxed) == k.x
+		&& x2.load(std::memory_order_relaxed) == k.x2 && q.load(std::memory_order_relaxed) == k.q;
+}
+
+void curve::QueryCache::write(entry& e, const key& k, const value& v) {
+	const std::uint32_t s = e.seq.load(std::memory_order_relaxed);
+	e.seq.store(s + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	e.a.store(k.a, std::memory_order_relaxed);
+	e.x.store(k.x, std::memory_order_relaxed);
+	e.x2.store(k.x2, std::memory_order_relaxed);
+	e.q.store(k.q, std::memory_order_relaxed);
+	for (std::size_t i = 0; i < 4; ++i) e.v[i].store(v[i], std::memory_order_relaxed);
+	e.seq.store(s + 2, std::memory_order_release);
+}
+
+bool curve::QueryCache::find(double a, query q, double x, double x2, value& out) const {
+	const key k = make_key(a, q, x, x2);
+	const place p = locate(k);
+	const set& ways_of = p.s->sets[p.set];
+	entry* const base = &p.s->slots[p.set * ways];
+
+	for (std::size_t w = 0; w < ways; ++w) {
+		if (ways_of.tags[w].load(std::memory_order_relaxed) != p.tag) continue;
+		entry& e = base[w];
+		const std::uint32_t before = e.seq.load(std::memory_order_acquire);
+		// a writer mid-update, or another key: a stale or torn copy is never used
+		if (before & 1 || !e.holds(k)) continue;
+		value v;
+		for (std::size_t i = 0; i < 4; ++i) v[i] = e.v[i].load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (e.seq.load(std::memory_order_relaxed) != before) continue;
+
+		out = v;
+		// skip the store when already marked, it would only bounce the line
+		if (!e.referenced.load(std::memory_order_relaxed))
+			e.referenced.store(true, std::memory_order_relaxed);
+		own_tally().hits.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+	own_tally().misses.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+void curve::QueryCache::insert(double a, query q, double x, double x2, const value& v) {
+	const key k = make_key(a, q, x, x2);
+	const place p = locate(k);
+	shard& s = *p.s;
+	set& ways_of = s.sets[p.set];
+	entry* const base = &s.slots[p.set * ways];
+	std::lock_guard<std::mutex> lock(s.m);
+
+	// another thread may have computed it meanwhile
+	std::size_t empty = ways;
+	for (std::size_t w = 0; w < ways; ++w) {
+		const std::uint32_t tag = ways_of.tags[w].load(std::memory_order_relaxed);
+		if (tag == p.tag && base[w].holds(k)) return;
+		if (tag == 0 && empty == ways) empty = w;
+	}
+
+	std::size_t slot = empty;
+	if (slot == ways) {
+		std::uint8_t& hand = s.hands[p.set];
+		for (;;) {
+			const std::size_t w = hand;
+			hand = static_cast<std::uint8_t>((hand + 1) % ways);
+			if (!base[w].referenced.exchange(false, std::memory_order_relaxed)) {
+				slot = w;
+				break;
+			}
+		}
+	}
+	else ++s.used;
+
+	entry& e = base[slot];
+	write(e, k, v);
+	// a new entry survives one pass of the hand
+	e.referenced.store(true, std::memory_order_relaxed);
+	ways_of.tags[slot].store(p.tag, std::memory_order_release);
+}
+
+void curve::QueryCache::invalidate(double a) {
+	const std::uint64_t b = bits(a);
+
+	// a reader that matched a tag just before it is cleared may still hit the
+	// old entry, whose value is still right for its key
+	for (unsigned i = 0; i < shard_count; ++i) {
+		shard& s = shards[i];
+		std::lock_guard<std::mutex> lock(s.m);
+		for (std::size_t j = 0; j < sets_per_shard * ways; ++j) {
+			std::atomic<std::uint32_t>& tag = s.sets[j / ways].tags[j % ways];
+			if (tag.load(std::memory_order_relaxed) != 0 && s.slots[j].a.load(std::memory_order_relaxed) == b) {
+				tag.store(0, std::memory_order_relaxed);
+				--s.used;
+			}
+		}
+	}
+}
+
+void curve::QueryCache::clear() {
+	for (unsigned i = 0; i < shard_count; ++i) {
+		shard& s = shards[i];
+		std::lock_guard<std::mutex> lock(s.m);
+		for (std::size_t j = 0; j < sets_per_shard; ++j)
+			for (auto& t : s.sets[j].tags) t.store(0, std::memory_order_relaxed);
+		s.used = 0;
+	}
+}
+
+curve::QueryCache::stats curve::QueryCache::counters() const {
+	stats total{};
+	for (unsigned i = 0; i < tally_count; ++i) {
+		total.hits += tallies[i].hits.load(std::memory_order_relaxed);
+		total.misses += tallies[i].misses.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+std::size_t curve::QueryCache::size() const {
+	std::size_t n = 0;
+	for (unsigned i = 0; i < shard_count; ++i) {
+		std::lock_guard<std::mutex> lock(shards[i].m);
+		n += shards[i].used;
+	}
+	return n;
+}
+
+double curve::CachedCatenary::y(double x) const {
+	return cache->get(c.get_a(), query::ordinate, x, 0, [&] { return QueryCache::value{ c.y(x) }; })[0];
+}
+
+double curve::CachedCatenary::l(double x) const {
+	return cache->get(c.get_a(), query::arc_length, x, 0, [&] { return QueryCache::value{ c.l(x) }; })[0];
+}
+
+double curve::CachedCatenary::R(double x) const {
+	return cache->get(c.get_a(), query::curvature_radius, x, 0, [&] { return QueryCache::value{ c.R(x) }; })[0];
+}
+
+double curve::CachedCatenary::S(double x1, double x2) const {
+	return cache->get(c.get_a(), query::area, x1, x2, [&] { return QueryCache::value{ c.S(x1, x2) }; })[0];
+}
+
+curve::coords_pair curve::CachedCatenary::CurvatureCenterCoords(double x) const {
+	const QueryCache::value v = cache->get(c.get_a(), query::curvature_centers, x, 0, [&] {
+		const coords_pair centers(c.CurvatureCenterCoords(x));
+		return QueryCache::value{ centers.first.first, centers.first.second, centers.second.first, centers.second.second };
+	});
+	return std::make_pair(std::make_pair(v[0], v[1]), std::make_pair(v[2], v[3]));
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "Catenary.h"
+
+namespace curve {
+
+	enum class query : std::int32_t {
+		ordinate,			// y(x)
+		arc_length,			// l(x)
+		curvature_radius,	// R(x)
+		curvature_centers,	// CurvatureCenterCoords(x) as x1, y1, x2, y2
+		area				// S(x, x2)
+	};
+
+	// Memo of Catenary results keyed on the bits of (a, query, x, x2), for
+	// callers that see the same queries over and over. Keys are spread over
+	// shards by hash, and within a shard over sets of 16 entries whose tags
+	// share one cache line. Lookups take no lock: a reader matches the tags,
+	// then copies the entry between two reads of its sequence number and
+	// retries elsewhere if a writer bumped it meanwhile (a seqlock). Hits and
+	// misses are tallied per thread, so readers of one hot entry share no
+	// written line but its mark. Inserts lock their shard. Eviction is CLOCK
+	// within the set, the usual lock-light approximation of LRU: an insert
+	// into a full set sweeps the set's hand over its entries, clearing the
+	// marks, and replaces the first entry not hit since the hand last passed it.
+	class QueryCache {
+	public:
+		typedef std::array<double, 4> value;
+
+		struct stats {
+			std::uint64_t hits, misses;
+		};
+
+		// shard_hint is rounded up to a power of two (and capped at capacity),
+		// each shard's part of capacity up to whole sets
+		explicit QueryCache(std::size_t capacity = 1 << 16, unsigned shard_hint = 16);
+
+		QueryCache(const QueryCache&) = delete;
+		QueryCache& operator=(const QueryCache&) = delete;
+
+		// out = the cached result, false (and a counted miss) if there is none
+		bool find(double a, query q, double x, double x2, value& out) const;
+		void insert(double a, query q, double x, double x2, const value& v);
+		// the cached result, or compute() stored for the next time
+		template <class F>
+		value get(double a, query q, double x, double x2, F compute) {
+			value v;
+			if (!find(a, q, x, x2, v)) {
+				v = compute();
+				insert(a, q, x, x2, v);
+			}
+			return v;
+		}
+
+		// drops every entry of the curve with that a, for callers that know no
+		// one asks for it again; scans every shard under its exclusive lock,
+		// O(capacity), where leaving the entries to eviction costs nothing
+		void invalidate(double a);
+		void clear();
+
+		stats counters() const;
+		std::size_t size() const;
+		std::size_t capacity() const { return shard_count * sets_per_shard * ways; }
+
+	private:
+		static constexpr std::size_t ways = 16;
+
+		struct key {
+			std::uint64_t a, x, x2;
+			std::int32_t q;
+		};
+
+		// fields are atomics so that a reader racing a writer is a retry,
+		// not a data race; seq is odd while the writer is in the middle
+		struct entry {
+			std::atomic<std::uint32_t> seq{ 0 };
+			std::atomic<bool> referenced{ false };
+			std::atomic<std::int32_t> q{ 0 };
+			std::atomic<std::uint64_t> a{ 0 }, x{ 0 }, x2{ 0 };
+			std::atomic<double> v[4];
+
+			bool holds(const key& k) const;
+		};
+
+		// nonzero hash bits of each occupied way, 0 for an empty one
+		struct alignas(64) set {
+			std::atomic<std::uint32_t> tags[ways];
+		};
+
+		struct alignas(64) shard {
+			std::mutex m; // taken by writers only
+			std::unique_ptr<set[]> sets;
+			std::unique_ptr<entry[]> slots;
+			std::unique_ptr<std::uint8_t[]> hands;
+			std::size_t used = 0;
+		};
+
+		struct alignas(64) tally {
+			std::atomic<std::uint64_t> hits{ 0 }, misses{ 0 };
+		};
+
+		struct place {
+			shard* s;
+			std::size_t set;
+			std::uint32_t tag;
+		};
+
+		static key make_key(double a, query q, double x, double x2);
+		static std::uint64_t hash(const key& k);
+		place locate(const key& k) const;
+		// this thread's hit and miss counters
+		tally& own_tally() const;
+		static void write(entry& e, const key& k, const value& v);
+
+		unsigned shard_count;
+		std::size_t sets_per_shard;
+		std::unique_ptr<shard[]> shards;
+		unsigned tally_count;
+		std::unique_ptr<tally[]> tallies;
+	};
+
+	// Catenary answering through a shared QueryCache.
+	// Every instance with the same a shares the cached results. The key holds
+	// a, so set_a needs no invalidation: the old curve's entries stay for the
+	// other instances still on it, or until eviction reaches them.
+	class CachedCatenary {
+	public:
+		CachedCatenary(double a, QueryCache& cache) : c(a), cache(&cache) {}
+
+		void set_a(double ia) noexcept { c.set_a(ia); }
+		double get_a() const { return c.get_a(); }
+
+		double y(double x) const;
+		double l(double x) const;
+		double R(double x) const;
+		double S(double x1, double x2) const;
+		coords_pair CurvatureCenterCoords(double x) const;
+
+	private:
+		Catenary c;
+		QueryCache* cache;
+	};
+
+}
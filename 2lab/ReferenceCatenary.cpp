@@ -0,0 +1,259 @@
+#include "pch.h"
+#include "ReferenceCatenary.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+	// the unevaluated sum hi + lo, |lo| at most half an ulp of hi
+	struct dd {
+		double hi, lo;
+	};
+
+	dd two_sum(double a, double b) {
+		const double s = a + b, v = s - a;
+		return dd{ s, (a - (s - v)) + (b - v) };
+	}
+
+	// |a| >= |b|
+	dd quick_two_sum(double a, double b) {
+		const double s = a + b;
+		return dd{ s, b - (s - a) };
+	}
+
+	dd two_prod(double a, double b) {
+		const double p = a * b;
+		return dd{ p, std::fma(a, b, -p) };
+	}
+
+	dd operator+(dd a, dd b) {
+		dd s = two_sum(a.hi, b.hi);
+		const dd t = two_sum(a.lo, b.lo);
+		s.lo += t.hi;
+		s = quick_two_sum(s.hi, s.lo);
+		s.lo += t.lo;
+		return quick_two_sum(s.hi, s.lo);
+	}
+
+	dd operator-(dd a) {
+		return dd{ -a.hi, -a.lo };
+	}
+
+	dd operator-(dd a, dd b) {
+		return a + -b;
+	}
+
+	dd operator*(dd a, dd b) {
+		dd p = two_prod(a.hi, b.hi);
+		p.lo += a.hi * b.lo + a.lo * b.hi;
+		return quick_two_sum(p.hi, p.lo);
+	}
+
+	dd operator*(dd a, double b) {
+		dd p = two_prod(a.hi, b);
+		p.lo += a.lo * b;
+		return quick_two_sum(p.hi, p.lo);
+	}
+
+	dd operator/(dd a, dd b) {
+		const double q1 = a.hi / b.hi;
+		dd r = a - b * q1;
+		const double q2 = r.hi / b.hi;
+		r = r - b * q2;
+		const double q3 = r.hi / b.hi;
+		return quick_two_sum(q1, q2) + dd{ q3, 0 };
+	}
+
+	// exponents past this are an overflow (underflow) for any mantissa here
+	constexpr long long exponent_limit = 1 << 20;
+
+	int clamped(long long e) {
+		return static_cast<int>(std::max(-exponent_limit, std::min(e, exponent_limit)));
+	}
+
+	dd ldexp(dd a, long long e) {
+		return dd{ std::ldexp(a.hi, clamped(e)), std::ldexp(a.lo, clamped(e)) };
+	}
+
+	// m * 2^e rounded to double, once unless the result is subnormal
+	double finish(dd m, long long e) {
+		return std::ldexp(m.hi + m.lo, clamped(e));
+	}
+
+	const dd one{ 1, 0 }, two{ 2, 0 };
+	const dd ln2{ 6.931471805599452862e-01, 2.319046813846299558e-17 };
+
+	// past this |x / a| every result is infinite, or NaN for infinity minus
+	// infinity, and plain double arithmetic gives it
+	constexpr double u_far = 1e9;
+	// past this |u| e^-|u| is below 2^-115 of e^|u| and cosh, sinh are e^|u| / 2
+	constexpr double u_large = 40;
+
+	// e^r - 1, |r| < 1: the Taylor series at r / 2^10, then ten doublings
+	// e^2t - 1 = (e^t - 1)(e^t - 1 + 2), which keep the relative accuracy near 0
+	dd expm1_reduced(dd r) {
+		const dd t = ldexp(r, -10);
+		dd term = t, sum = t;
+		for (int n = 2; n <= 10; ++n) {
+			term = term * t / dd{ static_cast<double>(n), 0 };
+			sum = sum + term;
+		}
+		for (int i = 0; i < 10; ++i) sum = sum * (sum + two);
+		return sum;
+	}
+
+	// cosh(u) = ch * 2^e and sinh(u) = sh * 2^e; far if |u| > u_far, with
+	// only the double u then
+	struct hyper {
+		dd ch, sh;
+		long long e;
+		bool far;
+		double u;
+	};
+
+	hyper hyperbolic(double x, double a) {
+		hyper h{};
+		h.u = x / a;
+		h.far = !(std::abs(h.u) <= u_far);
+		if (h.far) return h;
+
+		dd u = dd{ x, 0 } / dd{ a, 0 };
+		const bool negative = u.hi < 0;
+		if (negative) u = -u;
+
+		if (u.hi < 1) {
+			// near 0 from e^u - 1 so that sinh keeps its relative accuracy
+			const dd s = expm1_reduced(u), E = s + one, twice_E = E * 2.0;
+			h.sh = s * (s + two) / twice_E;
+			h.ch = (E * E + one) / twice_E;
+		}
+		else {
+			// e^u = (1 + expm1(r)) * 2^k, r = u - k ln2
+			const double k = std::nearbyint(u.hi / ln2.hi);
+			const dd E = expm1_reduced(u - ln2 * dd{ k, 0 }) + one;
+			if (u.hi <= u_large) {
+				const dd full = ldexp(E, static_cast<long long>(k)), inverse = one / full;
+				h.ch = (full + inverse) * 0.5;
+				h.sh = (full - inverse) * 0.5;
+			}
+			else {
+				h.ch = h.sh = E * 0.5;
+				h.e = static_cast<long long>(k);
+			}
+		}
+
+		if (negative) h.sh = -h.sh;
+		return h;
+	}
+
+	// below this |u| one center is taken from a series: x - a sinh(u) cosh(u)
+	// is some u^2 smaller than x
+	constexpr double u_series = 0.5;
+
+	// P with sinh(u) cosh(u) - u = sinh(2u) / 2 - u = u^3 P(u^2), |u| <
+	// u_series: the sum of 2^2k (u^2)^(k-1) / (2k+1)! from k = 1, 16 terms
+	// past 2^-106 of the first
+	dd excess_series(dd u2) {
+		const dd four_u2 = u2 * 4.0;
+		dd term = dd{ 4, 0 } / dd{ 6, 0 }, sum = term;
+		for (int k = 2; k <= 16; ++k) {
+			term = term * four_u2 / dd{ static_cast<double>(2 * k * (2 * k + 1)), 0 };
+			sum = sum + term;
+		}
+		return sum;
+	}
+
+	// a = fraction * 2^exponent, so products with a stay in range until finish
+	struct split {
+		double fraction;
+		long long exponent;
+	};
+
+	split split_of(double a) {
+		int e;
+		const double f = std::frexp(a, &e);
+		return split{ f, e };
+	}
+
+	// x + m * 2^e with one rounding
+	double plus(double x, dd m, long long e) {
+		const long long c = x == 0 ? e : std::max<long long>(e, std::ilogb(x));
+		return finish(dd{ std::ldexp(x, clamped(-c)), 0 } + ldexp(m, e - c), c);
+	}
+
+}
+
+curve::ReferenceCatenary::ReferenceCatenary(double a) : a(a) {
+	if (a == 0 || !std::isfinite(a)) {
+		throw std::invalid_argument("wrong value for 'a'");
+	}
+}
+
+double curve::ReferenceCatenary::y(double x) const {
+	const hyper h = hyperbolic(x, a);
+	if (h.far) return a * std::cosh(h.u);
+	const split s = split_of(a);
+	return finish(h.ch * s.fraction, h.e + s.exponent);
+}
+
+double curve::ReferenceCatenary::l(double x) const {
+	const hyper h = hyperbolic(x, a);
+	if (h.far) return a * std::sinh(h.u);
+	const split s = split_of(a);
+	return finish(h.sh * s.fraction, h.e + s.exponent);
+}
+
+double curve::ReferenceCatenary::R(double x) const {
+	const hyper h = hyperbolic(x, a);
+	if (h.far) return a * std::cosh(h.u) * std::cosh(h.u);
+	const split s = split_of(a);
+	return finish(h.ch * h.ch * s.fraction, 2 * h.e + s.exponent);
+}
+
+double curve::ReferenceCatenary::S(double x1, double x2) const {
+	if (x1 == x2) return 0;
+
+	const hyper h1 = hyperbolic(x1, a), h2 = hyperbolic(x2, a);
+	if (h1.far || h2.far) {
+		const double s1 = std::sinh(h1.u), s2 = std::sinh(h2.u);
+		// both ends out on the same side: sinh grows with u, a^2 > 0
+		if (std::isinf(s1) && s1 == s2) return std::copysign(std::numeric_limits<double>::infinity(), h2.u - h1.u);
+		return a * (a * (s2 - s1));
+	}
+
+	const long long c = std::max(h1.e, h2.e);
+	const dd difference = ldexp(h2.sh, h2.e - c) - ldexp(h1.sh, h1.e - c);
+	const split s = split_of(a);
+	return finish(difference * s.fraction * s.fraction, c + 2 * s.exponent);
+}
+
+curve::coords_pair curve::ReferenceCatenary::CurvatureCenterCoords(double x) const {
+	const hyper h = hyperbolic(x, a);
+
+	// y -+ |a| cosh with y = a cosh: one of the two is 0, the other 2y
+	if (h.far) {
+		const double ch = std::cosh(h.u), shift = std::abs(a) * std::sinh(h.u) * ch;
+		return coords_pair(coord(x + shift, a > 0 ? 0 : 2 * a * ch), coord(x - shift, a > 0 ? 2 * a * ch : 0));
+	}
+
+	const split s = split_of(a);
+	const dd shift = h.sh * h.ch * std::abs(s.fraction);
+	const long long e = 2 * h.e + s.exponent;
+	const double twice_y = finish(h.ch * s.fraction, h.e + s.exponent + 1);
+	double first = plus(x, shift, e), second = plus(x, -shift, e);
+
+	// x - a sinh(u) cosh(u) = -x u^2 P(u^2) cancels near the vertex beyond
+	// what double-double carries; it is the second center for a > 0 and the
+	// first for a < 0. u = mu * 2^eu keeps u^2 clear of underflow.
+	if (std::abs(h.u) < u_series && x != 0) {
+		const split sx = split_of(x);
+		const long long eu = sx.exponent - s.exponent;
+		const dd mu = dd{ sx.fraction, 0 } / dd{ s.fraction, 0 }, mu2 = mu * mu;
+		const double vertex = finish(-(mu2 * excess_series(ldexp(mu2, 2 * eu)) * sx.fraction), sx.exponent + 2 * eu);
+		(a > 0 ? second : first) = vertex;
+	}
+	return coords_pair(coord(first, a > 0 ? 0 : twice_y), coord(second, a > 0 ? twice_y : 0));
+}
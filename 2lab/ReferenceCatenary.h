@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Catenary.h"
+
+namespace curve {
+
+	// Catenary evaluated in double-double arithmetic (about 106 bits) and
+	// rounded once at the end: the results are correctly rounded unless the
+	// exact value lies within some 2^-100 ulp of a tie. x / a is carried to
+	// double-double precision, and results are kept as a mantissa and a
+	// separate power of two until the end, so they overflow (or underflow) only where the exact value
+	// does: a cosh(x / a) with a = 1e-300 is finite well past |x / a| = 710.
+	// About a hundred times slower than Catenary; it is the ground truth for the
+	// tests and for Verifier, not for serving queries.
+	class ReferenceCatenary {
+	public:
+		// throws std::invalid_argument if a is zero or not finite
+		explicit ReferenceCatenary(double a);
+
+		double get_a() const { return a; }
+
+		double y(double x) const;
+		double l(double x) const;
+		double R(double x) const;
+		double S(double x1, double x2) const;
+		coords_pair CurvatureCenterCoords(double x) const;
+
+	private:
+		double a;
+	};
+
+}
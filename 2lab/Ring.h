@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace curve {
+
+	// capacities are rounded up to a power of two, so a position maps to
+	// its slot by masking
+	inline std::size_t ring_capacity(std::size_t n) {
+		std::size_t c = 2;
+		while (c < n) c *= 2;
+		return c;
+	}
+
+	// Bounded lock-free queue for one producer thread and one consumer thread.
+	// Each side owns its index and keeps a stale copy of the other's, so the
+	// shared line is read only when the copy says the ring looks full (empty).
+	template <class T>
+	class SpscRing {
+	public:
+		explicit SpscRing(std::size_t capacity)
+			: mask(ring_capacity(capacity) - 1), slots(new T[mask + 1]) {}
+
+		SpscRing(const SpscRing&) = delete;
+		SpscRing& operator=(const SpscRing&) = delete;
+
+		// false if full
+		bool try_push(T v) {
+			const std::size_t t = tail.load(std::memory_order_relaxed);
+			if (t - head_seen > mask) {
+				head_seen = head.load(std::memory_order_acquire);
+				if (t - head_seen > mask) return false;
+			}
+			slots[t & mask] = std::move(v);
+			tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+
+		// false if empty
+		bool try_pop(T& v) {
+			const std::size_t h = head.load(std::memory_order_relaxed);
+			if (h == tail_seen) {
+				tail_seen = tail.load(std::memory_order_acquire);
+				if (h == tail_seen) return false;
+			}
+			v = std::move(slots[h & mask]);
+			head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+
+		std::size_t capacity() const { return mask + 1; }
+
+	private:
+		const std::size_t mask;
+		const std::unique_ptr<T[]> slots;
+
+		// consumer side
+		alignas(64) std::atomic<std::size_t> head{ 0 };
+		std::size_t tail_seen = 0;
+		// producer side
+		alignas(64) std::atomic<std::size_t> tail{ 0 };
+		std::size_t head_seen = 0;
+	};
+
+	// Bounded lock-free queue for any number of producers and consumers
+	// (Vyukov's): every slot carries a sequence number telling whether it is
+	// free for the lap a producer is on or filled for the lap a consumer is on,
+	// so a push or pop is one compare-exchange on the shared position.
+	template <class T>
+	class MpmcRing {
+	public:
+		explicit MpmcRing(std::size_t capacity)
+			: mask(ring_capacity(capacity) - 1), slots(new slot[mask + 1])
+		{
+			for (std::size_t i = 0; i <= mask; ++i)
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		MpmcRing(const MpmcRing&) = delete;
+		MpmcRing& operator=(const MpmcRing&) = delete;
+
+		// false if full
+		bool try_push(T v) {
+			std::size_t pos = tail.load(std::memory_order_relaxed);
+			for (;;) {
+				slot& s = slots[pos & mask];
+				const std::size_t seq = s.sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(seq - pos);
+				if (lag == 0) {
+					if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						s.value = std::move(v);
+						s.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (lag < 0) return false;
+				else pos = tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		// false if empty
+		bool try_pop(T& v) {
+			std::size_t pos = head.load(std::memory_order_relaxed);
+			for (;;) {
+				slot& s = slots[pos & mask];
+				const std::size_t seq = s.sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+				if (lag == 0) {
+					if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						v = std::move(s.value);
+						// free for the producers' next lap
+						s.sequence.store(pos + mask + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (lag < 0) return false;
+				else pos = head.load(std::memory_order_relaxed);
+			}
+		}
+
+		std::size_t capacity() const { return mask + 1; }
+
+	private:
+		struct alignas(64) slot {
+			std::atomic<std::size_t> sequence;
+			T value;
+		};
+
+		const std::size_t mask;
+		const std::unique_ptr<slot[]> slots;
+
+		alignas(64) std::atomic<std::size_t> head{ 0 };
+		alignas(64) std::atomic<std::size_t> tail{ 0 };
+	};
+
+}
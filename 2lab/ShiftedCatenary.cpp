@@ -0,0 +1,238 @@
+#include "pch.h"
+#include "ShiftedCatenary.h"
+#include "hyperbolic.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+	// abscissae per kernel call, staged on the stack
+	constexpr std::size_t block = 256;
+	// Newton steps take a handful, bisection down to an ulp of t about 60
+	constexpr int max_iterations = 128;
+
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+
+	// Both fits come down to one equation g(t) = 0 in t = h / 2a, h the
+	// horizontal and v the vertical distance between the supports, with
+	// cosh(t / 2) and sinh(t / 2) at hand; p and q are its two parameters.
+
+	// the length L > sqrt(h^2 + v^2): 2 a sinh(h / 2a) = sqrt(L^2 - v^2), so
+	// g = sinh t / t - k with k = sqrt(L^2 - v^2) / h; both sides are held
+	// less 1, which is all there is to them when L is close to the chord
+	struct by_length {
+		// false if there is no curve; start is right of the root
+		static bool setup(double h, double v, double length, double& p, double& q, double& start) {
+			// k - 1 = (L^2 - v^2 - h^2) / (h (sqrt(L^2 - v^2) + h)), L^2 - v^2 - h^2 = (L - chord) (L + chord)
+			const double chord = std::hypot(h, v), rise = std::sqrt((length - std::abs(v)) * (length + std::abs(v)));
+			p = (length - chord) * (length + chord) / (h * (rise + h));
+			q = 0;
+			// sinh t / t exceeds 1 + t^2 / 6, and e^t / 4t from t = 1 on; t >
+			// asinh(k t) right of the root, so that bound only comes closer
+			start = std::min(std::sqrt(6 * p), 2 * std::log(4 * (p + 1)));
+			for (int i = 0; i < 2 && start > 1; ++i) start = std::asinh((p + 1) * start);
+			return p > 0 && std::isfinite(p);
+		}
+
+		static void equation(double p, double, double t, double c, double s, double& g, double& dg) {
+			// sinh t / t - 1 and its derivative (cosh t - sinh t / t) / t, by
+			// their series below 1 / 2
+			const double t2 = t * t;
+			if (t < 0.5) {
+				g = t2 / 6 * (1 + t2 / 20 * (1 + t2 / 42 * (1 + t2 / 72 * (1 + t2 / 110 * (1 + t2 / 156))))) - p;
+				dg = t / 3 * (1 + t2 / 10 * (1 + t2 / 28 * (1 + t2 / 54 * (1 + t2 / 88 * (1 + t2 / 130)))));
+				return;
+			}
+			const double sinhc = 2 * s * (c / t);
+			g = sinhc - 1 - p;
+			dg = (c * c + s * s - sinhc) / t;
+		}
+
+		// the vertex is m left of the middle: tanh(m / a) = v / L
+		static double offset(double a, double, double, double v, double length) {
+			return a * std::atanh(v / length);
+		}
+	};
+
+	// the sag below the middle of the chord: a cosh(m / a) (cosh t - 1) with
+	// sinh(m / a) = v / (2 a sinh t), which is sqrt(P^2 + r^2 Q^2) / 2 per h,
+	// P = (cosh t - 1) / t and Q = tanh(t / 2), both growing with t;
+	// g = that - sag / h with p = sag / h and q = r = v / h
+	struct by_sag {
+		static bool setup(double h, double v, double sag, double& p, double& q, double& start) {
+			p = sag / h;
+			q = v / h;
+			// P exceeds t / 2, and e^t / 4t from t = ln 4 on; t > acosh(1 + 2 p t)
+			// right of the root of P = 2p, which is right of the root
+			start = p < 0.25 ? 4 * p : std::min(4 * p, 2 * std::log(8 * p));
+			for (int i = 0; i < 2 && start > 1; ++i) start = std::acosh(1 + 2 * p * start);
+			return p > 0 && std::isfinite(p) && std::isfinite(q);
+		}
+
+		static void equation(double p, double q, double t, double c, double s, double& g, double& dg) {
+			const double P = 2 * s * (s / t), Q = s / c,
+				dP = (2 * s * c - P) / t, dQ = 0.5 / (c * c),
+				norm = std::sqrt(P * P + q * q * Q * Q);
+			g = 0.5 * norm - p;
+			dg = 0.5 * (P * dP + q * q * Q * dQ) / norm;
+		}
+
+		static double offset(double a, double t, double h, double v, double) {
+			return a * std::asinh(v * t / (h * std::sinh(t)));
+		}
+	};
+
+	// Every lane keeps a bracket [lo, hi] around its root and takes the
+	// Newton step where it stays inside, else bisects; lanes run in lockstep
+	// until the last one has converged.
+	template <class Problem>
+	void fit(const curve::ShiftedCatenary::span* spans, const double* targets, curve::ShiftedCatenary* out, std::size_t n) {
+		double h[block], v[block], p[block], q[block], t[block], lo[block], hi[block], c[block], s[block];
+		bool valid[block], done[block];
+
+		for (std::size_t i = 0; i < n; i += block) {
+			const std::size_t m = std::min(block, n - i);
+
+			for (std::size_t j = 0; j < m; ++j) {
+				curve::ShiftedCatenary::span e = spans[i + j];
+				if (e.x2 < e.x1) {
+					std::swap(e.x1, e.x2);
+					std::swap(e.y1, e.y2);
+				}
+				h[j] = e.x2 - e.x1;
+				v[j] = e.y2 - e.y1;
+				valid[j] = h[j] > 0 && std::isfinite(h[j]) && std::isfinite(v[j])
+					&& Problem::setup(h[j], v[j], targets[i + j], p[j], q[j], t[j]);
+				// a lane without a curve solves a harmless stand-in
+				if (!valid[j]) Problem::setup(1, 0, 2, p[j], q[j], t[j]);
+				lo[j] = 0;
+				hi[j] = t[j];
+				done[j] = false;
+			}
+
+			for (int k = 0; k < max_iterations; ++k) {
+				curve::kernels::hyperbolic(2, t, c, s, m);
+
+				std::size_t active = 0;
+				for (std::size_t j = 0; j < m; ++j) {
+					double g, dg;
+					Problem::equation(p[j], q[j], t[j], c[j], s[j], g, dg);
+					lo[j] = g < 0 ? t[j] : lo[j];
+					hi[j] = g < 0 ? hi[j] : t[j];
+
+					// done on a step of a few ulps, or one back to the other end of
+					// the bracket, where rounding in g has the steps go back and
+					// forth; a lane that is done stays put, as it would on its own
+					const double newton = t[j] - g / dg,
+						next = newton >= lo[j] && newton <= hi[j] ? newton : 0.5 * (lo[j] + hi[j]);
+					const bool stop = done[j] || std::abs(next - t[j]) <= 4 * DBL_EPSILON * t[j] || next == lo[j] || next == hi[j];
+					t[j] = done[j] ? t[j] : next;
+					done[j] = stop;
+					active += !stop;
+				}
+				if (!active) break;
+			}
+
+			for (std::size_t j = 0; j < m; ++j) {
+				const curve::ShiftedCatenary::span& e = spans[i + j];
+				if (!valid[j]) {
+					out[i + j] = curve::ShiftedCatenary(nan, nan, nan);
+					continue;
+				}
+				const double a = h[j] / (2 * t[j]),
+					offset = Problem::offset(a, t[j], h[j], v[j], targets[i + j]);
+				out[i + j] = curve::ShiftedCatenary(a, 0.5 * (e.x1 + e.x2) - offset,
+					0.5 * (e.y1 + e.y2) - a * std::cosh(offset / a) * std::cosh(t[j]));
+			}
+		}
+	}
+
+}
+
+double curve::ShiftedCatenary::S(double x1, double x2) const {
+	return y0 * (x2 - x1) + c.S(x1 - x0, x2 - x0);
+}
+
+curve::coords_pair curve::ShiftedCatenary::CurvatureCenterCoords(double x) const {
+	coords_pair centers = c.CurvatureCenterCoords(x - x0);
+	centers.first.first += x0;
+	centers.first.second += y0;
+	centers.second.first += x0;
+	centers.second.second += y0;
+	return centers;
+}
+
+void curve::ShiftedCatenary::y(const double* xs, double* out, std::size_t n) const {
+	for (std::size_t i = 0; i < n; ++i) out[i] = xs[i] - x0;
+	c.y(out, out, n);
+	for (std::size_t i = 0; i < n; ++i) out[i] += y0;
+}
+
+void curve::ShiftedCatenary::l(const double* xs, double* out, std::size_t n) const {
+	for (std::size_t i = 0; i < n; ++i) out[i] = xs[i] - x0;
+	c.l(out, out, n);
+}
+
+void curve::ShiftedCatenary::R(const double* xs, double* out, std::size_t n) const {
+	for (std::size_t i = 0; i < n; ++i) out[i] = xs[i] - x0;
+	c.R(out, out, n);
+}
+
+void curve::ShiftedCatenary::S(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+	double u1[block], u2[block];
+
+	for (std::size_t i = 0; i < n; i += block) {
+		const std::size_t m = std::min(block, n - i);
+		for (std::size_t j = 0; j < m; ++j) {
+			u1[j] = x1s[i + j] - x0;
+			u2[j] = x2s[i + j] - x0;
+		}
+		c.S(u1, u2, out + i, m);
+		for (std::size_t j = 0; j < m; ++j) out[i + j] += y0 * (x2s[i + j] - x1s[i + j]);
+	}
+}
+
+void curve::ShiftedCatenary::CurvatureCenterCoords(const double* xs, coord_view first, coord_view second) const {
+	if (second.size < first.size) {
+		throw std::invalid_argument("center buffer too small");
+	}
+
+	double u[block];
+
+	for (std::size_t i = 0; i < first.size; i += block) {
+		const std::size_t m = std::min(block, first.size - i);
+		for (std::size_t j = 0; j < m; ++j) u[j] = xs[i + j] - x0;
+		c.CurvatureCenterCoords(u, first.subview(i, m), second.subview(i, m));
+		for (std::size_t j = 0; j < m; ++j) {
+			first.xs[i + j] += x0;
+			first.ys[i + j] += y0;
+			second.xs[i + j] += x0;
+			second.ys[i + j] += y0;
+		}
+	}
+}
+
+std::optional<curve::ShiftedCatenary> curve::ShiftedCatenary::fit_length(const span& s, double length) {
+	ShiftedCatenary fitted;
+	fit_length(&s, &length, &fitted, 1);
+	return std::isnan(fitted.get_a()) ? std::nullopt : std::optional<ShiftedCatenary>(fitted);
+}
+
+std::optional<curve::ShiftedCatenary> curve::ShiftedCatenary::fit_sag(const span& s, double sag) {
+	ShiftedCatenary fitted;
+	fit_sag(&s, &sag, &fitted, 1);
+	return std::isnan(fitted.get_a()) ? std::nullopt : std::optional<ShiftedCatenary>(fitted);
+}
+
+void curve::ShiftedCatenary::fit_length(const span* spans, const double* lengths, ShiftedCatenary* out, std::size_t n) {
+	fit<by_length>(spans, lengths, out, n);
+}
+
+void curve::ShiftedCatenary::fit_sag(const span* spans, const double* sags, ShiftedCatenary* out, std::size_t n) {
+	fit<by_sag>(spans, sags, out, n);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "Catenary.h"
+
+namespace curve {
+
+	// Catenary with its vertex moved from (0, a) to (x0, y0 + a):
+	// y(x) = y0 + a cosh((x - x0) / a), the cable hanging between two
+	// supports anywhere. l is the arc length from the vertex and S the area
+	// down to y = 0, as for Catenary.
+	class ShiftedCatenary {
+	public:
+		// the two supports of a cable, in either order
+		struct span {
+			double x1, y1, x2, y2;
+		};
+
+		ShiftedCatenary() noexcept : x0(0), y0(0) {}
+		// a == 0 is reported and replaced by 1, as for Catenary
+		ShiftedCatenary(double a, double x0, double y0) noexcept : c(a), x0(x0), y0(y0) {}
+
+		double get_a() const noexcept { return c.get_a(); }
+		double get_x0() const noexcept { return x0; }
+		double get_y0() const noexcept { return y0; }
+		// the same curve with its vertex at the origin's x
+		Catenary centered() const noexcept { return c; }
+
+		double y(double x) const { return y0 + c.y(x - x0); }
+		double l(double x) const { return c.l(x - x0); }
+		double R(double x) const { return c.R(x - x0); }
+		double S(double x1, double x2) const;
+		coords_pair CurvatureCenterCoords(double x) const;
+
+		// batch forms, out[i] is the scalar result for xs[i]
+		void y(const double* xs, double* out, std::size_t n) const;
+		void l(const double* xs, double* out, std::size_t n) const;
+		void R(const double* xs, double* out, std::size_t n) const;
+		void S(const double* x1s, const double* x2s, double* out, std::size_t n) const;
+		void CurvatureCenterCoords(const double* xs, coord_view first, coord_view second) const;
+
+		// the curve (a > 0) through both supports with that arc length between
+		// them, nothing unless the length exceeds the straight line
+		static std::optional<ShiftedCatenary> fit_length(const span& s, double length);
+		// the curve through both supports that passes sag below the middle of
+		// the line joining them, nothing unless sag > 0
+		static std::optional<ShiftedCatenary> fit_sag(const span& s, double sag);
+		// the same for n spans at once, the a of out[i] NaN where there is no
+		// curve; the spans are solved a block at a time, every Newton step of a
+		// block one hyperbolic kernel call
+		static void fit_length(const span* spans, const double* lengths, ShiftedCatenary* out, std::size_t n);
+		static void fit_sag(const span* spans, const double* sags, ShiftedCatenary* out, std::size_t n);
+
+	private:
+		Catenary c;
+		double x0, y0;
+	};
+
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "Catenary.h"
+#include "hyperbolic.h"
+
+namespace curve {
+
+	// constexpr cosh/sinh for StaticCatenary, the same scheme as the batch
+	// kernels: e^|u| / 2 = p(r) * 2^(n - 1) with |u| = n * ln2 + r, p the
+	// Taylor polynomial of e^r, and the odd series of sinh below |u| = 1.
+	// At compile time a result that overflows is an error, not INFINITY.
+	// At run time cosh is libm's: h + 1 / (4h) puts a division after the
+	// polynomial on the latency path, and std::cosh beats it by some 20%.
+	// sinh stays ours, it is about twice as fast as std::sinh.
+	namespace detail {
+
+		// true while a constant expression is evaluated; without the builtin,
+		// always true, so the constexpr forms run everywhere
+		constexpr bool constant_evaluated() {
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+			return __builtin_is_constant_evaluated();
+#else
+			return true;
+#endif
+		}
+
+		constexpr double log2e = 1.4426950408889634074;
+		constexpr double ln2_hi = 6.93147180369123816490e-01;
+		constexpr double ln2_lo = 1.90821492927058770002e-10;
+		constexpr double u_clamp = 711.0;
+
+		// 2^0 .. 2^513, enough for both halves of 2^n at the clamp
+		constexpr std::array<double, 514> make_pow2() {
+			std::array<double, 514> table{};
+			double p = 1;
+			for (std::size_t k = 0; k < table.size(); ++k, p *= 2)
+				table[k] = p;
+			return table;
+		}
+
+		constexpr std::array<double, 514> pow2 = make_pow2();
+
+		// 1 / k!
+		constexpr std::array<double, 18> make_inv_fact() {
+			std::array<double, 18> table{};
+			double f = 1;
+			for (std::size_t k = 0; k < table.size(); ++k) {
+				f *= k ? k : 1;
+				table[k] = 1 / f;
+			}
+			return table;
+		}
+
+		constexpr std::array<double, 18> inv_fact = make_inv_fact();
+
+		// e^au / 2, au in [0, u_clamp] or NaN (treated as the clamp)
+		constexpr double half_exp(double au) {
+			const double cu = au < u_clamp ? au : u_clamp;
+			const int n = static_cast<int>(cu * log2e + 0.5);
+			const double r = (cu - n * ln2_hi) - n * ln2_lo;
+
+			// Estrin's scheme, the scalar path is bound by the polynomial's latency
+			const double r2 = r * r, r4 = r2 * r2, r8 = r4 * r4;
+			const double p = ((1 + r) + (inv_fact[2] + inv_fact[3] * r) * r2)
+				+ ((inv_fact[4] + inv_fact[5] * r) + (inv_fact[6] + inv_fact[7] * r) * r2) * r4
+				+ (((inv_fact[8] + inv_fact[9] * r) + (inv_fact[10] + inv_fact[11] * r) * r2)
+					+ (inv_fact[12] + inv_fact[13] * r) * r4) * r8;
+
+			return 0.5 * p * pow2[n / 2] * pow2[n - n / 2];
+		}
+
+		constexpr double abs(double u) { return u < 0 ? -u : u; }
+
+		constexpr double cosh(double u) {
+			if (!constant_evaluated()) return std::cosh(u);
+			const double h = half_exp(abs(u));
+			return u != u ? u : h + 0.25 / h;
+		}
+
+		constexpr double sinh(double u) {
+			const double u2 = u * u;
+			const double u4 = u2 * u2, u8 = u4 * u4;
+			const double s = ((1 + inv_fact[3] * u2) + (inv_fact[5] + inv_fact[7] * u2) * u4)
+				+ ((inv_fact[9] + inv_fact[11] * u2) + (inv_fact[13] + inv_fact[15] * u2) * u4) * u8
+				+ inv_fact[17] * u8 * u8;
+
+			const double h = half_exp(abs(u)),
+				d = h - 0.25 / h;
+			return abs(u) < 1 ? s * u
+				: u != u ? u
+				: u < 0 ? -d : d;
+		}
+
+	}
+
+	// Catenary with a = Num / Den fixed at compile time.
+	// 1 / a and a^2 are constants, so the scalar methods never divide and are
+	// constexpr (tables can be built by the compiler, see tabulate); l and S
+	// inline into the caller with no call into libm, y and R call std::cosh
+	// at run time.
+	// Results agree with Catenary to a few ulp of x / a, multiplying by
+	// 1 / a may round differently from the division.
+	template <std::intmax_t Num, std::intmax_t Den = 1>
+	class StaticCatenary {
+		static_assert(Num != 0, "wrong value for 'a'");
+		static_assert(Den > 0, "the denominator of 'a' must be positive");
+
+	public:
+		static constexpr double a = static_cast<double>(Num) / Den;
+		static constexpr double inv_a = static_cast<double>(Den) / Num;
+		static constexpr double a2 = a * a;
+
+		constexpr double get_a() const { return a; }
+		constexpr double y(double x) const { return a * detail::cosh(x * inv_a); }
+		constexpr double l(double x) const { return a * detail::sinh(x * inv_a); }
+		constexpr double R(double x) const {
+			const double ch = detail::cosh(x * inv_a);
+			return a * ch * ch;
+		}
+		constexpr double S(double x1, double x2) const {
+			return a2 * (detail::sinh(x2 * inv_a) - detail::sinh(x1 * inv_a));
+		}
+		constexpr coords_pair CurvatureCenterCoords(double x) const {
+			const double ch = detail::cosh(x * inv_a),
+				sh = detail::sinh(x * inv_a),
+				x_expr = detail::abs(a) * sh * ch,
+				y_expr = detail::abs(a) * ch,
+				y = a * ch;
+			return std::make_pair(
+				std::make_pair(x + x_expr, y - y_expr),
+				std::make_pair(x - x_expr, y + y_expr)
+			);
+		}
+
+		// the runtime curve with the same coefficient
+		Catenary runtime() const { return Catenary(a); }
+
+		// batch forms, out[i] is the scalar result for xs[i]; they run the
+		// SIMD kernels of Catenary, which beat any loop over the scalar forms
+		void y(const double* xs, double* out, std::size_t n) const { kernels::ordinate(a, xs, out, n); }
+		void l(const double* xs, double* out, std::size_t n) const { kernels::arc_length(a, xs, out, n); }
+		void R(const double* xs, double* out, std::size_t n) const { kernels::curvature_radius(a, xs, out, n); }
+		void S(const double* x1s, const double* x2s, double* out, std::size_t n) const {
+			kernels::area(a, x1s, x2s, out, n);
+		}
+	};
+
+	// f(x0), f(x0 + h), ... f(x0 + (N - 1) * h), usable in constant expressions:
+	//   constexpr auto ys = tabulate<64>([](double x) { return StaticCatenary<2>().y(x); }, -4, 0.125);
+	template <std::size_t N, class F>
+	constexpr std::array<double, N> tabulate(F f, double x0, double h) {
+		std::array<double, N> table{};
+		for (std::size_t i = 0; i < N; ++i)
+			table[i] = f(x0 + static_cast<double>(i) * h);
+		return table;
+	}
+
+}
@@ -0,0 +1,51 @@
+#include "pch.h"
+#include "SweepEngine.h"
+#include "Catenary.h"
+
+#include <algorithm>
+
+namespace {
+
+	const double zeros[curve::SweepEngine::tile_width] = {};
+
+	void run_tile(curve::quantity q, double a, const double* xs, double* out, std::size_t n) {
+		const curve::Catenary c(a);
+
+		switch (q) {
+		case curve::quantity::ordinate:
+			c.y(xs, out, n);
+			break;
+		case curve::quantity::arc_length:
+			c.l(xs, out, n);
+			break;
+		case curve::quantity::curvature_radius:
+			c.R(xs, out, n);
+			break;
+		case curve::quantity::area:
+			c.S(zeros, xs, out, n);
+			break;
+		}
+	}
+
+}
+
+void curve::SweepEngine::run(quantity q, const double* as, std::size_t na,
+	const double* xs, std::size_t nx, double* out)
+{
+	const std::size_t cols = (nx + tile_width - 1) / tile_width;
+
+	pool.parallel_for(na * cols, [=](std::size_t t) {
+		const std::size_t row = t / cols,
+			col = t % cols * tile_width,
+			n = std::min(tile_width, nx - col);
+		run_tile(q, as[row], xs + col, out + row * nx + col, n);
+	});
+}
+
+void curve::SweepEngine::run_serial(quantity q, const double* as, std::size_t na,
+	const double* xs, std::size_t nx, double* out) const
+{
+	for (std::size_t row = 0; row < na; ++row)
+		for (std::size_t col = 0; col < nx; col += tile_width)
+			run_tile(q, as[row], xs + col, out + row * nx + col, std::min(tile_width, nx - col));
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+#include "ThreadPool.h"
+
+namespace curve {
+
+	enum class quantity {
+		ordinate,			// y(x)
+		arc_length,			// l(x)
+		curvature_radius,	// R(x)
+		area				// S(0, x)
+	};
+
+	// Evaluates one quantity over an a x x grid.
+	// The grid is cut into tiles of one coefficient by tile_width abscissae,
+	// small enough for the tile's input and output to stay in L1, and the
+	// tiles are spread over a work-stealing pool. Every tile runs the same
+	// batch kernel whichever thread picks it up, so run and run_serial
+	// produce bit-identical output.
+	class SweepEngine {
+	public:
+		static constexpr std::size_t tile_width = 2048;
+
+		explicit SweepEngine(unsigned threads = std::thread::hardware_concurrency()) : pool(threads) {}
+
+		// out is row-major: out[i * nx + j] is q for Catenary(as[i]) at xs[j]
+		void run(quantity q, const double* as, std::size_t na,
+			const double* xs, std::size_t nx, double* out);
+		void run_serial(quantity q, const double* as, std::size_t na,
+			const double* xs, std::size_t nx, double* out) const;
+
+		unsigned threads() const { return pool.size(); }
+
+	private:
+		ThreadPool pool;
+	};
+
+}
@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "TabulatedCatenary.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+curve::TabulatedCatenary::TabulatedCatenary(double a, double x_min, double x_max, double max_rel_error)
+	: c(a), tolerance(max_rel_error), x_lo(x_min), x_hi(x_max)
+{
+	if (!(x_min < x_max)) {
+		throw std::invalid_argument("empty range for the table");
+	}
+	if (!(max_rel_error >= 1e-14)) {
+		throw std::invalid_argument("max_rel_error is below double rounding");
+	}
+
+	const double u_a = x_min / c.get_a(),
+		u_b = x_max / c.get_a(),
+		u_min = std::min(u_a, u_b),
+		u_max = std::max(u_a, u_b);
+
+	if (std::max(-u_min, u_max) > 709) {
+		throw std::invalid_argument("range overflows cosh");
+	}
+
+	// Hermite remainder is f''''(xi) / 4! * s^2 (h - s)^2, for both cosh and
+	// sinh relative to the value at s it stays below h^4 * e^h / 162
+	// (the worst case is sinh next to the node at 0), R squares cosh so the
+	// table is built for half the requested error.
+	h = std::min(0.5, pow(81 * max_rel_error / exp(0.5), 0.25));
+	scale = 1 / (c.get_a() * h);
+
+	// the grid is anchored at u = 0 so sinh keeps its relative accuracy there
+	k0 = floor(u_min / h);
+	const double k1 = ceil(u_max / h);
+
+	const std::size_t n = static_cast<std::size_t>(k1 - k0) + 1;
+	ch.resize(std::max<std::size_t>(n, 2));
+	sh.resize(ch.size());
+	for (std::size_t i = 0; i < ch.size(); ++i) {
+		const double u = (k0 + i) * h;
+		ch[i] = cosh(u);
+		sh[i] = sinh(u);
+	}
+}
+
+bool curve::TabulatedCatenary::lookup(double x, double& cosh_u, double& sinh_u) const {
+	if (!(x >= x_lo && x <= x_hi)) return false;
+
+	const double t = x * scale - k0;
+	const std::size_t i = std::min(static_cast<std::size_t>(std::max(t, 0.0)), ch.size() - 2);
+	const double s = t - i,
+		s1 = 1 - s,
+		h00 = (1 + 2 * s) * s1 * s1,
+		h10 = s * s1 * s1 * h,
+		h01 = s * s * (3 - 2 * s),
+		h11 = -s * s * s1 * h;
+
+	cosh_u = h00 * ch[i] + h10 * sh[i] + h01 * ch[i + 1] + h11 * sh[i + 1];
+	sinh_u = h00 * sh[i] + h10 * ch[i] + h01 * sh[i + 1] + h11 * ch[i + 1];
+	return true;
+}
+
+double curve::TabulatedCatenary::y(double x) const {
+	double cu, su;
+	return lookup(x, cu, su) ? c.get_a() * cu : c.y(x);
+}
+
+double curve::TabulatedCatenary::l(double x) const {
+	double cu, su;
+	return lookup(x, cu, su) ? c.get_a() * su : c.l(x);
+}
+
+double curve::TabulatedCatenary::R(double x) const {
+	double cu, su;
+	return lookup(x, cu, su) ? c.get_a() * cu * cu : c.R(x);
+}
+
+double curve::TabulatedCatenary::S(double x1, double x2) const {
+	double cu1, su1, cu2, su2;
+	if (lookup(x1, cu1, su1) && lookup(x2, cu2, su2))
+		return c.get_a() * c.get_a() * (su2 - su1);
+	return c.S(x1, x2);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Catenary.h"
+
+namespace curve {
+
+	// Catenary with cosh/sinh(x / a) tabulated over [x_min, x_max].
+	// Both functions are rebuilt between nodes by cubic Hermite interpolation
+	// from the stored (cosh, sinh) pairs - each is the other's derivative,
+	// so a node costs two doubles. The node spacing follows from
+	// max_rel_error, which is the build-time / accuracy knob: halving the
+	// error grows the table (and the build time) by 2^(1/4).
+	// Queries outside [x_min, x_max] fall back to the direct Catenary methods.
+	class TabulatedCatenary {
+	public:
+		TabulatedCatenary(double a, double x_min, double x_max, double max_rel_error = 1e-12);
+
+		double get_a() const { return c.get_a(); }
+		double max_rel_error() const { return tolerance; }
+		std::size_t nodes() const { return ch.size(); }
+
+		double y(double x) const;
+		double l(double x) const;
+		double R(double x) const;
+		// the error bound is relative to a^2 * (|sinh(x1 / a)| + |sinh(x2 / a)|)
+		double S(double x1, double x2) const;
+
+	private:
+		bool lookup(double x, double& cosh_u, double& sinh_u) const;
+
+		Catenary c;
+		double tolerance;
+		double k0, h, scale, x_lo, x_hi;
+		std::vector<double> ch, sh;
+	};
+
+}
@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+curve::ThreadPool::ThreadPool(unsigned threads)
+	: participants(threads ? threads : 1),
+	ranges(new range[participants]),
+	task(nullptr), generation(0), busy(0), stop(false)
+{
+	for (unsigned i = 1; i < participants; ++i)
+		workers.emplace_back(&ThreadPool::worker, this, i);
+}
+
+curve::ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m);
+		stop = true;
+	}
+	wake.notify_all();
+	for (auto& t : workers) t.join();
+}
+
+void curve::ThreadPool::parallel_for(std::size_t n, const std::function<void(std::size_t)>& fn) {
+	if (participants == 1 || n < 2) {
+		for (std::size_t i = 0; i < n; ++i) fn(i);
+		return;
+	}
+
+	for (unsigned p = 0; p < participants; ++p) {
+		std::lock_guard<std::mutex> lock(ranges[p].m);
+		ranges[p].begin = n * p / participants;
+		ranges[p].end = n * (p + 1) / participants;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m);
+		task = &fn;
+		busy = participants - 1;
+		++generation;
+	}
+	wake.notify_all();
+
+	drain(0);
+
+	std::unique_lock<std::mutex> lock(m);
+	finished.wait(lock, [this] { return busy == 0; });
+	task = nullptr;
+	if (error) {
+		const std::exception_ptr e = error;
+		error = nullptr;
+		std::rethrow_exception(e);
+	}
+}
+
+void curve::ThreadPool::worker(unsigned self) {
+	std::size_t seen = 0;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(m);
+			wake.wait(lock, [&] { return stop || generation != seen; });
+			if (stop) return;
+			seen = generation;
+		}
+
+		drain(self);
+
+		std::lock_guard<std::mutex> lock(m);
+		if (--busy == 0) finished.notify_one();
+	}
+}
+
+void curve::ThreadPool::drain(unsigned self) {
+	std::size_t i;
+	while (pop(self, i) || steal(self, i)) {
+		// a throw must not unwind past here: the caller would destroy task
+		// while the workers still run it, and a worker would terminate
+		try {
+			(*task)(i);
+		}
+		catch (...) {
+			cancel(std::current_exception());
+		}
+	}
+}
+
+void curve::ThreadPool::cancel(std::exception_ptr e) {
+	{
+		std::lock_guard<std::mutex> lock(m);
+		if (!error) error = e;
+	}
+	// a half stolen just now is still run by its thief
+	for (unsigned p = 0; p < participants; ++p) {
+		std::lock_guard<std::mutex> lock(ranges[p].m);
+		ranges[p].begin = ranges[p].end;
+	}
+}
+
+bool curve::ThreadPool::pop(unsigned self, std::size_t& i) {
+	std::lock_guard<std::mutex> lock(ranges[self].m);
+	if (ranges[self].begin == ranges[self].end) return false;
+	i = ranges[self].begin++;
+	return true;
+}
+
+bool curve::ThreadPool::steal(unsigned self, std::size_t& i) {
+	for (unsigned k = 1; k < participants; ++k) {
+		range& victim = ranges[(self + k) % participants];
+		std::size_t begin, end;
+		{
+			std::lock_guard<std::mutex> lock(victim.m);
+			if (victim.begin == victim.end) continue;
+			const std::size_t mid = victim.begin + (victim.end - victim.begin) / 2;
+			begin = mid;
+			end = victim.end;
+			victim.end = mid;
+		}
+
+		i = begin;
+		std::lock_guard<std::mutex> lock(ranges[self].m);
+		ranges[self].begin = begin + 1;
+		ranges[self].end = end;
+		return true;
+	}
+	return false;
+}
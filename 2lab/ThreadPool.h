@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace curve {
+
+	// Fixed set of workers running index ranges with work stealing:
+	// every participant starts with a contiguous slice of [0, n) and,
+	// once it runs dry, takes the back half of someone else's slice.
+	// The calling thread takes part in parallel_for as participant 0.
+	class ThreadPool {
+	public:
+		explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency());
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// calls task(i) once for every i in [0, n), returns when all calls are done;
+		// if a call throws, the indices not yet started are dropped and the first
+		// exception is rethrown once every participant has stopped using task
+		void parallel_for(std::size_t n, const std::function<void(std::size_t)>& task);
+
+		unsigned size() const { return participants; }
+
+	private:
+		struct alignas(64) range {
+			std::mutex m;
+			std::size_t begin = 0, end = 0;
+		};
+
+		void worker(unsigned self);
+		void drain(unsigned self);
+		bool pop(unsigned self, std::size_t& i);
+		bool steal(unsigned self, std::size_t& i);
+		void cancel(std::exception_ptr e);
+
+		unsigned participants;
+		std::unique_ptr<range[]> ranges;
+		std::vector<std::thread> workers;
+
+		std::mutex m;
+		std::condition_variable wake, finished;
+		const std::function<void(std::size_t)>* task;
+		std::exception_ptr error;
+		std::size_t generation;
+		unsigned busy;
+		bool stop;
+	};
+
+}
@@ -0,0 +1,139 @@
+#include "pch.h"
+#include "UniformSweep.h"
+#include "hyperbolic.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+	// past this |u| a step may overflow before cosh itself does
+	constexpr double overflow_u = 705;
+
+	// chains the batch outputs interleave, and points per anchor in each
+	constexpr std::size_t lanes = 8;
+	constexpr std::size_t block = curve::UniformSweep::anchor_period / 2 * lanes;
+
+}
+
+curve::UniformSweep::UniformSweep(double a, double x0, double h, std::size_t n)
+	: a(a), x0(x0), h(h), count(n)
+{
+	if (a == 0) {
+		throw std::invalid_argument("wrong value for 'a'");
+	}
+	if (!std::isfinite(a) || !std::isfinite(x0) || !std::isfinite(h)) {
+		throw std::invalid_argument("sweep bounds are not finite");
+	}
+
+	exp_d = exp(h / a);
+	exp_md = exp(-h / a);
+}
+
+curve::UniformSweep::iterator::iterator(const UniformSweep* sweep, std::size_t i)
+	: s(sweep), i(i), e(0), f(0), direct(false), p{}
+{
+	if (i < s->count) anchor();
+}
+
+void curve::UniformSweep::iterator::anchor() {
+	const double u = s->x(i) / s->a;
+
+	if (i % anchor_period == 0) {
+		const double u_last = s->x(std::min(i + anchor_period, s->count) - 1) / s->a;
+		direct = !(std::max(std::abs(u), std::abs(u_last)) < overflow_u);
+	}
+
+	if (direct) {
+		p = point{ s->x(i), s->a * cosh(u), s->a * sinh(u) };
+		return;
+	}
+	e = exp(u);
+	f = exp(-u);
+	p = point{ s->x(i), s->a * 0.5 * (e + f), s->a * 0.5 * (e - f) };
+}
+
+curve::UniformSweep::iterator& curve::UniformSweep::iterator::operator++() {
+	if (++i >= s->count) return *this;
+
+	if (direct || i % anchor_period == 0) {
+		anchor();
+		return *this;
+	}
+
+	e *= s->exp_d;
+	f *= s->exp_md;
+	p = point{ s->x(i), s->a * 0.5 * (e + f), s->a * 0.5 * (e - f) };
+	return *this;
+}
+
+// calls store(first, m, ch, sh) with cosh / sinh for points first .. first + m
+template <class Store>
+void curve::UniformSweep::run(Store store) const {
+	// lane j of a block holds points j, j + lanes, ..., so every chain steps
+	// by lanes * d, and starts e^(j d) from the block's anchor
+	double lane_e[lanes], lane_f[lanes];
+	for (std::size_t j = 0; j < lanes; ++j) {
+		lane_e[j] = exp(j * h / a);
+		lane_f[j] = exp(-(j * h / a));
+	}
+	const double step_e = exp(lanes * h / a), step_f = exp(-(lanes * h / a));
+
+	double xs[block], ch[block], sh[block];
+
+	for (std::size_t i = 0; i < count; i += block) {
+		const std::size_t m = std::min(block, count - i);
+
+		if (!(std::max(std::abs(x(i) / a), std::abs(x(i + m - 1) / a)) < overflow_u)) {
+			for (std::size_t j = 0; j < m; ++j) xs[j] = x(i + j);
+			kernels::hyperbolic(a, xs, ch, sh, m);
+			store(i, m, ch, sh);
+			continue;
+		}
+
+		const double e0 = exp(x(i) / a), f0 = exp(-(x(i) / a));
+		double e[lanes], f[lanes];
+		for (std::size_t j = 0; j < lanes; ++j) {
+			e[j] = e0 * lane_e[j];
+			f[j] = f0 * lane_f[j];
+		}
+
+		for (std::size_t k = 0; k < m; k += lanes) {
+			for (std::size_t j = 0; j < lanes; ++j) {
+				ch[k + j] = 0.5 * (e[j] + f[j]);
+				sh[k + j] = 0.5 * (e[j] - f[j]);
+				e[j] *= step_e;
+				f[j] *= step_f;
+			}
+		}
+		store(i, m, ch, sh);
+	}
+}
+
+void curve::UniformSweep::y(double* out) const {
+	run([&](std::size_t i, std::size_t m, const double* ch, const double*) {
+		for (std::size_t j = 0; j < m; ++j) out[i + j] = a * ch[j];
+	});
+}
+
+void curve::UniformSweep::l(double* out) const {
+	run([&](std::size_t i, std::size_t m, const double*, const double* sh) {
+		for (std::size_t j = 0; j < m; ++j) out[i + j] = a * sh[j];
+	});
+}
+
+void curve::UniformSweep::R(double* out) const {
+	run([&](std::size_t i, std::size_t m, const double* ch, const double*) {
+		for (std::size_t j = 0; j < m; ++j) out[i + j] = a * ch[j] * ch[j];
+	});
+}
+
+void curve::UniformSweep::evaluate(double* ys, double* ls) const {
+	run([&](std::size_t i, std::size_t m, const double* ch, const double* sh) {
+		for (std::size_t j = 0; j < m; ++j) {
+			ys[i + j] = a * ch[j];
+			ls[i + j] = a * sh[j];
+		}
+	});
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+namespace curve {
+
+	// y and l of one catenary at x0, x0 + h, ... x0 + (n - 1) * h without a
+	// transcendental call per point. With u = x / a and d = h / a the addition
+	// formulas are applied in their split form,
+	//   cosh(u + d) = (e^u * e^d + e^-u * e^-d) / 2,  sinh likewise with a minus,
+	// one multiply per exponential and point: stepping the (cosh, sinh) pair
+	// itself mixes the two exponentials and amplifies rounding by e^(2 k d)
+	// whenever the sweep runs toward the vertex. The exponentials are recomputed
+	// directly every anchor_period points, so the drift stays within a few
+	// dozen ulp of cosh u (sinh included, its error is absolute on that scale).
+	// Stretches that reach the cosh overflow are evaluated directly.
+	class UniformSweep {
+	public:
+		static constexpr std::size_t anchor_period = 64;
+
+		struct point {
+			double x, y, l;
+		};
+
+		// single-pass iterator over the points, for loops that consume them one by one
+		class iterator {
+		public:
+			typedef std::input_iterator_tag iterator_category;
+			typedef point value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const point* pointer;
+			typedef const point& reference;
+
+			const point& operator*() const { return p; }
+			const point* operator->() const { return &p; }
+			iterator& operator++();
+			iterator operator++(int) {
+				iterator old(*this);
+				++*this;
+				return old;
+			}
+
+			bool operator==(const iterator& other) const { return i == other.i; }
+			bool operator!=(const iterator& other) const { return i != other.i; }
+
+		private:
+			friend class UniformSweep;
+			iterator(const UniformSweep* sweep, std::size_t i);
+			void anchor();
+
+			const UniformSweep* s;
+			std::size_t i;
+			double e, f; // e^u, e^-u
+			bool direct;
+			point p;
+		};
+
+		UniformSweep(double a, double x0, double h, std::size_t n);
+
+		iterator begin() const { return iterator(this, 0); }
+		iterator end() const { return iterator(this, count); }
+		std::size_t size() const { return count; }
+		double x(std::size_t i) const { return x0 + static_cast<double>(i) * h; }
+
+		// batch outputs, out[i] is the value at x(i); these run the recurrence
+		// in interleaved chains the compiler vectorizes, so they beat the iterator
+		void y(double* out) const;
+		void l(double* out) const;
+		void R(double* out) const;
+		void evaluate(double* ys, double* ls) const;
+
+	private:
+		template <class Store>
+		void run(Store store) const;
+
+		double a, x0, h;
+		std::size_t count;
+		double exp_d, exp_md;
+	};
+
+}
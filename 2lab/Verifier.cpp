@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "Verifier.h"
+#include "ReferenceCatenary.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+	// |got - exact| in ulps of scale
+	double ulps(double got, double exact, double scale) {
+		if (got == exact || (std::isnan(got) && std::isnan(exact))) return 0;
+		const double difference = std::abs(got - exact);
+		if (!std::isfinite(difference)) return std::numeric_limits<double>::infinity();
+		const double s = std::abs(scale);
+		return difference / (std::nextafter(s, std::numeric_limits<double>::infinity()) - s);
+	}
+
+}
+
+curve::Verifier::Verifier(std::uint64_t period) : period(period) {
+	if (period == 0) {
+		throw std::invalid_argument("wrong value for 'period'");
+	}
+}
+
+double curve::Verifier::check(query q, double a, double x, double x2, const double* results) {
+	const ReferenceCatenary r(a);
+	double e = 0;
+
+	switch (q) {
+	case query::ordinate: {
+		const double y = std::abs(r.y(x));
+		e = ulps(results[0], y, y);
+		break;
+	}
+	case query::arc_length: {
+		const double l = r.l(x);
+		e = ulps(results[0], l, l);
+		break;
+	}
+	case query::curvature_radius: {
+		const double R = std::abs(r.R(x));
+		e = ulps(results[0], R, R);
+		break;
+	}
+	case query::curvature_centers: {
+		const coords_pair c = r.CurvatureCenterCoords(x);
+		const double y = r.y(x), along = std::abs(x) + std::abs(r.l(x) * (y / a)), across = 2 * std::abs(y);
+		e = std::max({
+			ulps(results[0], c.first.first, along), ulps(results[1], c.first.second, across),
+			ulps(results[2], c.second.first, along), ulps(results[3], c.second.second, across) });
+		break;
+	}
+	case query::area: {
+		const double S = std::abs(r.S(x, x2));
+		e = ulps(results[0], S, std::abs(a) * (std::abs(r.l(x)) + std::abs(r.l(x2))));
+		break;
+	}
+	}
+
+	const std::lock_guard<std::mutex> lock(m);
+	totals& t = kinds[static_cast<int>(q)];
+	++t.checked;
+	t.sum += e;
+	if (t.checked == 1 || e > t.max) {
+		t.max = e;
+		t.worst_a = a;
+		t.worst_x = x;
+	}
+	return e;
+}
+
+curve::Verifier::summary curve::Verifier::result(query q) const {
+	const std::lock_guard<std::mutex> lock(m);
+	const totals& t = kinds[static_cast<int>(q)];
+	return summary{ t.checked, t.checked ? t.sum / t.checked : 0, t.max, t.worst_a, t.worst_x };
+}
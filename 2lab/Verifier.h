@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+#include "QueryCache.h"
+
+namespace curve {
+
+	// Checks a sample of served results against ReferenceCatenary: due()
+	// picks one query in every period, check() recomputes it and adds its
+	// error to the totals of its kind of query. Errors are in ulps of the
+	// magnitude the result is built from, which is the result itself for
+	// y, l and R, |a| (|l(x)| + |l(x2)|) for S, and |x| + |l y / a| and
+	// 2 |y| for the coordinates of the centers. Shared by any number of threads.
+	class Verifier {
+	public:
+		struct summary {
+			std::uint64_t checked;
+			double mean_ulps, max_ulps;
+			// the query with the largest error
+			double worst_a, worst_x;
+		};
+
+		// throws std::invalid_argument if period is 0
+		explicit Verifier(std::uint64_t period);
+
+		Verifier(const Verifier&) = delete;
+		Verifier& operator=(const Verifier&) = delete;
+
+		std::uint64_t get_period() const { return period; }
+		// whether the query numbered index (from 0) is in the sample
+		bool due(std::uint64_t index) const { return index % period == 0; }
+
+		// results of q as batch prints them: y, R and S by absolute value,
+		// x1, y1, x2, y2 for the centers; x2 is read for area only. a must be
+		// one Catenary accepts. Returns the error, infinite if only one of the
+		// two results is finite (or NaN)
+		double check(query q, double a, double x, double x2, const double* results);
+
+		summary result(query q) const;
+
+	private:
+		struct totals {
+			std::uint64_t checked = 0;
+			double sum = 0, max = 0, worst_a = 0, worst_x = 0;
+		};
+
+		std::uint64_t period;
+		mutable std::mutex m;
+		totals kinds[5];
+	};
+
+}
@@ -0,0 +1,181 @@
+#include "pch.h"
+#include "batch.h"
+#include "buffered_io.h"
+#include "numeric_io.h"
+#include "Catenary.h"
+#include "QueryCache.h"
+#include "Verifier.h"
+#include "Instrument.h"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+	// keeps the last curve around, consecutive records usually share 'a'
+	class evaluator
+	{
+	public:
+		explicit evaluator(curve::QueryCache* cache) : current(1), cache(cache) {}
+
+		// number of results written to out, 0 for an invalid record
+		int operator()(const batch::record& r, double out[4])
+		{
+			if (r.a == 0 || !std::isfinite(r.a)) return 0;
+			if (r.op < batch::get_ordinate || r.op > batch::get_trapeze_area) return 0;
+			if (!cache) return compute(r, out);
+
+			// curve::query lists the operations in the menu order
+			const curve::QueryCache::value v = cache->get(r.a, static_cast<curve::query>(r.op - batch::get_ordinate),
+				r.x, r.x2, [&] {
+					curve::QueryCache::value computed{};
+					compute(r, computed.data());
+					return computed;
+				});
+			const int n = r.op == batch::get_curvature_center_coordinates ? 4 : 1;
+			for (int i = 0; i < n; ++i) out[i] = v[i];
+			return n;
+		}
+
+	private:
+		int compute(const batch::record& r, double out[4])
+		{
+			if (r.a != current.get_a()) current.set_a(r.a);
+
+			switch (r.op)
+			{
+			case batch::get_ordinate:
+				out[0] = std::abs(CURVE_TIMED(ordinate, current.y(r.x)));
+				return 1;
+			case batch::get_arc_length:
+				out[0] = CURVE_TIMED(arc_length, current.l(r.x));
+				return 1;
+			case batch::get_curvature_radius:
+				out[0] = std::abs(CURVE_TIMED(curvature_radius, current.R(r.x)));
+				return 1;
+			case batch::get_curvature_center_coordinates: {
+				const curve::coords_pair centers(CURVE_TIMED(curvature_centers, current.CurvatureCenterCoords(r.x)));
+				out[0] = centers.first.first;
+				out[1] = centers.first.second;
+				out[2] = centers.second.first;
+				out[3] = centers.second.second;
+				return 4;
+			}
+			case batch::get_trapeze_area:
+				out[0] = std::abs(CURVE_TIMED(area, current.S(r.x, r.x2)));
+				return 1;
+			}
+			return 0;
+		}
+
+		curve::Catenary current;
+		curve::QueryCache* cache;
+	};
+
+	// the next blank-separated token of [p, end) as T, p is moved past it
+	template <typename T>
+	bool token(const char*& p, const char* end, T& value)
+	{
+		while (p != end && (*p == ' ' || *p == '\t')) ++p;
+		const char* first = p;
+		while (p != end && *p != ' ' && *p != '\t') ++p;
+		return sfio::parse(first, p, value) == sfio::parse_result::ok;
+	}
+
+	// record number index, answered with n results, to the verifier if it is due
+	void verify(curve::Verifier* verifier, std::size_t index, const batch::record& r, const double* results, int n)
+	{
+		if (verifier && n && verifier->due(index))
+			verifier->check(static_cast<curve::query>(r.op - batch::get_ordinate), r.a, r.x, r.x2, results);
+	}
+
+	batch::stats run_text(sfio::buffered_reader& in, sfio::buffered_writer& out, curve::QueryCache* cache,
+		curve::Verifier* verifier)
+	{
+		batch::stats s{};
+		evaluator eval(cache);
+		batch::record r{};
+		double results[4];
+		char *begin, *end;
+
+		while (in.line(begin, end))
+		{
+			if (begin == end) continue;
+			++s.records;
+
+			const int n = batch::parse(begin, end, r) ? eval(r, results) : 0;
+			verify(verifier, s.records - 1, r, results, n);
+			if (n == 0)
+			{
+				++s.errors;
+				out.write("nan\n", 4);
+				continue;
+			}
+
+			for (int i = 0; i < n; ++i)
+			{
+				if (i) out.put(' ');
+				out.write(results[i]);
+			}
+			out.put('\n');
+		}
+		return s;
+	}
+
+	batch::stats run_binary(sfio::buffered_reader& in, sfio::buffered_writer& out, curve::QueryCache* cache,
+		curve::Verifier* verifier)
+	{
+		batch::stats s{};
+		evaluator eval(cache);
+		batch::record r;
+		double results[4];
+
+		while (in.read(&r, sizeof(r)))
+		{
+			++s.records;
+
+			int n = eval(r, results);
+			verify(verifier, s.records - 1, r, results, n);
+			if (n == 0)
+			{
+				++s.errors;
+				n = r.op == batch::get_curvature_center_coordinates ? 4 : 1;
+				for (int i = 0; i < n; ++i) results[i] = std::numeric_limits<double>::quiet_NaN();
+			}
+			out.write(reinterpret_cast<const char*>(results), n * sizeof(double));
+		}
+
+		// a truncated last record is an error, answered like any invalid one
+		if (in.pending())
+		{
+			++s.records;
+			++s.errors;
+			const double nan = std::numeric_limits<double>::quiet_NaN();
+			out.write(reinterpret_cast<const char*>(&nan), sizeof(nan));
+		}
+		return s;
+	}
+
+}
+
+bool batch::parse(const char* p, const char* end, record& r)
+{
+	CURVE_PROBE(parse);
+	if (!token(p, end, r.a) || !token(p, end, r.op) || !token(p, end, r.x)) return false;
+	if (r.op == get_trapeze_area && !token(p, end, r.x2)) return false;
+
+	while (p != end && (*p == ' ' || *p == '\t')) ++p;
+	return p == end;
+}
+
+batch::stats batch::run(std::FILE* in, std::FILE* out, format f, curve::QueryCache* cache,
+	curve::Verifier* verifier)
+{
+	sfio::buffered_reader reader(in);
+	sfio::buffered_writer writer(out);
+
+	return f == format::text
+		? run_text(reader, writer, cache, verifier)
+		: run_binary(reader, writer, cache, verifier);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace curve
+{
+	class QueryCache;
+	class Verifier;
+}
+
+// Non-interactive mode: a stream of (a, op, x[, x2]) queries in, results out.
+// op uses the menu numbers of the interactive mode:
+//   2 - ordinate, 3 - arc length, 4 - curvature radius,
+//   5 - curvature center coordinates, 6 - trapeze area over [x, x2].
+// Results match what the menu prints (y, R and S are taken by absolute value).
+namespace batch
+{
+
+	enum op : std::int32_t
+	{
+		get_ordinate = 2,
+		get_arc_length,
+		get_curvature_radius,
+		get_curvature_center_coordinates,
+		get_trapeze_area
+	};
+
+	enum class format
+	{
+		// one record per line: "a op x [x2]", answered by one line of
+		// space separated numbers ("x1 y1 x2 y2" for the centers), "nan" for a bad record
+		text,
+		// packed records in, raw doubles out: four for the centers, one otherwise,
+		// a bad record is answered with NaNs
+		binary
+	};
+
+	struct record
+	{
+		double a;
+		std::int32_t op;
+		std::int32_t reserved;
+		double x, x2;
+	};
+
+	static_assert(sizeof(record) == 32, "binary records are 32 bytes");
+
+	struct stats
+	{
+		std::size_t records, errors;
+	};
+
+	// with a cache, repeated records are answered from it instead of recomputed;
+	// with a verifier, the valid records it finds due (numbered from 0 in input
+	// order, blank lines not counted) are checked against the reference
+	stats run(std::FILE* in, std::FILE* out, format f, curve::QueryCache* cache = nullptr,
+		curve::Verifier* verifier = nullptr);
+
+	// the same output from three stages on their own threads: a reader parsing
+	// chunks of records, workers running the Catenary batch kernels over them
+	// and formatting the results, and the calling thread writing the chunks
+	// back in input order. Results agree with run to the few ulp the batch
+	// kernels differ from the scalar methods.
+	// A verifier checks the same records as in run, on the worker threads.
+	stats run_parallel(std::FILE* in, std::FILE* out, format f, unsigned workers,
+		curve::Verifier* verifier = nullptr);
+
+	// one text record "a op x [x2]" from [p, end), false if malformed
+	bool parse(const char* p, const char* end, record& r);
+
+}
@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "buffered_io.h"
+#include "numeric_io.h"
+#include "Instrument.h"
+
+#include <cstring>
+
+void sfio::buffered_writer::write(const char* p, std::size_t n)
+{
+	if (n > capacity - used)
+	{
+		flush();
+		if (n >= capacity)
+		{
+			std::fwrite(p, 1, n, f);
+			return;
+		}
+	}
+	std::memcpy(buf.data() + used, p, n);
+	used += n;
+}
+
+void sfio::buffered_writer::write(double v)
+{
+	CURVE_PROBE(format);
+	if (capacity - used < max_chars) flush();
+	used = format(buf.data() + used, buf.data() + capacity, v) - buf.data();
+}
+
+void sfio::buffered_writer::write(double v, int precision)
+{
+	CURVE_PROBE(format);
+	if (capacity - used < max_chars) flush();
+	used = format(buf.data() + used, buf.data() + capacity, v, precision) - buf.data();
+}
+
+void sfio::buffered_writer::flush()
+{
+	if (!used) return;
+	CURVE_PROBE(flush);
+	CURVE_COUNT(flush, used);
+	std::fwrite(buf.data(), 1, used, f);
+	used = 0;
+}
+
+bool sfio::read_line(std::FILE* f, std::string& line)
+{
+	CURVE_PROBE(read_line);
+	char chunk[256];
+	line.clear();
+
+	while (std::fgets(chunk, sizeof(chunk), f))
+	{
+		const std::size_t n = std::strlen(chunk);
+		line.append(chunk, n);
+		if (n && chunk[n - 1] == '\n') break;
+	}
+	if (line.empty()) return false;
+
+	if (line.back() == '\n') line.pop_back();
+	if (!line.empty() && line.back() == '\r') line.pop_back();
+	return true;
+}
+
+bool sfio::buffered_reader::refill()
+{
+	if (eof) return false;
+	CURVE_PROBE(refill);
+
+	if (pos)
+	{
+		std::memmove(buf.data(), buf.data() + pos, len - pos);
+		len -= pos;
+		pos = 0;
+	}
+	if (len == buf.size()) buf.resize(buf.size() * 2);
+
+	const std::size_t got = std::fread(buf.data() + len, 1, buf.size() - len, f);
+	if (got == 0) eof = true;
+	CURVE_COUNT(refill, got);
+	len += got;
+	return got != 0;
+}
+
+bool sfio::buffered_reader::line(char*& begin, char*& end)
+{
+	std::size_t scanned = pos;
+
+	for (;;)
+	{
+		void* nl = std::memchr(buf.data() + scanned, '\n', len - scanned);
+		if (nl)
+		{
+			begin = buf.data() + pos;
+			end = static_cast<char*>(nl);
+			pos = end - buf.data() + 1;
+			break;
+		}
+
+		scanned = len - pos;
+		if (!refill())
+		{
+			if (pos == len) return false;
+			// unterminated last line, make room for the '\0'
+			if (len == buf.size()) buf.push_back('\0');
+			begin = buf.data() + pos;
+			end = buf.data() + len;
+			pos = len;
+			break;
+		}
+	}
+
+	if (end != begin && end[-1] == '\r') --end;
+	*end = '\0';
+	return true;
+}
+
+bool sfio::buffered_reader::read(void* dst, std::size_t n)
+{
+	while (len - pos < n)
+		if (!refill()) return false;
+
+	std::memcpy(dst, buf.data() + pos, n);
+	pos += n;
+	return true;
+}
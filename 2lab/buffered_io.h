@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace sfio
+{
+
+	// Output collected in a large buffer and handed to fwrite only when
+	// it fills up (or on flush / destruction), nothing is flushed per line.
+	class buffered_writer
+	{
+	public:
+		static constexpr std::size_t capacity = 1 << 20;
+
+		explicit buffered_writer(std::FILE* f) : f(f), buf(capacity), used(0) {}
+		~buffered_writer() { flush(); }
+
+		buffered_writer(const buffered_writer&) = delete;
+		buffered_writer& operator=(const buffered_writer&) = delete;
+
+		void write(const char* p, std::size_t n);
+		void put(char c)
+		{
+			if (used == capacity) flush();
+			buf[used++] = c;
+		}
+		// shortest form that reads back to the same double
+		void write(double v);
+		// what std::ostream prints with that precision
+		void write(double v, int precision);
+		void flush();
+
+	private:
+		std::FILE* f;
+		std::vector<char> buf;
+		std::size_t used;
+	};
+
+	// one line of f with the '\n' / "\r\n" dropped, false at end of input;
+	// unlike buffered_reader it never waits for more than the current line
+	bool read_line(std::FILE* f, std::string& line);
+
+	// Input read in large blocks, handed out as lines or raw bytes.
+	class buffered_reader
+	{
+	public:
+		static constexpr std::size_t capacity = 1 << 20;
+
+		explicit buffered_reader(std::FILE* f) : f(f), buf(capacity), pos(0), len(0), eof(false) {}
+
+		// next line with the '\n' / "\r\n" replaced by '\0',
+		// the last line may come without a terminator; false at end of input
+		bool line(char*& begin, char*& end);
+		// exactly n bytes, false if the input ends first
+		bool read(void* dst, std::size_t n);
+		// bytes not yet taken; after a failed read, the partial record the
+		// input ended with
+		std::size_t pending() const { return len - pos; }
+
+	private:
+		// keeps the unread tail, appends more input, false if nothing was added
+		bool refill();
+
+		std::FILE* f;
+		std::vector<char> buf;
+		std::size_t pos, len;
+		bool eof;
+	};
+
+}
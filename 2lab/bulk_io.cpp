@@ -0,0 +1,314 @@
+#include "pch.h"
+#include "bulk_io.h"
+#include "batch.h"
+#include "Catenary.h"
+#include "Instrument.h"
+
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+	const char magic[4] = { 'C', 'A', 'T', 'B' };
+
+	std::uint64_t column_stride(std::uint64_t count)
+	{
+		return (count * sizeof(double) + 63) / 64 * 64;
+	}
+
+	[[noreturn]] void fail(const char* what, const char* path)
+	{
+		throw std::runtime_error(std::string(what) + ": " + path);
+	}
+
+	// the widest job, the four columns of curvature centers
+	constexpr std::uint32_t max_columns = 4;
+	// past this count the sizes below no longer fit 64 bits
+	constexpr std::uint64_t max_count = std::uint64_t(1) << 56;
+
+	// bulk::file_size(h), once h is known to give a size at all
+	std::uint64_t checked_size(const bulk::header& h, const char* path)
+	{
+		if (h.columns == 0 || h.columns > max_columns)
+			fail("wrong column count", path);
+		if (h.count > max_count)
+			fail("too many records", path);
+		return bulk::file_size(h);
+	}
+
+}
+
+bulk::header bulk::make_header(double a, std::int32_t op, std::uint32_t columns, std::uint64_t count)
+{
+	header h{};
+	std::memcpy(h.magic, magic, sizeof(magic));
+	h.version = 1;
+	h.a = a;
+	h.op = op;
+	h.columns = columns;
+	h.count = count;
+	return h;
+}
+
+std::uint32_t bulk::input_columns(std::int32_t op)
+{
+	switch (op)
+	{
+	case batch::get_ordinate:
+	case batch::get_arc_length:
+	case batch::get_curvature_radius:
+	case batch::get_curvature_center_coordinates:
+		return 1;
+	case batch::get_trapeze_area:
+		return 2;
+	}
+	return 0;
+}
+
+std::uint32_t bulk::output_columns(std::int32_t op)
+{
+	switch (op)
+	{
+	case batch::get_ordinate:
+	case batch::get_arc_length:
+	case batch::get_curvature_radius:
+	case batch::get_trapeze_area:
+		return 1;
+	case batch::get_curvature_center_coordinates:
+		return 4;
+	}
+	return 0;
+}
+
+std::uint64_t bulk::file_size(const header& h)
+{
+	return sizeof(header) + h.columns * column_stride(h.count);
+}
+
+bulk::mapped_file::mapped_file(const char* path)
+{
+	map(path, false, 0);
+}
+
+bulk::mapped_file::mapped_file(const char* path, std::uint64_t size)
+{
+	map(path, true, size);
+}
+
+#ifdef _WIN32
+
+void bulk::mapped_file::map(const char* path, bool writable, std::uint64_t size)
+{
+	CURVE_PROBE(map);
+	file = mapping = base = nullptr;
+
+	file = CreateFileA(path,
+		writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+		FILE_SHARE_READ, nullptr,
+		writable ? CREATE_ALWAYS : OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) fail("cannot open file", path);
+
+	if (!writable)
+	{
+		LARGE_INTEGER existing;
+		if (!GetFileSizeEx(file, &existing))
+		{
+			CloseHandle(file);
+			fail("cannot read file size", path);
+		}
+		size = static_cast<std::uint64_t>(existing.QuadPart);
+	}
+	length = size;
+	if (length == 0)
+	{
+		CloseHandle(file);
+		fail("empty file", path);
+	}
+
+	// mapping a writable file past its end grows it to that size
+	mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+		static_cast<DWORD>(length >> 32), static_cast<DWORD>(length), nullptr);
+	if (mapping) base = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+	if (!base)
+	{
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		fail("cannot map file", path);
+	}
+}
+
+bool bulk::mapped_file::same_file(const char* path) const
+{
+	// no access rights asked, so the share mode of the open mapping is no obstacle
+	const HANDLE other = CreateFileA(path, 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (other == INVALID_HANDLE_VALUE) return false;
+
+	BY_HANDLE_FILE_INFORMATION mine, theirs;
+	const bool same = GetFileInformationByHandle(file, &mine) && GetFileInformationByHandle(other, &theirs)
+		&& mine.dwVolumeSerialNumber == theirs.dwVolumeSerialNumber
+		&& mine.nFileIndexHigh == theirs.nFileIndexHigh
+		&& mine.nFileIndexLow == theirs.nFileIndexLow;
+	CloseHandle(other);
+	return same;
+}
+
+bulk::mapped_file::~mapped_file()
+{
+	UnmapViewOfFile(base);
+	CloseHandle(mapping);
+	CloseHandle(file);
+}
+
+#else
+
+void bulk::mapped_file::map(const char* path, bool writable, std::uint64_t size)
+{
+	CURVE_PROBE(map);
+	base = nullptr;
+
+	fd = writable ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0644) : open(path, O_RDONLY);
+	if (fd < 0) fail("cannot open file", path);
+
+	if (writable)
+	{
+		if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+		{
+			close(fd);
+			fail("cannot resize file", path);
+		}
+	}
+	else
+	{
+		struct stat st;
+		if (fstat(fd, &st) != 0)
+		{
+			close(fd);
+			fail("cannot read file size", path);
+		}
+		size = static_cast<std::uint64_t>(st.st_size);
+	}
+	length = size;
+	if (length == 0)
+	{
+		close(fd);
+		fail("empty file", path);
+	}
+
+	base = mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED)
+	{
+		close(fd);
+		fail("cannot map file", path);
+	}
+	madvise(base, length, MADV_SEQUENTIAL);
+}
+
+bool bulk::mapped_file::same_file(const char* path) const
+{
+	const int other = open(path, O_RDONLY);
+	if (other < 0) return false;
+
+	struct stat mine, theirs;
+	const bool same = fstat(fd, &mine) == 0 && fstat(other, &theirs) == 0
+		&& mine.st_dev == theirs.st_dev && mine.st_ino == theirs.st_ino;
+	close(other);
+	return same;
+}
+
+bulk::mapped_file::~mapped_file()
+{
+	munmap(base, length);
+	close(fd);
+}
+
+#endif
+
+bulk::reader::reader(const char* path) : file(path)
+{
+	if (file.size() < sizeof(header) || std::memcmp(info().magic, magic, sizeof(magic)) != 0)
+		fail("not a catenary job file", path);
+	if (info().version != 1)
+		fail("unsupported job file version", path);
+	if (info().count > file.size() / sizeof(double) || file.size() < checked_size(info(), path))
+		fail("truncated job file", path);
+}
+
+const double* bulk::reader::column(std::size_t i) const
+{
+	return reinterpret_cast<const double*>(file.data() + sizeof(header) + i * column_stride(info().count));
+}
+
+bulk::writer::writer(const char* path, const header& h) : file(path, checked_size(h, path))
+{
+	std::memcpy(file.data(), &h, sizeof(h));
+}
+
+double* bulk::writer::column(std::size_t i)
+{
+	return reinterpret_cast<double*>(file.data() + sizeof(header) + i * column_stride(info().count));
+}
+
+std::uint64_t bulk::run(const char* input, const char* output)
+{
+	const reader in(input);
+	const header& h = in.info();
+
+	if (input_columns(h.op) == 0 || h.columns != input_columns(h.op))
+		fail("unknown operation or wrong column count", input);
+	const std::optional<curve::Catenary> checked = curve::Catenary::make(h.a);
+	if (!checked)
+		fail("invalid value for 'a'", input);
+	// the writer truncates its file, here while the input is still mapped from it
+	if (in.same_file(output))
+		fail("output is the input file", output);
+
+	writer out(output, make_header(h.a, h.op, output_columns(h.op), h.count));
+	const curve::Catenary c = *checked;
+	const std::size_t n = static_cast<std::size_t>(h.count);
+	double* const result = out.column(0);
+
+	switch (h.op)
+	{
+	case batch::get_ordinate:
+		CURVE_TIMED(ordinate, c.y(in.column(0), result, n));
+		break;
+	case batch::get_arc_length:
+		CURVE_TIMED(arc_length, c.l(in.column(0), result, n));
+		break;
+	case batch::get_curvature_radius:
+		CURVE_TIMED(curvature_radius, c.R(in.column(0), result, n));
+		break;
+	case batch::get_trapeze_area:
+		CURVE_TIMED(area, c.S(in.column(0), in.column(1), result, n));
+		break;
+	case batch::get_curvature_center_coordinates:
+		CURVE_TIMED(curvature_centers, c.CurvatureCenterCoords(in.column(0),
+			curve::coord_view{ out.column(0), out.column(1), n },
+			curve::coord_view{ out.column(2), out.column(3), n }));
+		break;
+	}
+
+	// same absolute values the menu and --batch print
+	if (h.op != batch::get_arc_length && h.op != batch::get_curvature_center_coordinates)
+		for (std::size_t i = 0; i < n; ++i)
+			result[i] = std::abs(result[i]);
+
+	return h.count;
+}
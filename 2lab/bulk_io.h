@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Binary columnar job files for offline runs, read and written through
+// memory mappings so the numbers never pass through a stream.
+//
+// layout: a 64-byte header, then header.columns arrays of header.count
+// doubles, one after another, each starting on a 64-byte boundary.
+//   input:  x (ops 2 - 5), or x1 and x2 (op 6, trapeze area)
+//   output: the result (ops 2 - 4, 6), or x1, y1, x2, y2 (op 5, curvature centers)
+// op uses the batch::op codes, results match the --batch mode.
+namespace bulk
+{
+
+	struct header
+	{
+		char magic[4];			// "CATB"
+		std::uint32_t version;	// 1
+		double a;
+		std::int32_t op;
+		std::uint32_t columns;
+		std::uint64_t count;
+		std::uint8_t reserved[32];
+	};
+
+	static_assert(sizeof(header) == 64, "the header is one cache line");
+
+	header make_header(double a, std::int32_t op, std::uint32_t columns, std::uint64_t count);
+
+	// columns a job with that op reads / writes, 0 for an unknown op
+	std::uint32_t input_columns(std::int32_t op);
+	std::uint32_t output_columns(std::int32_t op);
+
+	class mapped_file
+	{
+	public:
+		// maps an existing file read-only
+		explicit mapped_file(const char* path);
+		// creates (or truncates) the file at exactly size bytes and maps it writable
+		mapped_file(const char* path, std::uint64_t size);
+		~mapped_file();
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		const unsigned char* data() const { return static_cast<const unsigned char*>(base); }
+		unsigned char* data() { return static_cast<unsigned char*>(base); }
+		std::uint64_t size() const { return length; }
+
+		// whether path names the mapped file itself, false if it does not exist
+		bool same_file(const char* path) const;
+
+	private:
+		void map(const char* path, bool writable, std::uint64_t size);
+
+#ifdef _WIN32
+		void* file;
+		void* mapping;
+#else
+		int fd;
+#endif
+		void* base;
+		std::uint64_t length;
+	};
+
+	// read side of a job file, throws std::runtime_error if it is malformed
+	class reader
+	{
+	public:
+		explicit reader(const char* path);
+
+		const header& info() const { return *reinterpret_cast<const header*>(file.data()); }
+		const double* column(std::size_t i) const;
+		bool same_file(const char* path) const { return file.same_file(path); }
+
+	private:
+		mapped_file file;
+	};
+
+	// write side, the whole file is sized and its header filled in up front;
+	// throws std::runtime_error for a header without 1 to 4 columns
+	class writer
+	{
+	public:
+		writer(const char* path, const header& h);
+
+		const header& info() const { return *reinterpret_cast<const header*>(file.data()); }
+		double* column(std::size_t i);
+
+	private:
+		mapped_file file;
+	};
+
+	// bytes a file with that header takes
+	std::uint64_t file_size(const header& h);
+
+	// evaluates the input job into a new output file, returns the number of rows;
+	// refuses an output that is the input, which the writer would truncate under its mapping
+	std::uint64_t run(const char* input, const char* output);
+
+}
@@ -0,0 +1,259 @@
+#include "pch.h"
+#include "hyperbolic.h"
+#include "kernel_table.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CURVE_X86
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CURVE_X86
+#endif
+
+namespace {
+
+	using curve::kernels::table;
+
+	constexpr double log2e = 1.4426950408889634074;
+	constexpr double ln2_hi = 6.93147180369123816490e-01;
+	constexpr double ln2_lo = 1.90821492927058770002e-10;
+	constexpr double ln2 = 0.69314718055994530942;
+
+	// what this CPU and its operating system run
+	struct features {
+		bool sse2 = false, avx2 = false, avx512 = false;
+	};
+
+#if defined(CURVE_X86)
+
+	void cpuid(unsigned leaf, unsigned sub, unsigned (&r)[4]) {
+#if defined(_MSC_VER)
+		int v[4];
+		__cpuidex(v, static_cast<int>(leaf), static_cast<int>(sub));
+		for (int i = 0; i < 4; ++i) r[i] = static_cast<unsigned>(v[i]);
+#else
+		__cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+#endif
+	}
+
+	// the register state the OS saves on a switch, XCR0
+	unsigned long long saved_state() {
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		unsigned lo, hi;
+		__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+		return (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+	}
+
+	// AVX2 counts with FMA, and AVX-512 as F, CD, BW, DQ and VL, all a
+	// compiler may use when told the set; both want the wider registers
+	// saved by the OS as well
+	features detect() {
+		features f;
+		unsigned r[4];
+		cpuid(0, 0, r);
+		const unsigned top = r[0];
+		if (top < 1) return f;
+
+		cpuid(1, 0, r);
+		const unsigned ecx1 = r[2], edx1 = r[3];
+		f.sse2 = (edx1 >> 26) & 1;
+		const bool osxsave = (ecx1 >> 27) & 1, avx = (ecx1 >> 28) & 1, fma = (ecx1 >> 12) & 1;
+		if (!osxsave || !avx || top < 7) return f;
+
+		const unsigned long long xcr0 = saved_state();
+		cpuid(7, 0, r);
+		const unsigned ebx7 = r[1];
+		f.avx2 = (xcr0 & 0x6) == 0x6 && fma && ((ebx7 >> 5) & 1);
+		const unsigned avx512 = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);
+		f.avx512 = f.avx2 && (xcr0 & 0xe6) == 0xe6 && (ebx7 & avx512) == avx512;
+		return f;
+	}
+
+#else
+
+	features detect() {
+		return features();
+	}
+
+#endif
+
+	// the kernels the build has and the CPU runs, best first
+	struct candidates {
+		const table* sets[4];
+		std::size_t count;
+	};
+
+	candidates available() {
+		const features f = detect();
+		candidates c{ {}, 0 };
+		if (curve::kernels::avx512_kernels && f.avx512) c.sets[c.count++] = curve::kernels::avx512_kernels;
+		if (curve::kernels::avx2_kernels && f.avx2) c.sets[c.count++] = curve::kernels::avx2_kernels;
+		if (curve::kernels::sse2_kernels && f.sse2) c.sets[c.count++] = curve::kernels::sse2_kernels;
+		c.sets[c.count++] = &curve::kernels::scalar_kernels;
+		return c;
+	}
+
+	const table* find(const char* name) {
+		const candidates c = available();
+		for (std::size_t i = 0; i < c.count; ++i)
+			if (std::strcmp(c.sets[i]->name, name) == 0) return c.sets[i];
+		return nullptr;
+	}
+
+	// Every kernel is one indirect call through the table in use, loaded
+	// with a plain move. Code that runs before startup() gets the scalar
+	// kernels, which are right, only slower.
+	std::atomic<const table*> current{ &curve::kernels::scalar_kernels };
+
+	inline const table& in_use() {
+		return *current.load(std::memory_order_acquire);
+	}
+
+	// the best set, or the one CATENARY_ISA names
+	bool startup() {
+		const table* chosen = available().sets[0];
+		if (const char* name = std::getenv("CATENARY_ISA")) {
+			if (const table* forced = find(name)) chosen = forced;
+			else std::cerr << "wrong value for 'CATENARY_ISA', the kernels are now '" << chosen->name << "'" << std::endl;
+		}
+		current.store(chosen, std::memory_order_release);
+		return true;
+	}
+
+	const bool started = startup();
+
+}
+
+double curve::kernels::split(double a, double& e) {
+	int k;
+	const double m = std::frexp(a, &k);
+	e = k - 1;
+	return 2 * m;
+}
+
+void curve::kernels::ordinate(double a, const double* xs, double* out, std::size_t n) {
+	in_use().ordinate(a, xs, out, n);
+}
+
+void curve::kernels::arc_length(double a, const double* xs, double* out, std::size_t n) {
+	in_use().arc_length(a, xs, out, n);
+}
+
+void curve::kernels::curvature_radius(double a, const double* xs, double* out, std::size_t n) {
+	in_use().curvature_radius(a, xs, out, n);
+}
+
+void curve::kernels::hyperbolic(double a, const double* xs, double* ch, double* sh, std::size_t n) {
+	in_use().hyperbolic(a, xs, ch, sh, n);
+}
+
+void curve::kernels::area(double a, const double* x1s, const double* x2s, double* out, std::size_t n) {
+	in_use().area(a, x1s, x2s, out, n);
+}
+
+void curve::kernels::log_ordinate(double a, const double* xs, double* out, std::size_t n) {
+	in_use().log_ordinate(a, xs, out, n);
+}
+
+void curve::kernels::log_curvature_radius(double a, const double* xs, double* out, std::size_t n) {
+	in_use().log_curvature_radius(a, xs, out, n);
+}
+
+void curve::kernels::scaled_ordinate(double a, const double* xs, double* ms, double* es, std::size_t n) {
+	in_use().scaled_ordinate(a, xs, ms, es, n);
+}
+
+void curve::kernels::scaled_curvature_radius(double a, const double* xs, double* ms, double* es, std::size_t n) {
+	in_use().scaled_curvature_radius(a, xs, ms, es, n);
+}
+
+void curve::kernels::inverse_ordinate(double a, const double* ys, double* out, std::size_t n) {
+	in_use().inverse_ordinate(a, ys, out, n);
+}
+
+void curve::kernels::inverse_arc_length(double a, const double* ls, double* out, std::size_t n) {
+	in_use().inverse_arc_length(a, ls, out, n);
+}
+
+void curve::kernels::inverse_area(double a, const double* x1s, const double* Ss, double* out, std::size_t n) {
+	in_use().inverse_area(a, x1s, Ss, out, n);
+}
+
+void curve::kernels::ordinate_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+	in_use().ordinate_each(as, inv_as, xs, out, n);
+}
+
+void curve::kernels::arc_length_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+	in_use().arc_length_each(as, inv_as, xs, out, n);
+}
+
+void curve::kernels::curvature_radius_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+	in_use().curvature_radius_each(as, inv_as, xs, out, n);
+}
+
+void curve::kernels::area_each(const double* a2s, const double* inv_as, const double* x1s, const double* x2s,
+	double* out, std::size_t n)
+{
+	in_use().area_each(a2s, inv_as, x1s, x2s, out, n);
+}
+
+void curve::kernels::ordinate(float a, const float* xs, float* out, std::size_t n) {
+	in_use().ordinate_single(a, xs, out, n);
+}
+
+void curve::kernels::arc_length(float a, const float* xs, float* out, std::size_t n) {
+	in_use().arc_length_single(a, xs, out, n);
+}
+
+void curve::kernels::curvature_radius(float a, const float* xs, float* out, std::size_t n) {
+	in_use().curvature_radius_single(a, xs, out, n);
+}
+
+void curve::kernels::area(float a, const float* x1s, const float* x2s, float* out, std::size_t n) {
+	in_use().area_single(a, x1s, x2s, out, n);
+}
+
+bool curve::kernels::magnitude_range(const double* xs, std::size_t n, double& lo, double& hi) {
+	return in_use().magnitude_range(xs, n, lo, hi);
+}
+
+const char* curve::kernels::isa_name() {
+	return in_use().name;
+}
+
+bool curve::kernels::select_isa(const char* name) {
+	const table* chosen = find(name);
+	if (!chosen) return false;
+	current.store(chosen, std::memory_order_release);
+	return true;
+}
+
+double curve::kernels::log_cosh(double u) {
+	const double au = std::abs(u);
+	// below 20 cosh cannot overflow, above it e^-2|u| is under an ulp of 1
+	return au < 20 ? std::log(std::cosh(au)) : au - ln2 + std::log1p(std::exp(-2 * au));
+}
+
+double curve::kernels::scaled_cosh(double u, double& e) {
+	const double au = std::abs(u);
+	if (au < 20) return split(std::cosh(au), e);
+	if (std::isinf(au)) return e = au, 1;
+	if (std::isnan(au)) return e = au;
+
+	// cosh = e^r / 2 * 2^k with r = |u| - k * ln2 in [0, ln2), clamped
+	// for the same reason as in the vector form
+	const double k = std::floor(au * log2e);
+	const double r = std::fmin(std::fmax((au - k * ln2_hi) - k * ln2_lo, 0.0), ln2);
+	const double w = split(std::exp(r), e);
+	e += k - 1;
+	return w;
+}
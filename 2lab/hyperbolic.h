@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+
+namespace curve {
+
+	// Batch kernels behind the span-style Catenary methods.
+	// Every kernel evaluates n abscissae from xs into out (in-place is allowed).
+	namespace kernels {
+
+		void ordinate(double a, const double* xs, double* out, std::size_t n);
+		void arc_length(double a, const double* xs, double* out, std::size_t n);
+		void curvature_radius(double a, const double* xs, double* out, std::size_t n);
+		// ch[i] = cosh(xs[i] / a), sh[i] = sinh(xs[i] / a)
+		void hyperbolic(double a, const double* xs, double* ch, double* sh, std::size_t n);
+		void area(double a, const double* x1s, const double* x2s, double* out, std::size_t n);
+
+		// log domain, finite for every finite x:
+		// out[i] = ln|a * cosh(xs[i] / a)| and ln|a * cosh^2(xs[i] / a)|
+		void log_ordinate(double a, const double* xs, double* out, std::size_t n);
+		void log_curvature_radius(double a, const double* xs, double* out, std::size_t n);
+		// the same two as ms[i] * 2^es[i], |ms[i]| in [1, 2), es[i] integral
+		void scaled_ordinate(double a, const double* xs, double* ms, double* es, std::size_t n);
+		void scaled_curvature_radius(double a, const double* xs, double* ms, double* es, std::size_t n);
+
+		// inverses: out[i] = |a| acosh(ys[i] / a), the root with x >= 0 (NaN if
+		// ys[i] is not on the curve), a asinh(ls[i] / a), and the x2 with
+		// S(x1s[i], x2) = Ss[i]
+		void inverse_ordinate(double a, const double* ys, double* out, std::size_t n);
+		void inverse_arc_length(double a, const double* ls, double* out, std::size_t n);
+		void inverse_area(double a, const double* x1s, const double* Ss, double* out, std::size_t n);
+
+		// one curve per element, given as as[i] with inv_as[i] = 1 / as[i] and
+		// a2s[i] = as[i]^2: out[i] = as[i] * cosh(xs[i] * inv_as[i]), and so on
+		void ordinate_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n);
+		void arc_length_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n);
+		void curvature_radius_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n);
+		void area_each(const double* a2s, const double* inv_as, const double* x1s, const double* x2s,
+			double* out, std::size_t n);
+
+		// single precision ordinate, arc_length, curvature_radius and area,
+		// twice the lanes per vector
+		void ordinate(float a, const float* xs, float* out, std::size_t n);
+		void arc_length(float a, const float* xs, float* out, std::size_t n);
+		void curvature_radius(float a, const float* xs, float* out, std::size_t n);
+		void area(float a, const float* x1s, const float* x2s, float* out, std::size_t n);
+
+		// false if any xs[i] is NaN or infinite, else lo the least nonzero
+		// |xs[i]| (0 if there is none) and hi the greatest
+		bool magnitude_range(const double* xs, std::size_t n, double& lo, double& hi);
+
+		// scalar forms: ln cosh(u), and cosh(u) = m * 2^e with m returned
+		double log_cosh(double u);
+		double scaled_cosh(double u, double& e);
+
+		// The kernels come in scalar, sse2, avx2 and avx512 builds in one
+		// binary; at startup they switch to the best the CPU runs, or to the
+		// one the environment variable CATENARY_ISA names.
+		// name of the instruction set the kernels run on
+		const char* isa_name();
+		// switches every kernel to the named set, false (and no switch) if
+		// the build or the CPU lacks it
+		bool select_isa(const char* name);
+
+	}
+
+}
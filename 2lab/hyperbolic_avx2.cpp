@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "kernel_table.h"
+
+#if defined(__AVX2__)
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace {
+
+	constexpr double two52 = 4503599627370496.0;
+	constexpr float two23 = 8388608.0f;
+
+	struct isa {
+		typedef double scalar;
+		typedef __m256d reg;
+		typedef __m256d mask;
+		static constexpr std::size_t width = 4;
+		static constexpr const char* name() { return "avx2"; }
+
+		static reg load(const double* p) { return _mm256_loadu_pd(p); }
+		static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+		static reg set1(double v) { return _mm256_set1_pd(v); }
+		static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+		static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+		static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+		static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+		static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+		static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+		static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+		static reg fnma(reg a, reg b, reg c) { return _mm256_fnmadd_pd(a, b, c); }
+		static reg abs(reg v) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); }
+		static reg round(reg v) { return _mm256_round_pd(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		static reg floor(reg v) { return _mm256_floor_pd(v); }
+		static reg sqrt(reg v) { return _mm256_sqrt_pd(v); }
+		static void split(reg v, reg& m, reg& e) {
+			const __m256i bits = _mm256_castpd_si256(v);
+			m = _mm256_castsi256_pd(_mm256_or_si256(
+				_mm256_and_si256(bits, _mm256_set1_epi64x(0x000fffffffffffffLL)),
+				_mm256_set1_epi64x(0x3ff0000000000000LL)));
+			// the biased exponent dropped into the mantissa of 2^52
+			const __m256i biased = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(_mm256_set1_pd(two52)));
+			e = _mm256_sub_pd(_mm256_castsi256_pd(biased), _mm256_set1_pd(two52 + 1023));
+		}
+		static reg pow2(reg k) {
+			const __m256i bits = _mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(two52 + 1023)));
+			return _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52));
+		}
+		static reg copysign(reg mag, reg sgn) {
+			const __m256d sign = _mm256_set1_pd(-0.0);
+			return _mm256_or_pd(_mm256_andnot_pd(sign, mag), _mm256_and_pd(sign, sgn));
+		}
+		static mask lt(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+		static mask unord(reg v) { return _mm256_cmp_pd(v, v, _CMP_UNORD_Q); }
+		static reg select(mask m, reg t, reg f) { return _mm256_blendv_pd(f, t, m); }
+	};
+
+	// the float lanes of the same registers, twice as many per instruction
+	struct isa_single {
+		typedef float scalar;
+		typedef __m256 reg;
+		typedef __m256 mask;
+		static constexpr std::size_t width = 8;
+
+		static reg load(const float* p) { return _mm256_loadu_ps(p); }
+		static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+		static reg set1(float v) { return _mm256_set1_ps(v); }
+		static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+		static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+		static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+		static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+		static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+		static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+		static reg fnma(reg a, reg b, reg c) { return _mm256_fnmadd_ps(a, b, c); }
+		static reg abs(reg v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+		static reg round(reg v) { return _mm256_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		static reg floor(reg v) { return _mm256_floor_ps(v); }
+		static reg pow2(reg k) {
+			const __m256i bits = _mm256_castps_si256(_mm256_add_ps(k, _mm256_set1_ps(two23 + 127)));
+			return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 23));
+		}
+		static reg copysign(reg mag, reg sgn) {
+			const __m256 sign = _mm256_set1_ps(-0.0f);
+			return _mm256_or_ps(_mm256_andnot_ps(sign, mag), _mm256_and_ps(sign, sgn));
+		}
+		static mask lt(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static mask unord(reg v) { return _mm256_cmp_ps(v, v, _CMP_UNORD_Q); }
+		static reg select(mask m, reg t, reg f) { return _mm256_blendv_ps(f, t, m); }
+	};
+
+}
+
+#include "hyperbolic_simd.h"
+
+const curve::kernels::table* const curve::kernels::avx2_kernels = &vector_kernels;
+
+#else
+
+const curve::kernels::table* const curve::kernels::avx2_kernels = nullptr;
+
+#endif
@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "kernel_table.h"
+
+#if defined(__AVX512F__)
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace {
+
+	constexpr double two52 = 4503599627370496.0;
+	constexpr float two23 = 8388608.0f;
+
+	struct isa {
+		typedef double scalar;
+		typedef __m512d reg;
+		typedef __mmask8 mask;
+		static constexpr std::size_t width = 8;
+		static constexpr const char* name() { return "avx512"; }
+
+		static reg load(const double* p) { return _mm512_loadu_pd(p); }
+		static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+		static reg set1(double v) { return _mm512_set1_pd(v); }
+		static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+		static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+		static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+		static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+		static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+		static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+		static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+		static reg fnma(reg a, reg b, reg c) { return _mm512_fnmadd_pd(a, b, c); }
+		static reg abs(reg v) { return _mm512_abs_pd(v); }
+		static reg round(reg v) { return _mm512_roundscale_pd(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		static reg floor(reg v) { return _mm512_roundscale_pd(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+		static reg sqrt(reg v) { return _mm512_sqrt_pd(v); }
+		// v = m * 2^e with m in [1, 2), for positive normal v
+		static void split(reg v, reg& m, reg& e) {
+			m = _mm512_getmant_pd(v, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero);
+			e = _mm512_getexp_pd(v);
+		}
+		static reg pow2(reg k) {
+			const __m512i bits = _mm512_castpd_si512(_mm512_add_pd(k, _mm512_set1_pd(two52 + 1023)));
+			return _mm512_castsi512_pd(_mm512_slli_epi64(bits, 52));
+		}
+		static reg copysign(reg mag, reg sgn) {
+			const __m512i sign = _mm512_set1_epi64(INT64_MIN);
+			return _mm512_castsi512_pd(_mm512_or_si512(
+				_mm512_andnot_si512(sign, _mm512_castpd_si512(mag)),
+				_mm512_and_si512(sign, _mm512_castpd_si512(sgn))));
+		}
+		static mask lt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+		static mask unord(reg v) { return _mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q); }
+		static reg select(mask m, reg t, reg f) { return _mm512_mask_blend_pd(m, f, t); }
+	};
+
+	// the float lanes of the same registers, twice as many per instruction
+	struct isa_single {
+		typedef float scalar;
+		typedef __m512 reg;
+		typedef __mmask16 mask;
+		static constexpr std::size_t width = 16;
+
+		static reg load(const float* p) { return _mm512_loadu_ps(p); }
+		static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+		static reg set1(float v) { return _mm512_set1_ps(v); }
+		static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+		static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+		static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+		static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+		static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+		static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+		static reg fnma(reg a, reg b, reg c) { return _mm512_fnmadd_ps(a, b, c); }
+		static reg abs(reg v) { return _mm512_abs_ps(v); }
+		static reg round(reg v) { return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		static reg floor(reg v) { return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+		static reg pow2(reg k) {
+			const __m512i bits = _mm512_castps_si512(_mm512_add_ps(k, _mm512_set1_ps(two23 + 127)));
+			return _mm512_castsi512_ps(_mm512_slli_epi32(bits, 23));
+		}
+		static reg copysign(reg mag, reg sgn) {
+			const __m512i sign = _mm512_set1_epi32(INT32_MIN);
+			return _mm512_castsi512_ps(_mm512_or_si512(
+				_mm512_andnot_si512(sign, _mm512_castps_si512(mag)),
+				_mm512_and_si512(sign, _mm512_castps_si512(sgn))));
+		}
+		static mask lt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+		static mask unord(reg v) { return _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q); }
+		static reg select(mask m, reg t, reg f) { return _mm512_mask_blend_ps(m, f, t); }
+	};
+
+}
+
+#include "hyperbolic_simd.h"
+
+const curve::kernels::table* const curve::kernels::avx512_kernels = &vector_kernels;
+
+#else
+
+const curve::kernels::table* const curve::kernels::avx512_kernels = nullptr;
+
+#endif
@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "hyperbolic.h"
+#include "kernel_table.h"
+
+#include <cmath>
+
+namespace {
+
+	using curve::kernels::log_cosh;
+	using curve::kernels::scaled_cosh;
+	using curve::kernels::split;
+
+	void ordinate(double a, const double* xs, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = a * cosh(xs[i] / a);
+	}
+
+	void arc_length(double a, const double* xs, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = a * sinh(xs[i] / a);
+	}
+
+	void curvature_radius(double a, const double* xs, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = a * pow(cosh(xs[i] / a), 2);
+	}
+
+	void hyperbolic(double a, const double* xs, double* ch, double* sh, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) {
+			ch[i] = cosh(xs[i] / a);
+			sh[i] = sinh(xs[i] / a);
+		}
+	}
+
+	void area(double a, const double* x1s, const double* x2s, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = pow(a, 2) * (sinh(x2s[i] / a) - sinh(x1s[i] / a));
+	}
+
+	void log_ordinate(double a, const double* xs, double* out, std::size_t n) {
+		const double log_a = std::log(std::abs(a));
+		for (std::size_t i = 0; i < n; ++i) out[i] = log_a + log_cosh(xs[i] / a);
+	}
+
+	void log_curvature_radius(double a, const double* xs, double* out, std::size_t n) {
+		const double log_a = std::log(std::abs(a));
+		for (std::size_t i = 0; i < n; ++i) out[i] = log_a + 2 * log_cosh(xs[i] / a);
+	}
+
+	void scaled_ordinate(double a, const double* xs, double* ms, double* es, std::size_t n) {
+		double ea, e;
+		const double ma = split(a, ea);
+		for (std::size_t i = 0; i < n; ++i) {
+			const double m = scaled_cosh(xs[i] / a, e) * ma;
+			ms[i] = split(m, es[i]);
+			es[i] += e + ea;
+		}
+	}
+
+	void scaled_curvature_radius(double a, const double* xs, double* ms, double* es, std::size_t n) {
+		double ea, e;
+		const double ma = split(a, ea);
+		for (std::size_t i = 0; i < n; ++i) {
+			const double w = scaled_cosh(xs[i] / a, e);
+			ms[i] = split(w * w * ma, es[i]);
+			es[i] += 2 * e + ea;
+		}
+	}
+
+	void inverse_ordinate(double a, const double* ys, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = std::abs(a) * std::acosh(ys[i] / a);
+	}
+
+	void inverse_arc_length(double a, const double* ls, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = a * std::asinh(ls[i] / a);
+	}
+
+	void inverse_area(double a, const double* x1s, const double* Ss, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = a * std::asinh(Ss[i] / (a * a) + std::sinh(x1s[i] / a));
+	}
+
+	void ordinate_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = as[i] * cosh(xs[i] * inv_as[i]);
+	}
+
+	void arc_length_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = as[i] * sinh(xs[i] * inv_as[i]);
+	}
+
+	void curvature_radius_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = as[i] * pow(cosh(xs[i] * inv_as[i]), 2);
+	}
+
+	void area_each(const double* a2s, const double* inv_as, const double* x1s, const double* x2s,
+		double* out, std::size_t n)
+	{
+		for (std::size_t i = 0; i < n; ++i) out[i] = a2s[i] * (sinh(x2s[i] * inv_as[i]) - sinh(x1s[i] * inv_as[i]));
+	}
+
+	void ordinate(float a, const float* xs, float* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = a * std::cosh(xs[i] / a);
+	}
+
+	void arc_length(float a, const float* xs, float* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = a * std::sinh(xs[i] / a);
+	}
+
+	void curvature_radius(float a, const float* xs, float* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) {
+			const float ch = std::cosh(xs[i] / a);
+			out[i] = a * ch * ch;
+		}
+	}
+
+	void area(float a, const float* x1s, const float* x2s, float* out, std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i) out[i] = a * a * (std::sinh(x2s[i] / a) - std::sinh(x1s[i] / a));
+	}
+
+	bool magnitude_range(const double* xs, std::size_t n, double& lo, double& hi) {
+		double finite = 0;
+		lo = INFINITY, hi = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			const double ax = std::abs(xs[i]);
+			hi = ax > hi ? ax : hi;
+			lo = ax < lo && ax != 0 ? ax : lo;
+			finite += ax * 0;
+		}
+		if (lo == INFINITY) lo = 0;
+		return finite == 0;
+	}
+
+	constexpr curve::kernels::table scalar = {
+		"scalar",
+		ordinate, arc_length, curvature_radius, hyperbolic, area,
+		log_ordinate, log_curvature_radius, scaled_ordinate, scaled_curvature_radius,
+		inverse_ordinate, inverse_arc_length, inverse_area,
+		ordinate_each, arc_length_each, curvature_radius_each, area_each,
+		ordinate, arc_length, curvature_radius, area,
+		magnitude_range
+	};
+
+}
+
+// the names in an initializer here would find the forwarding functions of
+// hyperbolic.h first, hence the copy
+const curve::kernels::table curve::kernels::scalar_kernels = scalar;
@@ -0,0 +1,632 @@
+#pragma once
+
+// The vector kernels, written once against the register types isa (double
+// lanes) and isa_single (float lanes). Each instruction set's translation
+// unit defines those two and includes this; every function lands in its
+// anonymous namespace, built for that set alone. Nothing here calls an
+// inline library function, whose one out of line copy the linker might
+// take from a translation unit built for a wider set.
+
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "kernel_table.h"
+
+namespace {
+
+	using curve::kernels::split;
+
+	// cosh/sinh are built from e^|u| / 2 = p(r) * 2^(n - 1), where
+	// |u| = n * ln2 + r and p is the Taylor polynomial of e^r on |r| <= ln2 / 2.
+	// 2^(n - 1) is applied as two factors so the scale itself never overflows,
+	// the product does, which gives the same +-INFINITY as libm.
+
+	constexpr double log2e = 1.4426950408889634074;
+	constexpr double ln2_hi = 6.93147180369123816490e-01;
+	constexpr double ln2_lo = 1.90821492927058770002e-10;
+	constexpr double u_clamp = 711.0;
+
+	constexpr double exp_coeffs[] = {
+		1.0 / 6227020800.0,	// 1/13!
+		1.0 / 479001600.0,
+		1.0 / 39916800.0,
+		1.0 / 3628800.0,
+		1.0 / 362880.0,
+		1.0 / 40320.0,
+		1.0 / 5040.0,
+		1.0 / 720.0,
+		1.0 / 120.0,
+		1.0 / 24.0,
+		1.0 / 6.0,
+		1.0 / 2.0,
+		1.0,
+		1.0
+	};
+
+	// odd series of sinh(u) / u in u^2, used for |u| < 1 where
+	// e^u / 2 - e^-u / 2 cancels
+	constexpr double sinh_coeffs[] = {
+		1.0 / 355687428096000.0,	// 1/17!
+		1.0 / 1307674368000.0,
+		1.0 / 6227020800.0,
+		1.0 / 39916800.0,
+		1.0 / 362880.0,
+		1.0 / 5040.0,
+		1.0 / 120.0,
+		1.0 / 6.0,
+		1.0
+	};
+
+	// single precision: the same scheme with float constants, ln2 split so
+	// n * ln2_hi_f stays exact for |n| < 2^8, the clamp just past the float
+	// overflow of cosh, and both series cut at the last term above float eps
+	constexpr float ln2_hi_f = 0.693359375f;
+	constexpr float ln2_lo_f = -2.12194440e-4f;
+	constexpr float u_clamp_f = 90.0f;
+
+	constexpr float exp_coeffs_f[] = {
+		1.0f / 40320,	// 1/8!
+		1.0f / 5040,
+		1.0f / 720,
+		1.0f / 120,
+		1.0f / 24,
+		1.0f / 6,
+		1.0f / 2,
+		1.0f,
+		1.0f
+	};
+
+	constexpr float sinh_coeffs_f[] = {
+		1.0f / 39916800,	// 1/11!
+		1.0f / 362880,
+		1.0f / 5040,
+		1.0f / 120,
+		1.0f / 6,
+		1.0f
+	};
+
+	// 2 atanh(s) / s as a series in s^2: 2 / (2j + 1), down to j = 0
+	constexpr double atanh_coeffs[] = {
+		2.0 / 23, 2.0 / 21, 2.0 / 19, 2.0 / 17, 2.0 / 15, 2.0 / 13,
+		2.0 / 11, 2.0 / 9, 2.0 / 7, 2.0 / 5, 2.0 / 3, 2.0
+	};
+
+	constexpr double sqrt2 = 1.41421356237309504880;
+	constexpr double ln2 = 0.69314718055994530942;
+	constexpr double asymptotic = 67108864.0; // 2^26
+
+	template <class V>
+	inline void cosh_sinh(typename V::reg u, typename V::reg& ch, typename V::reg& sh)
+	{
+		typedef typename V::reg reg;
+
+		const reg au = V::abs(u);
+		const reg cu = V::min(au, V::set1(u_clamp));
+
+		const reg n = V::round(V::mul(cu, V::set1(log2e)));
+		reg r = V::fnma(n, V::set1(ln2_hi), cu);
+		r = V::fnma(n, V::set1(ln2_lo), r);
+
+		reg p = V::set1(exp_coeffs[0]);
+		for (std::size_t i = 1; i < sizeof(exp_coeffs) / sizeof(*exp_coeffs); ++i)
+			p = V::fma(p, r, V::set1(exp_coeffs[i]));
+
+		const reg m = V::sub(n, V::set1(1.0));
+		const reg m1 = V::floor(V::mul(m, V::set1(0.5)));
+		const reg m2 = V::sub(m, m1);
+		const reg h = V::mul(V::mul(p, V::pow2(m1)), V::pow2(m2));
+		const reg q = V::div(V::set1(0.25), h);
+
+		const reg u2 = V::mul(u, u);
+		reg s = V::set1(sinh_coeffs[0]);
+		for (std::size_t i = 1; i < sizeof(sinh_coeffs) / sizeof(*sinh_coeffs); ++i)
+			s = V::fma(s, u2, V::set1(sinh_coeffs[i]));
+		s = V::mul(s, u);
+
+		const typename V::mask nan = V::unord(u);
+		ch = V::select(nan, u, V::add(h, q));
+		sh = V::select(nan, u,
+			V::select(V::lt(au, V::set1(1.0)), s, V::copysign(V::sub(h, q), u)));
+	}
+
+	// cosh_sinh for a single precision V
+	template <class V>
+	inline void cosh_sinh_single(typename V::reg u, typename V::reg& ch, typename V::reg& sh)
+	{
+		typedef typename V::reg reg;
+
+		const reg au = V::abs(u);
+		const reg cu = V::min(au, V::set1(u_clamp_f));
+
+		const reg n = V::round(V::mul(cu, V::set1(static_cast<float>(log2e))));
+		reg r = V::fnma(n, V::set1(ln2_hi_f), cu);
+		r = V::fnma(n, V::set1(ln2_lo_f), r);
+
+		reg p = V::set1(exp_coeffs_f[0]);
+		for (std::size_t i = 1; i < sizeof(exp_coeffs_f) / sizeof(*exp_coeffs_f); ++i)
+			p = V::fma(p, r, V::set1(exp_coeffs_f[i]));
+
+		const reg m = V::sub(n, V::set1(1.0f));
+		const reg m1 = V::floor(V::mul(m, V::set1(0.5f)));
+		const reg m2 = V::sub(m, m1);
+		const reg h = V::mul(V::mul(p, V::pow2(m1)), V::pow2(m2));
+		const reg q = V::div(V::set1(0.25f), h);
+
+		const reg u2 = V::mul(u, u);
+		reg s = V::set1(sinh_coeffs_f[0]);
+		for (std::size_t i = 1; i < sizeof(sinh_coeffs_f) / sizeof(*sinh_coeffs_f); ++i)
+			s = V::fma(s, u2, V::set1(sinh_coeffs_f[i]));
+		s = V::mul(s, u);
+
+		const typename V::mask nan = V::unord(u);
+		ch = V::select(nan, u, V::add(h, q));
+		sh = V::select(nan, u,
+			V::select(V::lt(au, V::set1(1.0f)), s, V::copysign(V::sub(h, q), u)));
+	}
+
+	// cosh(u) = w * 2^e with w in [1, 2) and e integral. The exponent is kept
+	// apart, so nothing overflows: cosh = 2^(n - 1) * (p + 2^(-2n) / p).
+	// Past |u| ~ 1.4e6 n * ln2_hi is no longer exact, r is clamped so w stays
+	// in range; by then x / a has lost more bits than the reduction does.
+	template <class V>
+	inline void cosh_scaled(typename V::reg u, typename V::reg& w, typename V::reg& e)
+	{
+		typedef typename V::reg reg;
+
+		const reg one = V::set1(1.0), two = V::set1(2.0);
+		const reg au = V::abs(u);
+
+		const reg n = V::round(V::mul(au, V::set1(log2e)));
+		reg r = V::fnma(n, V::set1(ln2_hi), au);
+		r = V::fnma(n, V::set1(ln2_lo), r);
+		r = V::min(V::max(r, V::set1(-0.35)), V::set1(0.35));
+
+		reg p = V::set1(exp_coeffs[0]);
+		for (std::size_t i = 1; i < sizeof(exp_coeffs) / sizeof(*exp_coeffs); ++i)
+			p = V::fma(p, r, V::set1(exp_coeffs[i]));
+
+		// 2^(-2n) as a square; stopping at 2^-1000 keeps t^2 / p normal,
+		// subnormals would stall the pipeline and are below an ulp of p anyway
+		const reg t = V::pow2(V::sub(V::set1(0.0), V::min(n, V::set1(500.0))));
+		const reg w0 = V::add(p, V::div(V::mul(t, t), p));
+		const reg e0 = V::sub(n, one);
+
+		// w0 is in [0.7, 2.2)
+		const typename V::mask low = V::lt(w0, one), fits = V::lt(w0, two);
+		w = V::select(low, V::add(w0, w0), V::select(fits, w0, V::mul(w0, V::set1(0.5))));
+		e = V::select(low, V::sub(e0, one), V::select(fits, e0, V::add(e0, one)));
+
+		const typename V::mask inf = V::lt(V::set1(DBL_MAX), au), nan = V::unord(u);
+		w = V::select(nan, u, V::select(inf, one, w));
+		e = V::select(nan, u, V::select(inf, au, e));
+	}
+
+	// m * 2^e with |m| in [1, 4) brought back to [1, 2)
+	template <class V>
+	inline void normalize(typename V::reg& m, typename V::reg& e)
+	{
+		const typename V::mask fits = V::lt(V::abs(m), V::set1(2.0));
+		m = V::select(fits, m, V::mul(m, V::set1(0.5)));
+		e = V::select(fits, e, V::add(e, V::set1(1.0)));
+	}
+
+	// ln(w * 2^e) for w in [1, 2): ln w = 2 atanh(s), s = (w - 1) / (w + 1),
+	// after w is moved to [sqrt(1/2), sqrt(2)] so |s| <= 0.172
+	template <class V>
+	inline typename V::reg log_scaled(typename V::reg w, typename V::reg e)
+	{
+		typedef typename V::reg reg;
+
+		const reg one = V::set1(1.0);
+		const typename V::mask high = V::lt(V::set1(sqrt2), w);
+		const reg m = V::select(high, V::mul(w, V::set1(0.5)), w);
+		const reg k = V::select(high, V::add(e, one), e);
+
+		const reg s = V::div(V::sub(m, one), V::add(m, one));
+		const reg s2 = V::mul(s, s);
+		reg q = V::set1(atanh_coeffs[0]);
+		for (std::size_t i = 1; i < sizeof(atanh_coeffs) / sizeof(*atanh_coeffs); ++i)
+			q = V::fma(q, s2, V::set1(atanh_coeffs[i]));
+
+		return V::fma(k, V::set1(ln2_hi), V::fma(k, V::set1(ln2_lo), V::mul(s, q)));
+	}
+
+	// ln v for finite v >= 1
+	template <class V>
+	inline typename V::reg log_normal(typename V::reg v)
+	{
+		typename V::reg m, e;
+		V::split(v, m, e);
+		return log_scaled<V>(m, e);
+	}
+
+	// ln(1 + z) for z >= 0, the rounding of w = 1 + z is put back as (z - (w - 1)) / w
+	template <class V>
+	inline typename V::reg log1p_positive(typename V::reg z)
+	{
+		const typename V::reg one = V::set1(1.0), w = V::add(one, z);
+		return V::add(log_normal<V>(w), V::div(V::sub(z, V::sub(w, one)), w));
+	}
+
+	// acosh(v) = ln(1 + d + sqrt(d (2 + d))), d = v - 1 exact near the vertex;
+	// past 2^26, sqrt(v^2 - 1) rounds to v and it is ln v + ln 2
+	template <class V>
+	inline typename V::reg arcosh(typename V::reg v)
+	{
+		typedef typename V::reg reg;
+
+		const reg one = V::set1(1.0), d = V::sub(v, one);
+		const reg near = log1p_positive<V>(V::add(d, V::sqrt(V::mul(d, V::add(V::set1(2.0), d)))));
+		const reg far = V::add(log_normal<V>(V::min(v, V::set1(DBL_MAX))), V::set1(ln2));
+
+		const reg r = V::select(V::lt(v, V::set1(asymptotic)), near, far);
+		return V::select(V::unord(v), v,
+			V::select(V::lt(v, one), V::set1(NAN),
+				V::select(V::lt(V::set1(DBL_MAX), v), v, r)));
+	}
+
+	// asinh(v) = ln(1 + |v| + v^2 / (1 + sqrt(1 + v^2))) with the sign of v
+	template <class V>
+	inline typename V::reg arsinh(typename V::reg v)
+	{
+		typedef typename V::reg reg;
+
+		const reg one = V::set1(1.0), av = V::abs(v), v2 = V::mul(av, av);
+		const reg near = log1p_positive<V>(V::add(av, V::div(v2, V::add(one, V::sqrt(V::add(one, v2))))));
+		const reg far = V::add(log_normal<V>(V::min(av, V::set1(DBL_MAX))), V::set1(ln2));
+
+		const reg r = V::select(V::lt(av, V::set1(asymptotic)), near, far);
+		return V::select(V::unord(v), v,
+			V::copysign(V::select(V::lt(V::set1(DBL_MAX), av), av, r), v));
+	}
+
+	// Runs op over full vectors, the tail goes through a zero-padded
+	// register so every element sees the same code path.
+	template <class V = isa, class Op>
+	inline void apply(const typename V::scalar* xs, typename V::scalar* out, std::size_t n, Op op)
+	{
+		std::size_t i = 0;
+		for (; i + V::width <= n; i += V::width)
+			V::store(out + i, op(V::load(xs + i)));
+
+		if (i < n) {
+			typename V::scalar tail[V::width] = {};
+			for (std::size_t j = 0; i + j < n; ++j) tail[j] = xs[i + j];
+			V::store(tail, op(V::load(tail)));
+			for (std::size_t j = 0; i + j < n; ++j) out[i + j] = tail[j];
+		}
+	}
+
+	// apply for a kernel with two outputs, op(x, first, second)
+	template <class Op>
+	inline void apply2(const double* xs, double* first, double* second, std::size_t n, Op op)
+	{
+		std::size_t i = 0;
+		isa::reg f, s;
+		for (; i + isa::width <= n; i += isa::width) {
+			op(isa::load(xs + i), f, s);
+			isa::store(first + i, f);
+			isa::store(second + i, s);
+		}
+
+		if (i < n) {
+			double t1[isa::width] = {}, t2[isa::width];
+			for (std::size_t j = 0; i + j < n; ++j) t1[j] = xs[i + j];
+			op(isa::load(t1), f, s);
+			isa::store(t1, f);
+			isa::store(t2, s);
+			for (std::size_t j = 0; i + j < n; ++j) first[i + j] = t1[j], second[i + j] = t2[j];
+		}
+	}
+
+	// apply over K inputs read in step, op(v) gets v[k] loaded from in[k] + i
+	template <std::size_t K, class Op>
+	inline void zip(const double* const (&in)[K], double* out, std::size_t n, Op op)
+	{
+		isa::reg v[K];
+		std::size_t i = 0;
+		for (; i + isa::width <= n; i += isa::width) {
+			for (std::size_t k = 0; k < K; ++k) v[k] = isa::load(in[k] + i);
+			isa::store(out + i, op(v));
+		}
+
+		if (i < n) {
+			double tail[K][isa::width] = {};
+			for (std::size_t k = 0; k < K; ++k) {
+				for (std::size_t j = 0; i + j < n; ++j) tail[k][j] = in[k][i + j];
+				v[k] = isa::load(tail[k]);
+			}
+			isa::store(tail[0], op(v));
+			for (std::size_t j = 0; i + j < n; ++j) out[i + j] = tail[0][j];
+		}
+	}
+
+	void ordinate(double a, const double* xs, double* out, std::size_t n) {
+		const isa::reg va = isa::set1(a);
+		apply(xs, out, n, [va](isa::reg x) {
+			isa::reg ch, sh;
+			cosh_sinh<isa>(isa::div(x, va), ch, sh);
+			return isa::mul(va, ch);
+		});
+	}
+
+	void arc_length(double a, const double* xs, double* out, std::size_t n) {
+		const isa::reg va = isa::set1(a);
+		apply(xs, out, n, [va](isa::reg x) {
+			isa::reg ch, sh;
+			cosh_sinh<isa>(isa::div(x, va), ch, sh);
+			return isa::mul(va, sh);
+		});
+	}
+
+	void curvature_radius(double a, const double* xs, double* out, std::size_t n) {
+		const isa::reg va = isa::set1(a);
+		apply(xs, out, n, [va](isa::reg x) {
+			isa::reg ch, sh;
+			cosh_sinh<isa>(isa::div(x, va), ch, sh);
+			return isa::mul(va, isa::mul(ch, ch));
+		});
+	}
+
+	void hyperbolic(double a, const double* xs, double* ch, double* sh, std::size_t n) {
+		const isa::reg va = isa::set1(a);
+		std::size_t i = 0;
+		isa::reg vc, vs;
+
+		for (; i + isa::width <= n; i += isa::width) {
+			cosh_sinh<isa>(isa::div(isa::load(xs + i), va), vc, vs);
+			isa::store(ch + i, vc);
+			isa::store(sh + i, vs);
+		}
+
+		if (i < n) {
+			double tc[isa::width] = {}, ts[isa::width];
+			for (std::size_t j = 0; i + j < n; ++j) tc[j] = xs[i + j];
+			cosh_sinh<isa>(isa::div(isa::load(tc), va), vc, vs);
+			isa::store(tc, vc);
+			isa::store(ts, vs);
+			for (std::size_t j = 0; i + j < n; ++j) ch[i + j] = tc[j], sh[i + j] = ts[j];
+		}
+	}
+
+	void area(double a, const double* x1s, const double* x2s, double* out, std::size_t n) {
+		const isa::reg va = isa::set1(a),
+			va2 = isa::set1(a * a);
+		std::size_t i = 0;
+		isa::reg ch, sh1, sh2;
+
+		for (; i + isa::width <= n; i += isa::width) {
+			cosh_sinh<isa>(isa::div(isa::load(x1s + i), va), ch, sh1);
+			cosh_sinh<isa>(isa::div(isa::load(x2s + i), va), ch, sh2);
+			isa::store(out + i, isa::mul(va2, isa::sub(sh2, sh1)));
+		}
+
+		if (i < n) {
+			double t1[isa::width] = {}, t2[isa::width] = {};
+			for (std::size_t j = 0; i + j < n; ++j) t1[j] = x1s[i + j], t2[j] = x2s[i + j];
+			cosh_sinh<isa>(isa::div(isa::load(t1), va), ch, sh1);
+			cosh_sinh<isa>(isa::div(isa::load(t2), va), ch, sh2);
+			isa::store(t1, isa::mul(va2, isa::sub(sh2, sh1)));
+			for (std::size_t j = 0; i + j < n; ++j) out[i + j] = t1[j];
+		}
+	}
+
+	void log_ordinate(double a, const double* xs, double* out, std::size_t n) {
+		const isa::reg va = isa::set1(a), log_a = isa::set1(std::log(std::fabs(a)));
+		apply(xs, out, n, [va, log_a](isa::reg x) {
+			isa::reg w, e;
+			cosh_scaled<isa>(isa::div(x, va), w, e);
+			return isa::add(log_a, log_scaled<isa>(w, e));
+		});
+	}
+
+	void log_curvature_radius(double a, const double* xs, double* out, std::size_t n) {
+		const isa::reg va = isa::set1(a), log_a = isa::set1(std::log(std::fabs(a)));
+		apply(xs, out, n, [va, log_a](isa::reg x) {
+			isa::reg w, e;
+			cosh_scaled<isa>(isa::div(x, va), w, e);
+			const isa::reg l = log_scaled<isa>(w, e);
+			return isa::add(log_a, isa::add(l, l));
+		});
+	}
+
+	void scaled_ordinate(double a, const double* xs, double* ms, double* es, std::size_t n) {
+		double ea;
+		const isa::reg va = isa::set1(a), vm = isa::set1(split(a, ea)), ve = isa::set1(ea);
+		apply2(xs, ms, es, n, [va, vm, ve](isa::reg x, isa::reg& m, isa::reg& e) {
+			cosh_scaled<isa>(isa::div(x, va), m, e);
+			m = isa::mul(m, vm);
+			e = isa::add(e, ve);
+			normalize<isa>(m, e);
+		});
+	}
+
+	void scaled_curvature_radius(double a, const double* xs, double* ms, double* es, std::size_t n) {
+		double ea;
+		const isa::reg va = isa::set1(a), vm = isa::set1(split(a, ea)), ve = isa::set1(ea);
+		apply2(xs, ms, es, n, [va, vm, ve](isa::reg x, isa::reg& m, isa::reg& e) {
+			cosh_scaled<isa>(isa::div(x, va), m, e);
+			m = isa::mul(m, m);
+			e = isa::add(e, e);
+			normalize<isa>(m, e);
+			m = isa::mul(m, vm);
+			e = isa::add(e, ve);
+			normalize<isa>(m, e);
+		});
+	}
+
+	void inverse_ordinate(double a, const double* ys, double* out, std::size_t n) {
+		const isa::reg va = isa::set1(a), ra = isa::set1(std::fabs(a));
+		apply(ys, out, n, [va, ra](isa::reg y) {
+			return isa::mul(ra, arcosh<isa>(isa::div(y, va)));
+		});
+	}
+
+	void inverse_arc_length(double a, const double* ls, double* out, std::size_t n) {
+		const isa::reg va = isa::set1(a);
+		apply(ls, out, n, [va](isa::reg l) {
+			return isa::mul(va, arsinh<isa>(isa::div(l, va)));
+		});
+	}
+
+	void inverse_area(double a, const double* x1s, const double* Ss, double* out, std::size_t n) {
+		const isa::reg va = isa::set1(a),
+			va2 = isa::set1(a * a);
+		std::size_t i = 0;
+		isa::reg ch, sh;
+
+		for (; i + isa::width <= n; i += isa::width) {
+			cosh_sinh<isa>(isa::div(isa::load(x1s + i), va), ch, sh);
+			const isa::reg v = isa::add(isa::div(isa::load(Ss + i), va2), sh);
+			isa::store(out + i, isa::mul(va, arsinh<isa>(v)));
+		}
+
+		if (i < n) {
+			double t1[isa::width] = {}, t2[isa::width] = {};
+			for (std::size_t j = 0; i + j < n; ++j) t1[j] = x1s[i + j], t2[j] = Ss[i + j];
+			cosh_sinh<isa>(isa::div(isa::load(t1), va), ch, sh);
+			const isa::reg v = isa::add(isa::div(isa::load(t2), va2), sh);
+			isa::store(t1, isa::mul(va, arsinh<isa>(v)));
+			for (std::size_t j = 0; i + j < n; ++j) out[i + j] = t1[j];
+		}
+	}
+
+	void ordinate_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+		const double* const in[] = { as, inv_as, xs };
+		zip(in, out, n, [](const isa::reg (&v)[3]) {
+			isa::reg ch, sh;
+			cosh_sinh<isa>(isa::mul(v[2], v[1]), ch, sh);
+			return isa::mul(v[0], ch);
+		});
+	}
+
+	void arc_length_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+		const double* const in[] = { as, inv_as, xs };
+		zip(in, out, n, [](const isa::reg (&v)[3]) {
+			isa::reg ch, sh;
+			cosh_sinh<isa>(isa::mul(v[2], v[1]), ch, sh);
+			return isa::mul(v[0], sh);
+		});
+	}
+
+	void curvature_radius_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+		const double* const in[] = { as, inv_as, xs };
+		zip(in, out, n, [](const isa::reg (&v)[3]) {
+			isa::reg ch, sh;
+			cosh_sinh<isa>(isa::mul(v[2], v[1]), ch, sh);
+			return isa::mul(v[0], isa::mul(ch, ch));
+		});
+	}
+
+	void area_each(const double* a2s, const double* inv_as, const double* x1s, const double* x2s,
+		double* out, std::size_t n)
+	{
+		const double* const in[] = { a2s, inv_as, x1s, x2s };
+		zip(in, out, n, [](const isa::reg (&v)[4]) {
+			isa::reg ch, sh1, sh2;
+			cosh_sinh<isa>(isa::mul(v[2], v[1]), ch, sh1);
+			cosh_sinh<isa>(isa::mul(v[3], v[1]), ch, sh2);
+			return isa::mul(v[0], isa::sub(sh2, sh1));
+		});
+	}
+
+	void ordinate(float a, const float* xs, float* out, std::size_t n) {
+		typedef isa_single V;
+		const V::reg va = V::set1(a);
+		apply<V>(xs, out, n, [va](V::reg x) {
+			V::reg ch, sh;
+			cosh_sinh_single<V>(V::div(x, va), ch, sh);
+			return V::mul(va, ch);
+		});
+	}
+
+	void arc_length(float a, const float* xs, float* out, std::size_t n) {
+		typedef isa_single V;
+		const V::reg va = V::set1(a);
+		apply<V>(xs, out, n, [va](V::reg x) {
+			V::reg ch, sh;
+			cosh_sinh_single<V>(V::div(x, va), ch, sh);
+			return V::mul(va, sh);
+		});
+	}
+
+	void curvature_radius(float a, const float* xs, float* out, std::size_t n) {
+		typedef isa_single V;
+		const V::reg va = V::set1(a);
+		apply<V>(xs, out, n, [va](V::reg x) {
+			V::reg ch, sh;
+			cosh_sinh_single<V>(V::div(x, va), ch, sh);
+			return V::mul(va, V::mul(ch, ch));
+		});
+	}
+
+	void area(float a, const float* x1s, const float* x2s, float* out, std::size_t n) {
+		typedef isa_single V;
+		const V::reg va = V::set1(a),
+			va2 = V::set1(a * a);
+		std::size_t i = 0;
+		V::reg ch, sh1, sh2;
+
+		for (; i + V::width <= n; i += V::width) {
+			cosh_sinh_single<V>(V::div(V::load(x1s + i), va), ch, sh1);
+			cosh_sinh_single<V>(V::div(V::load(x2s + i), va), ch, sh2);
+			V::store(out + i, V::mul(va2, V::sub(sh2, sh1)));
+		}
+
+		if (i < n) {
+			float t1[V::width] = {}, t2[V::width] = {};
+			for (std::size_t j = 0; i + j < n; ++j) t1[j] = x1s[i + j], t2[j] = x2s[i + j];
+			cosh_sinh_single<V>(V::div(V::load(t1), va), ch, sh1);
+			cosh_sinh_single<V>(V::div(V::load(t2), va), ch, sh2);
+			V::store(t1, V::mul(va2, V::sub(sh2, sh1)));
+			for (std::size_t j = 0; i + j < n; ++j) out[i + j] = t1[j];
+		}
+	}
+
+	bool magnitude_range(const double* xs, std::size_t n, double& lo, double& hi) {
+		const isa::reg zero = isa::set1(0), inf = isa::set1(INFINITY);
+		// x * 0 is 0 for finite x, NaN otherwise, and sticks in the sum
+		isa::reg vlo = inf, vhi = zero, vfinite = zero;
+		const auto step = [&](isa::reg x) {
+			const isa::reg ax = isa::abs(x);
+			vlo = isa::min(vlo, isa::select(isa::lt(zero, ax), ax, inf));
+			vhi = isa::max(vhi, ax);
+			vfinite = isa::add(vfinite, isa::mul(x, zero));
+		};
+
+		std::size_t i = 0;
+		for (; i + isa::width <= n; i += isa::width) step(isa::load(xs + i));
+		if (i < n) {
+			double tail[isa::width] = {};
+			for (std::size_t j = 0; i + j < n; ++j) tail[j] = xs[i + j];
+			step(isa::load(tail));
+		}
+
+		double l[isa::width], h[isa::width], f[isa::width];
+		isa::store(l, vlo);
+		isa::store(h, vhi);
+		isa::store(f, vfinite);
+		lo = INFINITY, hi = 0;
+		double finite = 0;
+		for (std::size_t j = 0; j < isa::width; ++j) {
+			lo = l[j] < lo ? l[j] : lo;
+			hi = h[j] > hi ? h[j] : hi;
+			finite += f[j];
+		}
+		if (lo == INFINITY) lo = 0;
+		return finite == 0;
+	}
+
+	constexpr curve::kernels::table vector_kernels = {
+		isa::name(),
+		ordinate, arc_length, curvature_radius, hyperbolic, area,
+		log_ordinate, log_curvature_radius, scaled_ordinate, scaled_curvature_radius,
+		inverse_ordinate, inverse_arc_length, inverse_area,
+		ordinate_each, arc_length_each, curvature_radius_each, area_each,
+		ordinate, arc_length, curvature_radius, area,
+		magnitude_range
+	};
+
+}
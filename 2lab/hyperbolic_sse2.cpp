@@ -0,0 +1,161 @@
+#include "pch.h"
+#include "kernel_table.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <cstdint>
+#include <emmintrin.h>
+
+namespace {
+
+	constexpr double two52 = 4503599627370496.0;
+	constexpr float two23 = 8388608.0f;
+
+	// SSE2 has no fused multiply-add, rounding or blend: a * b + c rounds
+	// twice, round goes through 2^52 (every double past it is integral),
+	// floor steps back from round and select is and / andnot / or
+	struct isa {
+		typedef double scalar;
+		typedef __m128d reg;
+		typedef __m128d mask;
+		static constexpr std::size_t width = 2;
+		static constexpr const char* name() { return "sse2"; }
+
+		static reg load(const double* p) { return _mm_loadu_pd(p); }
+		static void store(double* p, reg v) { _mm_storeu_pd(p, v); }
+		static reg set1(double v) { return _mm_set1_pd(v); }
+		static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+		static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+		static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+		static reg div(reg a, reg b) { return _mm_div_pd(a, b); }
+		static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+		static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+		static reg fma(reg a, reg b, reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+		static reg fnma(reg a, reg b, reg c) { return _mm_sub_pd(c, _mm_mul_pd(a, b)); }
+		static reg abs(reg v) { return _mm_andnot_pd(_mm_set1_pd(-0.0), v); }
+		static reg round(reg v) {
+			const reg av = abs(v), big = _mm_set1_pd(two52);
+			return select(lt(av, big), copysign(_mm_sub_pd(_mm_add_pd(av, big), big), v), v);
+		}
+		static reg floor(reg v) {
+			const reg r = round(v);
+			return _mm_sub_pd(r, _mm_and_pd(lt(v, r), _mm_set1_pd(1.0)));
+		}
+		static reg sqrt(reg v) { return _mm_sqrt_pd(v); }
+		static void split(reg v, reg& m, reg& e) {
+			const __m128i bits = _mm_castpd_si128(v);
+			m = _mm_castsi128_pd(_mm_or_si128(
+				_mm_and_si128(bits, _mm_set1_epi64x(0x000fffffffffffffLL)),
+				_mm_set1_epi64x(0x3ff0000000000000LL)));
+			// the biased exponent dropped into the mantissa of 2^52
+			const __m128i biased = _mm_or_si128(_mm_srli_epi64(bits, 52), _mm_castpd_si128(_mm_set1_pd(two52)));
+			e = _mm_sub_pd(_mm_castsi128_pd(biased), _mm_set1_pd(two52 + 1023));
+		}
+		static reg pow2(reg k) {
+			const __m128i bits = _mm_castpd_si128(_mm_add_pd(k, _mm_set1_pd(two52 + 1023)));
+			return _mm_castsi128_pd(_mm_slli_epi64(bits, 52));
+		}
+		static reg copysign(reg mag, reg sgn) {
+			const __m128d sign = _mm_set1_pd(-0.0);
+			return _mm_or_pd(_mm_andnot_pd(sign, mag), _mm_and_pd(sign, sgn));
+		}
+		static mask lt(reg a, reg b) { return _mm_cmplt_pd(a, b); }
+		static mask unord(reg v) { return _mm_cmpunord_pd(v, v); }
+		static reg select(mask m, reg t, reg f) { return _mm_or_pd(_mm_and_pd(m, t), _mm_andnot_pd(m, f)); }
+	};
+
+	// the float lanes of the same registers, twice as many per instruction
+	struct isa_single {
+		typedef float scalar;
+		typedef __m128 reg;
+		typedef __m128 mask;
+		static constexpr std::size_t width = 4;
+
+		static reg load(const float* p) { return _mm_loadu_ps(p); }
+		static void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+		static reg set1(float v) { return _mm_set1_ps(v); }
+		static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+		static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+		static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+		static reg div(reg a, reg b) { return _mm_div_ps(a, b); }
+		static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+		static reg fma(reg a, reg b, reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static reg fnma(reg a, reg b, reg c) { return _mm_sub_ps(c, _mm_mul_ps(a, b)); }
+		static reg abs(reg v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+		static reg round(reg v) {
+			const reg av = abs(v), big = _mm_set1_ps(two23);
+			return select(lt(av, big), copysign(_mm_sub_ps(_mm_add_ps(av, big), big), v), v);
+		}
+		static reg floor(reg v) {
+			const reg r = round(v);
+			return _mm_sub_ps(r, _mm_and_ps(lt(v, r), _mm_set1_ps(1.0f)));
+		}
+		static reg pow2(reg k) {
+			const __m128i bits = _mm_castps_si128(_mm_add_ps(k, _mm_set1_ps(two23 + 127)));
+			return _mm_castsi128_ps(_mm_slli_epi32(bits, 23));
+		}
+		static reg copysign(reg mag, reg sgn) {
+			const __m128 sign = _mm_set1_ps(-0.0f);
+			return _mm_or_ps(_mm_andnot_ps(sign, mag), _mm_and_ps(sign, sgn));
+		}
+		static mask lt(reg a, reg b) { return _mm_cmplt_ps(a, b); }
+		static mask unord(reg v) { return _mm_cmpunord_ps(v, v); }
+		static reg select(mask m, reg t, reg f) { return _mm_or_ps(_mm_and_ps(m, t), _mm_andnot_ps(m, f)); }
+	};
+
+}
+
+#include "hyperbolic_simd.h"
+
+namespace {
+
+	// Two lanes of the polynomials lose to libm's cosh, log and acosh one
+	// at a time (measured with glibc), so those kernels stay scalar; sinh,
+	// the areas and single precision keep the vectors.
+	using curve::kernels::scalar_kernels;
+
+	void libm_ordinate(double a, const double* xs, double* out, std::size_t n) {
+		scalar_kernels.ordinate(a, xs, out, n);
+	}
+	void libm_curvature_radius(double a, const double* xs, double* out, std::size_t n) {
+		scalar_kernels.curvature_radius(a, xs, out, n);
+	}
+	void libm_log_ordinate(double a, const double* xs, double* out, std::size_t n) {
+		scalar_kernels.log_ordinate(a, xs, out, n);
+	}
+	void libm_log_curvature_radius(double a, const double* xs, double* out, std::size_t n) {
+		scalar_kernels.log_curvature_radius(a, xs, out, n);
+	}
+	void libm_inverse_ordinate(double a, const double* ys, double* out, std::size_t n) {
+		scalar_kernels.inverse_ordinate(a, ys, out, n);
+	}
+	void libm_inverse_arc_length(double a, const double* ls, double* out, std::size_t n) {
+		scalar_kernels.inverse_arc_length(a, ls, out, n);
+	}
+	void libm_ordinate_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+		scalar_kernels.ordinate_each(as, inv_as, xs, out, n);
+	}
+	void libm_curvature_radius_each(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n) {
+		scalar_kernels.curvature_radius_each(as, inv_as, xs, out, n);
+	}
+
+	constexpr curve::kernels::table sse2 = {
+		isa::name(),
+		libm_ordinate, vector_kernels.arc_length, libm_curvature_radius, vector_kernels.hyperbolic, vector_kernels.area,
+		libm_log_ordinate, libm_log_curvature_radius, vector_kernels.scaled_ordinate, vector_kernels.scaled_curvature_radius,
+		libm_inverse_ordinate, libm_inverse_arc_length, vector_kernels.inverse_area,
+		libm_ordinate_each, vector_kernels.arc_length_each, libm_curvature_radius_each, vector_kernels.area_each,
+		vector_kernels.ordinate_single, vector_kernels.arc_length_single,
+		vector_kernels.curvature_radius_single, vector_kernels.area_single,
+		vector_kernels.magnitude_range
+	};
+
+}
+
+const curve::kernels::table* const curve::kernels::sse2_kernels = &sse2;
+
+#else
+
+const curve::kernels::table* const curve::kernels::sse2_kernels = nullptr;
+
+#endif
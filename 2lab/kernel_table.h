@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+
+namespace curve {
+
+	namespace kernels {
+
+		// Every kernel of hyperbolic.h for one instruction set. Each set is
+		// its own translation unit built for that set alone; the functions in
+		// hyperbolic.h call through the table picked at startup.
+		struct table {
+			const char* name;
+
+			void (*ordinate)(double a, const double* xs, double* out, std::size_t n);
+			void (*arc_length)(double a, const double* xs, double* out, std::size_t n);
+			void (*curvature_radius)(double a, const double* xs, double* out, std::size_t n);
+			void (*hyperbolic)(double a, const double* xs, double* ch, double* sh, std::size_t n);
+			void (*area)(double a, const double* x1s, const double* x2s, double* out, std::size_t n);
+
+			void (*log_ordinate)(double a, const double* xs, double* out, std::size_t n);
+			void (*log_curvature_radius)(double a, const double* xs, double* out, std::size_t n);
+			void (*scaled_ordinate)(double a, const double* xs, double* ms, double* es, std::size_t n);
+			void (*scaled_curvature_radius)(double a, const double* xs, double* ms, double* es, std::size_t n);
+
+			void (*inverse_ordinate)(double a, const double* ys, double* out, std::size_t n);
+			void (*inverse_arc_length)(double a, const double* ls, double* out, std::size_t n);
+			void (*inverse_area)(double a, const double* x1s, const double* Ss, double* out, std::size_t n);
+
+			void (*ordinate_each)(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n);
+			void (*arc_length_each)(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n);
+			void (*curvature_radius_each)(const double* as, const double* inv_as, const double* xs, double* out, std::size_t n);
+			void (*area_each)(const double* a2s, const double* inv_as, const double* x1s, const double* x2s,
+				double* out, std::size_t n);
+
+			void (*ordinate_single)(float a, const float* xs, float* out, std::size_t n);
+			void (*arc_length_single)(float a, const float* xs, float* out, std::size_t n);
+			void (*curvature_radius_single)(float a, const float* xs, float* out, std::size_t n);
+			void (*area_single)(float a, const float* x1s, const float* x2s, float* out, std::size_t n);
+
+			bool (*magnitude_range)(const double* xs, std::size_t n, double& lo, double& hi);
+		};
+
+		// the plain C++ kernels, there on every build and every CPU
+		extern const table scalar_kernels;
+		// the vector ones, nullptr where the build left the set out (the
+		// compiler cannot target it); whether the CPU runs them is up to
+		// hyperbolic.cpp
+		extern const table* const sse2_kernels;
+		extern const table* const avx2_kernels;
+		extern const table* const avx512_kernels;
+
+		// a = m * 2^e with |m| in [1, 2); out of line, so no instruction set
+		// builds its own copy
+		double split(double a, double& e);
+
+	}
+
+}
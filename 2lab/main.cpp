@@ -1,12 +1,161 @@
 #include "pch.h"
 #include "Catenary.h"
 #include "safe_io.h"
+#include "batch.h"
+#include "bulk_io.h"
+#include "QueryCache.h"
+#include "Verifier.h"
+#include "Instrument.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <locale>
+#include <memory>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+// 2lab --batch [input] [--out output] [--binary] [--cache entries | --threads workers] [--verify period]
+static int run_batch(int argc, char* argv[])
+{
+	std::wcerr.imbue(std::locale(".866"));
+
+	const wchar_t* usage = L": 2lab --batch [ ] [--out  ] [--binary]"
+		L" [--cache  | --threads ] [--verify ]\n";
+	const char* input = nullptr;
+	const char* output = nullptr;
+	batch::format format = batch::format::text;
+	std::unique_ptr<curve::QueryCache> cache;
+	unsigned threads = 0;
+	std::unique_ptr<curve::Verifier> verifier;
+
+	for (int i = 0; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--binary") == 0)
+			format = batch::format::binary;
+		else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+			output = argv[++i];
+		else if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc && std::atol(argv[i + 1]) > 0)
+			cache.reset(new curve::QueryCache(static_cast<std::size_t>(std::atol(argv[++i]))));
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc && std::atol(argv[i + 1]) > 0)
+			threads = static_cast<unsigned>(std::atol(argv[++i]));
+		else if (std::strcmp(argv[i], "--verify") == 0 && i + 1 < argc && std::atol(argv[i + 1]) > 0)
+			verifier.reset(new curve::Verifier(static_cast<std::uint64_t>(std::atol(argv[++i]))));
+		else if (!input && argv[i][0] != '-')
+			input = argv[i];
+		else
+		{
+			std::wcerr << usage;
+			return 2;
+		}
+	}
+	// the cache answers record by record, the pipeline chunk by chunk
+	if (cache && threads)
+	{
+		std::wcerr << usage;
+		return 2;
+	}
+
+	std::FILE* in = input ? std::fopen(input, "rb") : stdin;
+	if (!in)
+	{
+		std::wcerr << L"   : " << input << L'\n';
+		return 1;
+	}
+	std::FILE* out = output ? std::fopen(output, "wb") : stdout;
+	if (!out)
+	{
+		if (input) std::fclose(in);
+		std::wcerr << L"   : " << output << L'\n';
+		return 1;
+	}
+
+#ifdef _WIN32
+	if (format == batch::format::binary)
+	{
+		if (!input) _setmode(_fileno(stdin), _O_BINARY);
+		if (!output) _setmode(_fileno(stdout), _O_BINARY);
+	}
+#endif
+
+	const batch::stats stats = threads
+		? batch::run_parallel(in, out, format, threads, verifier.get())
+		: batch::run(in, out, format, cache.get(), verifier.get());
+
+	if (input) std::fclose(in);
+	if (output) std::fclose(out);
+	else std::fflush(stdout);
+
+	std::wcerr << L" : " << stats.records
+		<< L", : " << stats.errors << L'\n';
+	if (cache)
+	{
+		const curve::QueryCache::stats hits = cache->counters();
+		std::wcerr << L"  : " << hits.hits
+			<< L", : " << hits.misses << L'\n';
+	}
+	if (verifier)
+	{
+		// drift from ReferenceCatenary in ulps, per operation in menu order
+		const wchar_t* const names[] = {
+			L"", L" ", L" ", L" ", L" "
+		};
+		for (int q = 0; q < 5; ++q)
+		{
+			const curve::Verifier::summary v = verifier->result(static_cast<curve::query>(q));
+			if (!v.checked) continue;
+			std::wcerr << L" (" << names[q] << L"): " << v.checked
+				<< L",    " << v.mean_ulps << L" ulp,  " << v.max_ulps
+				<< L" ulp (a = " << v.worst_a << L", x = " << v.worst_x << L")\n";
+		}
+	}
+	return stats.errors ? 3 : 0;
+}
+
+
+// 2lab --mmap input output
+static int run_mmap(int argc, char* argv[])
+{
+	std::wcerr.imbue(std::locale(".866"));
+
+	if (argc != 2)
+	{
+		std::wcerr << L": 2lab --mmap    \n";
+		return 2;
+	}
+
+	try
+	{
+		const std::uint64_t rows = bulk::run(argv[0], argv[1]);
+		std::wcerr << L" : " << rows << L'\n';
+	}
+	catch (const std::exception& e)
+	{
+		std::wcerr << L": " << e.what() << L'\n';
+		return 1;
+	}
+	return 0;
+}
 
 
 int main(int argc, char* argv[])
 {
-	::testing::InitGoogleTest(&argc, argv);
-	RUN_ALL_TESTS();
+#ifdef CURVE_INSTRUMENT
+	// the profile goes to $CURVE_INSTRUMENT_OUT, or to stderr
+	instrument::install(std::getenv("CURVE_INSTRUMENT_OUT"));
+#endif
+
+	if (argc > 1 && std::strcmp(argv[1], "--batch") == 0)
+		return run_batch(argc - 2, argv + 2);
+	if (argc > 1 && std::strcmp(argv[1], "--mmap") == 0)
+		return run_mmap(argc - 2, argv + 2);
 
 	std::wcout.imbue(std::locale(".866"));
 
@@ -32,6 +181,7 @@ int main(int argc, char* argv[])
 	sfio::safe_cin(L"   'a'", a, 
 		std::initializer_list<double>{0}, L' ');
 	curve::Catenary c(a);
+	sfio::buffered_writer out(stdout);
 
 	while (true)
 	{
@@ -51,17 +201,17 @@ int main(int argc, char* argv[])
 
 		case get_ordinate:
 			std::wcout << L": ";
-			std::cout << abs(c.y(x)) << std::endl;
+			out.write(std::abs(CURVE_TIMED(ordinate, c.y(x))), 6);
 			break;
 
 		case get_arc_length:
 			std::wcout << L": ";
-			std::cout << c.l(x) << std::endl;
+			out.write(CURVE_TIMED(arc_length, c.l(x)), 6);
 			break;
 
 		case get_curvature_radius:
 			std::wcout << L": ";
-			std::cout << abs(c.R(x)) << std::endl;
+			out.write(std::abs(CURVE_TIMED(curvature_radius, c.R(x))), 6);
 			break;
 		
 		case get_trapeze_area:
@@ -69,17 +219,28 @@ int main(int argc, char* argv[])
 			sfio::safe_cin(L"  'x1':", x1, L' ');
 			sfio::safe_cin(L"  'x2':", x2, L' ');
 			std::wcout << L": ";
-			std::cout << abs(c.S(x1, x2)) << std::endl;
+			out.write(std::abs(CURVE_TIMED(area, c.S(x1, x2))), 6);
 			break;
 
 		case get_curvature_center_coordinates:
-			const curve::coord first_coord(c.CurvatureCenterCoords(x).first);
-			const curve::coord second_coord(c.CurvatureCenterCoords(x).second);
+			const curve::coords_pair centers(CURVE_TIMED(curvature_centers, c.CurvatureCenterCoords(x)));
+			const curve::coord& first_coord(centers.first);
+			const curve::coord& second_coord(centers.second);
 			std::wcout << L":\n";
-			std::cout << '(' << first_coord.first << "; " << first_coord.second << "),"
-				<< "\n" << '(' << second_coord.first << "; " << second_coord.second << ')'
-				<< std::endl;
+			out.put('(');
+			out.write(first_coord.first, 6);
+			out.write("; ", 2);
+			out.write(first_coord.second, 6);
+			out.write("),\n(", 4);
+			out.write(second_coord.first, 6);
+			out.write("; ", 2);
+			out.write(second_coord.second, 6);
+			out.put(')');
 			break;
 		}
+
+		out.put('\n');
+		out.flush();
+		std::fflush(stdout);
 	}
 }
\ No newline at end of file
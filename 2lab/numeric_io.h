@@ -0,0 +1,254 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+
+// Locale-free number parsing and formatting on top of <charconv>, with exact
+// fast paths for the plain decimals that make up nearly all real input.
+namespace sfio
+{
+
+	namespace detail
+	{
+
+		// 10^0 .. 10^22, every one exact in a double
+		constexpr double exact_pow10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		constexpr bool little_endian = false;
+#else
+		constexpr bool little_endian = true;
+#endif
+
+		constexpr std::uint64_t exact_pow10_int[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+		// how many of the 8 characters in v (the first in the low byte) are
+		// digits before the first non-digit, and their value; no branch per
+		// digit, so numbers of varying length cost no mispredictions
+		inline unsigned leading_digits(std::uint64_t v, std::uint64_t& value)
+		{
+			// the top bit of every byte that is not a digit; the carries and
+			// borrows only run towards later characters, past the first one flagged
+			const std::uint64_t flags = ((v + 0x4646464646464646) | (v - 0x3030303030303030)) & 0x8080808080808080;
+			const std::uint64_t before = ((flags & (0 - flags)) - 1) & 0x8080808080808080;
+			const unsigned n = static_cast<unsigned>(((before >> 7) * 0x0101010101010101) >> 56);
+			if (n == 0) return 0;
+
+			// the n digits moved to the low end of an 8-digit number, then
+			// pairs, quads and the octet combined by multiply-and-shift
+			v = (v - 0x3030303030303030) << (8 * (8 - n));
+			v = v * 10 + (v >> 8);
+			value = ((v & 0x000000FF000000FF) * (100 + (1000000ull << 32))
+				+ ((v >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32))) >> 32;
+			return n;
+		}
+
+		// appends the digits at p to m, returns where they end; [begin, last)
+		// is readable, so fewer than 8 characters before last are read as the
+		// word ending at last, shifted down, once the text is 8 long
+		inline const char* digits(const char* begin, const char* p, const char* last, std::uint64_t& m)
+		{
+			if constexpr (little_endian)
+			{
+				while (p != last && last - begin >= 8)
+				{
+					std::uint64_t v, run;
+					if (last - p >= 8) std::memcpy(&v, p, sizeof(v));
+					else
+					{
+						std::memcpy(&v, last - 8, sizeof(v));
+						// the zero bytes shifted in count as non-digits
+						v >>= 8 * (8 - (last - p));
+					}
+					const unsigned n = leading_digits(v, run);
+					if (n == 0) return p;
+					m = m * exact_pow10_int[n] + run;
+					p += n;
+					if (n < 8) return p;
+				}
+			}
+			while (p != last && static_cast<unsigned>(*p - '0') < 10) m = m * 10 + static_cast<unsigned>(*p++ - '0');
+			return p;
+		}
+
+		// [-]digits[.digits] spanning all of [first, last) with at most 19
+		// digits, a mantissa m <= 2^53 and k <= 22 of them after the point:
+		// m and 10^k are exact, so m / 10^k is one correct rounding (Clinger's
+		// fast path). false for anything else, from_chars takes it from there.
+		inline bool parse_decimal(const char* first, const char* last, double& value)
+		{
+			const bool negative = first != last && *first == '-';
+			const char* const begin = first + negative;
+			std::uint64_t m = 0;
+			const char* p = digits(first, begin, last, m);
+			std::ptrdiff_t count = p - begin, fraction = 0;
+			if (p != last && *p == '.')
+			{
+				const char* const point = p + 1;
+				p = digits(first, point, last, m);
+				fraction = p - point;
+				if (fraction == 0) return false;
+				count += fraction;
+			}
+			// past 19 digits m may have wrapped, it is not used then
+			if (p != last || count == 0 || count > 19 || fraction > 22 || m > std::uint64_t(1) << 53) return false;
+
+			const double d = static_cast<double>(m) / exact_pow10[fraction];
+			value = negative ? -d : d;
+			return true;
+		}
+
+		// printf's %.<precision>g of a nonzero finite value with precision
+		// <= 15, from one correctly rounded scaling to an integer of
+		// precision digits: |value| * 10^k with k <= 22 is off by at most
+		// half an ulp, so away from a rounding tie its rounding is the exact
+		// value's. nullptr near a tie and for anything else.
+		inline char* format_general(char* first, char* last, double value, int precision)
+		{
+			if (precision < 1 || precision > 15 || last - first < 32) return nullptr;
+
+			std::uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			const int binary = static_cast<int>(bits >> 52 & 0x7ff);
+			// zero, subnormals, infinities and NaN
+			if (binary == 0 || binary == 0x7ff) return nullptr;
+
+			// floor(log10(2^e)), the decimal exponent or one less
+			int e10 = (binary - 1023) * 78913 >> 18;
+			const double mag = std::abs(value);
+			double scaled = 0;
+			for (int attempt = 0; attempt < 2; ++attempt)
+			{
+				const int k = precision - 1 - e10;
+				if (k > 22 || k < -22) return nullptr;
+				scaled = k >= 0 ? mag * exact_pow10[k] : mag / exact_pow10[-k];
+				if (scaled < exact_pow10[precision]) break;
+				++e10;
+			}
+
+			std::uint64_t n = static_cast<std::uint64_t>(scaled);
+			const double rest = scaled - static_cast<double>(n);
+			if (std::abs(rest - 0.5) <= scaled * 2.220446049250313e-16) return nullptr;
+			if (rest > 0.5) ++n;
+			if (n == static_cast<std::uint64_t>(exact_pow10[precision]))
+			{
+				n /= 10;
+				++e10;
+			}
+
+			char d[16];
+			for (int i = precision; i-- > 0; n /= 10) d[i] = static_cast<char>('0' + n % 10);
+			int used = precision;
+			while (used > 1 && d[used - 1] == '0') --used;
+
+			char* p = first;
+			if (value < 0) *p++ = '-';
+			if (e10 >= -4 && e10 < precision)
+			{
+				if (e10 < 0)
+				{
+					*p++ = '0';
+					*p++ = '.';
+					for (int i = -1; i > e10; --i) *p++ = '0';
+					std::memcpy(p, d, used);
+					return p + used;
+				}
+				for (int i = 0; i <= e10; ++i) *p++ = i < used ? d[i] : '0';
+				if (used > e10 + 1)
+				{
+					*p++ = '.';
+					std::memcpy(p, d + e10 + 1, used - e10 - 1);
+					p += used - e10 - 1;
+				}
+				return p;
+			}
+
+			*p++ = d[0];
+			if (used > 1)
+			{
+				*p++ = '.';
+				std::memcpy(p, d + 1, used - 1);
+				p += used - 1;
+			}
+			*p++ = 'e';
+			*p++ = e10 < 0 ? '-' : '+';
+			const int e = e10 < 0 ? -e10 : e10;
+			if (e >= 100) *p++ = static_cast<char>('0' + e / 100);
+			*p++ = static_cast<char>('0' + e / 10 % 10);
+			*p++ = static_cast<char>('0' + e % 10);
+			return p;
+		}
+
+	}
+
+	enum class parse_result
+	{
+		ok,
+		empty,		// nothing but blanks
+		invalid,	// not a number of type T, or out of its range
+		trailing	// a number followed by something else
+	};
+
+	// Accepts what `std::cin >> value` accepts (leading blanks, an optional sign)
+	// and, as safe_cin always did, nothing after the number - not even blanks.
+	// value is only written on parse_result::ok.
+	template <typename T>
+	parse_result parse(const char* first, const char* last, T& value)
+	{
+		while (first != last && (*first == ' ' || *first == '\t')) ++first;
+		if (first == last) return parse_result::empty;
+		if (*first == '+' && last - first > 1 && first[1] != '-' && first[1] != '+') ++first;
+
+		T v;
+		std::from_chars_result r;
+		if constexpr (std::is_same<T, double>::value)
+		{
+			if (detail::parse_decimal(first, last, v))
+			{
+				value = v;
+				return parse_result::ok;
+			}
+		}
+		if constexpr (std::is_floating_point<T>::value)
+		{
+			r = std::from_chars(first, last, v, std::chars_format::general);
+			// iostreams do not read "inf" / "nan" either
+			if (r.ec == std::errc() && !std::isfinite(v)) return parse_result::invalid;
+		}
+		else
+		{
+			r = std::from_chars(first, last, v);
+		}
+
+		if (r.ec != std::errc()) return parse_result::invalid;
+		if (r.ptr != last) return parse_result::trailing;
+		value = v;
+		return parse_result::ok;
+	}
+
+	// enough for any double or 64-bit integer
+	constexpr std::size_t max_chars = 32;
+
+	// shortest text that reads back to the same value
+	template <typename T>
+	char* format(char* first, char* last, T value)
+	{
+		return std::to_chars(first, last, value).ptr;
+	}
+
+	// same text as an ostream with that precision (default 6) and no format flags
+	inline char* format(char* first, char* last, double value, int precision)
+	{
+		if (char* const end = detail::format_general(first, last, value, precision)) return end;
+		return std::to_chars(first, last, value, std::chars_format::general, precision).ptr;
+	}
+
+}
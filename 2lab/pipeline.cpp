@@ -0,0 +1,339 @@
+#include "pch.h"
+#include "batch.h"
+#include "buffered_io.h"
+#include "numeric_io.h"
+#include "Catenary.h"
+#include "Instrument.h"
+#include "Ring.h"
+#include "Verifier.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+	// records per chunk, the unit every stage hands on
+	constexpr std::size_t chunk_records = 4096;
+	// abscissae per kernel call, staged on the worker's stack
+	constexpr std::size_t block = 256;
+
+	struct chunk
+	{
+		std::size_t sequence = 0;
+		std::vector<batch::record> records;
+		std::vector<char> out;
+		std::size_t used = 0, errors = 0;
+	};
+
+	// Shared by the stages around the rings: a stage that finds its ring
+	// empty (full) spins a little, then sleeps until some stage moves a
+	// chunk. A ring stays empty that long only on slow input or output,
+	// which is no reason to hold a core.
+	class gate
+	{
+	public:
+		// after every push or pop
+		void ring()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m);
+				++generation;
+			}
+			moved.notify_all();
+		}
+
+		// until attempt() succeeds, then rings
+		template <class Try>
+		void wait_for(Try attempt)
+		{
+			for (int i = 0; i < spins; ++i)
+			{
+				if (attempt())
+				{
+					ring();
+					return;
+				}
+				std::this_thread::yield();
+			}
+
+			std::unique_lock<std::mutex> lock(m);
+			for (;;)
+			{
+				// a chunk moved after this reading wakes the wait at once
+				const std::uint64_t seen = generation;
+				lock.unlock();
+				if (attempt())
+				{
+					ring();
+					return;
+				}
+				lock.lock();
+				moved.wait(lock, [&] { return generation != seen; });
+			}
+		}
+
+	private:
+		// a chunk is thousands of records, a ring that stays empty for this
+		// many yields is waiting on I/O
+		static constexpr int spins = 64;
+
+		std::mutex m;
+		std::condition_variable moved;
+		std::uint64_t generation = 0;
+	};
+
+	bool valid(const batch::record& r)
+	{
+		return r.a != 0 && std::isfinite(r.a)
+			&& r.op >= batch::get_ordinate && r.op <= batch::get_trapeze_area;
+	}
+
+	int width(std::int32_t op)
+	{
+		return op == batch::get_curvature_center_coordinates ? 4 : 1;
+	}
+
+	// results of one record appended to c.out, as run prints them
+	void emit(chunk& c, batch::format f, const double* results, int n)
+	{
+		char* p = c.out.data() + c.used;
+		if (f == batch::format::binary)
+		{
+			std::memcpy(p, results, n * sizeof(double));
+			c.used += n * sizeof(double);
+			return;
+		}
+
+		char* const end = c.out.data() + c.out.size();
+		for (int i = 0; i < n; ++i)
+		{
+			CURVE_PROBE(format);
+			if (i) *p++ = ' ';
+			p = sfio::format(p, end, results[i]);
+		}
+		*p++ = '\n';
+		c.used = p - c.out.data();
+	}
+
+	void emit_error(chunk& c, batch::format f, std::int32_t op)
+	{
+		++c.errors;
+		if (f == batch::format::text)
+		{
+			std::memcpy(c.out.data() + c.used, "nan\n", 4);
+			c.used += 4;
+			return;
+		}
+		const double nans[4] = {
+			std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(),
+			std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()
+		};
+		emit(c, f, nans, width(op));
+	}
+
+	// records [first, last) share a and op: one kernel call per block
+	void compute_run(chunk& c, batch::format f, std::size_t first, std::size_t last, curve::Verifier* verifier)
+	{
+		const batch::record* const rs = c.records.data();
+		const curve::Catenary line(rs[first].a);
+		const std::int32_t op = rs[first].op;
+		double xs[block], x2s[block], r0[block], r1[block], r2[block], r3[block];
+
+		for (std::size_t i = first; i < last; i += block)
+		{
+			const std::size_t m = std::min(block, last - i);
+			for (std::size_t j = 0; j < m; ++j)
+			{
+				xs[j] = rs[i + j].x;
+				x2s[j] = rs[i + j].x2;
+			}
+
+			switch (op)
+			{
+			case batch::get_ordinate: CURVE_TIMED(ordinate, line.y(xs, r0, m)); break;
+			case batch::get_arc_length: CURVE_TIMED(arc_length, line.l(xs, r0, m)); break;
+			case batch::get_curvature_radius: CURVE_TIMED(curvature_radius, line.R(xs, r0, m)); break;
+			case batch::get_trapeze_area: CURVE_TIMED(area, line.S(xs, x2s, r0, m)); break;
+			case batch::get_curvature_center_coordinates:
+				CURVE_TIMED(curvature_centers,
+					line.CurvatureCenterCoords(xs, curve::coord_view{ r0, r1, m }, curve::coord_view{ r2, r3, m }));
+				break;
+			}
+
+			for (std::size_t j = 0; j < m; ++j)
+			{
+				double results[4];
+				if (op == batch::get_curvature_center_coordinates)
+				{
+					results[0] = r0[j];
+					results[1] = r1[j];
+					results[2] = r2[j];
+					results[3] = r3[j];
+				}
+				// same absolute values the menu prints
+				else results[0] = op == batch::get_arc_length ? r0[j] : std::abs(r0[j]);
+				emit(c, f, results, width(op));
+
+				// numbered as run numbers them: chunks are full but for the last
+				const batch::record& r = rs[i + j];
+				if (verifier && verifier->due(c.sequence * chunk_records + i + j))
+					verifier->check(static_cast<curve::query>(op - batch::get_ordinate), r.a, r.x, r.x2, results);
+			}
+		}
+	}
+
+	void compute(chunk& c, batch::format f, curve::Verifier* verifier)
+	{
+		const std::vector<batch::record>& rs = c.records;
+		c.used = c.errors = 0;
+
+		for (std::size_t i = 0; i < rs.size(); )
+		{
+			if (!valid(rs[i]))
+			{
+				emit_error(c, f, rs[i].op);
+				++i;
+				continue;
+			}
+			// consecutive records usually share 'a' and op
+			std::size_t j = i + 1;
+			while (j < rs.size() && rs[j].a == rs[i].a && rs[j].op == rs[i].op) ++j;
+			compute_run(c, f, i, j, verifier);
+			i = j;
+		}
+	}
+
+	// fills c from the input, false if it is exhausted and c got nothing
+	bool fill(sfio::buffered_reader& in, batch::format f, chunk& c)
+	{
+		c.records.clear();
+		if (f == batch::format::binary)
+		{
+			batch::record r;
+			while (c.records.size() < chunk_records && in.read(&r, sizeof(r)))
+				c.records.push_back(r);
+			// a truncated last record, answered as an invalid one (op 0)
+			if (c.records.size() < chunk_records && in.pending())
+			{
+				c.records.push_back(batch::record{});
+				in.read(&r, in.pending());
+			}
+		}
+		else
+		{
+			char *begin, *end;
+			while (c.records.size() < chunk_records && in.line(begin, end))
+			{
+				if (begin == end) continue;
+				batch::record r{};
+				// op 0 marks the record invalid for the workers
+				if (!batch::parse(begin, end, r)) r.op = 0;
+				c.records.push_back(r);
+			}
+		}
+		return !c.records.empty();
+	}
+
+}
+
+batch::stats batch::run_parallel(std::FILE* in, std::FILE* out, format f, unsigned workers,
+	curve::Verifier* verifier)
+{
+	workers = std::max(workers, 1u);
+
+	// every chunk is free, being filled, queued, computed or awaiting its
+	// turn to be written, so chunks bound the memory and the reordering
+	const std::size_t chunks = 2 * static_cast<std::size_t>(workers) + 2;
+	std::unique_ptr<chunk[]> pool(new chunk[chunks]);
+	for (std::size_t i = 0; i < chunks; ++i)
+	{
+		pool[i].records.reserve(chunk_records);
+		// the widest text line: four numbers, their separators and '\n'
+		pool[i].out.resize(chunk_records * 4 * (sfio::max_chars + 1));
+	}
+
+	// writer -> reader, reader -> workers (nullptr: no more chunks), workers -> writer
+	curve::SpscRing<chunk*> idle(chunks);
+	curve::MpmcRing<chunk*> work(chunks + workers), done(chunks);
+	for (std::size_t i = 0; i < chunks; ++i) idle.try_push(&pool[i]);
+
+	const std::size_t unknown = std::numeric_limits<std::size_t>::max();
+	std::atomic<std::size_t> total{ unknown };
+	gate rings;
+
+	std::thread reader([&]
+	{
+		sfio::buffered_reader input(in);
+		std::size_t sequence = 0;
+		for (;;)
+		{
+			chunk* c;
+			rings.wait_for([&] { return idle.try_pop(c); });
+			if (!fill(input, f, *c)) break;
+			c->sequence = sequence++;
+			rings.wait_for([&] { return work.try_push(c); });
+		}
+		total.store(sequence, std::memory_order_release);
+		rings.ring();
+		for (unsigned i = 0; i < workers; ++i)
+			rings.wait_for([&] { return work.try_push(nullptr); });
+	});
+
+	std::vector<std::thread> computing;
+	for (unsigned i = 0; i < workers; ++i)
+		computing.emplace_back([&]
+		{
+			for (;;)
+			{
+				chunk* c;
+				rings.wait_for([&] { return work.try_pop(c); });
+				if (!c) break;
+				compute(*c, f, verifier);
+				rings.wait_for([&] { return done.try_push(c); });
+			}
+		});
+
+	// chunks arrive in any order; with at most `chunks` in flight the
+	// sequence modulo chunks is a free slot to park them in
+	stats s{};
+	{
+		sfio::buffered_writer writer(out);
+		std::vector<chunk*> parked(chunks, nullptr);
+		std::size_t next = 0;
+
+		while (next != total.load(std::memory_order_acquire))
+		{
+			// the reader rings once total is known, so the last wait ends
+			chunk* c = nullptr;
+			rings.wait_for([&] { return done.try_pop(c) || next == total.load(std::memory_order_acquire); });
+			if (!c) continue;
+			parked[c->sequence % chunks] = c;
+
+			while (chunk* ready = parked[next % chunks])
+			{
+				writer.write(ready->out.data(), ready->used);
+				s.records += ready->records.size();
+				s.errors += ready->errors;
+				parked[next % chunks] = nullptr;
+				++next;
+				// only the reader takes from idle, there is always room
+				idle.try_push(ready);
+				rings.ring();
+			}
+		}
+	}
+
+	reader.join();
+	for (std::thread& t : computing) t.join();
+	return s;
+}
@@ -1,40 +1,72 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <string>
 
+#include "buffered_io.h"
+#include "Instrument.h"
+#include "numeric_io.h"
+
 namespace sfio 
 {
 
+	// where safe_cin takes its lines from, stdin unless redirected
+	inline std::FILE*& input()
+	{
+		static std::FILE* f = stdin;
+		return f;
+	}
+
+	enum class read_result { ok, eof, invalid, trailing };
+
+	// the next non-blank line of input() parsed as T, foo is only written on ok
+	template <typename T>
+	read_result read_value(T& foo)
+	{
+		static std::string line;
+
+		for (;;)
+		{
+			if (!read_line(input(), line)) return read_result::eof;
+
+			switch (parse(line.data(), line.data() + line.size(), foo))
+			{
+			case parse_result::ok: return read_result::ok;
+			case parse_result::empty: continue;
+			case parse_result::invalid: return read_result::invalid;
+			case parse_result::trailing: return read_result::trailing;
+			}
+		}
+	}
+
 	template <typename T>
 	void safe_cin(const std::wstring& msg, T& foo, const wchar_t aftermsg = '\n')
 	{
+		CURVE_PROBE(prompt);
 		std::wcout << msg << aftermsg;
 
 		for (;;)
 		{
-			std::cin >> foo;
+			const read_result r = read_value(foo);
 
-			if (std::cin && std::cin.peek() != '\n')
+			if (r == read_result::trailing)
 			{
-				std::cin.ignore(std::cin.rdbuf()->in_avail());
 				std::wcout << L"   ."
 					L" ,  :"
 					<< std::endl;
 			}
-			else if (std::cin.eof())
+			else if (r == read_result::eof)
 			{
 				foo = T();
-				std::cin.clear();
 				break;
 			}
-			else if (std::cin.bad() || std::cin.fail())
+			else if (r == read_result::invalid)
 			{
 				std::wcout << L"  ."
 					L" ,  :"
 					<< std::endl;
-				std::cin.clear();
-				std::cin.ignore(std::cin.rdbuf()->in_avail());
 			}
 			else break;
 		}
@@ -43,31 +75,29 @@ namespace sfio
 	template <typename T>
 	void safe_cin(const std::wstring& msg, T& foo, T lowest, T max, const wchar_t aftermsg = '\n')
 	{
+		CURVE_PROBE(prompt);
 		std::wcout << msg <<
 			L"[" << lowest << 
 			L" ; " << max << L"]:" << aftermsg;
 
 		for (;;)
 		{
-			std::cin >> foo;
+			const read_result r = read_value(foo);
 
-			if (std::cin && std::cin.peek() != '\n')
+			if (r == read_result::trailing)
 			{
-				std::cin.ignore(std::cin.rdbuf()->in_avail());
+				continue;
 			}
-			else if (std::cin.eof())
+			else if (r == read_result::eof)
 			{
 				foo = T();
-				std::cin.clear();
 				break;
 			}
-			else if (std::cin.bad() || std::cin.fail())
+			else if (r == read_result::invalid)
 			{
 				std::wcout << L"  ."
 					L" ,  :"
 					<< std::endl;
-				std::cin.clear();
-				std::cin.ignore(std::cin.rdbuf()->in_avail());
 			}
 			else if (foo < lowest || foo > max)
 			{
@@ -81,6 +111,7 @@ namespace sfio
 	template <class T>
 	void safe_cin(const std::wstring& msg, T& foo, const std::initializer_list<T>& exceptvals, const wchar_t aftermsg = '\n')
 	{
+		CURVE_PROBE(prompt);
 		std::wcout << msg << L" (   ";
 
 		for (auto it = exceptvals.begin(); it != exceptvals.end(); ++it)
@@ -94,26 +125,23 @@ namespace sfio
 
 		for (;;)
 		{
-			std::cin >> foo;
+			const read_result r = read_value(foo);
 
-			if (std::cin.eof())
+			if (r == read_result::eof)
 			{
 				foo = T();
-				std::cin.clear();
 				break;
 			}
 
-			if (std::cin && std::cin.peek() != '\n')
+			if (r == read_result::trailing)
 			{
-				std::cin.ignore(std::cin.rdbuf()->in_avail());
+				continue;
 			}
-			else if (std::cin.bad() || std::cin.fail())
+			else if (r == read_result::invalid)
 			{
 				std::wcout << L"  ."
 					L" ,  :"
 					<< std::endl;
-				std::cin.clear();
-				std::cin.ignore(std::cin.rdbuf()->in_avail());
 			}
 			else if (std::find(exceptvals.begin(), exceptvals.end(), foo) != exceptvals.end())
 			{
@@ -0,0 +1,1089 @@
+#include "BasicCatenary.h"
+#include "Catenary.h"
+#include "CatenaryArray.h"
+#include "Instrument.h"
+#include "Integrator.h"
+#include "PolylineGenerator.h"
+#include "QueryCache.h"
+#include "ReferenceCatenary.h"
+#include "ShiftedCatenary.h"
+#include "StaticCatenary.h"
+#include "TabulatedCatenary.h"
+#include "batch.h"
+#include "hyperbolic.h"
+#include "safe_io.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Only the console table by default; --benchmark_out=<file> adds the JSON
+// report (keep it out of the tree, 2lab_bench.json is ignored).
+
+namespace
+{
+	constexpr size_t batchSize = 4096;
+
+	// the coefficient and parameter grid of test.cpp
+	constexpr std::array<double, 6> coeffValues{ -10000, -10, -0.01, 0.01, 10, 10000 };
+	constexpr std::array<double, 6> paramValues{ -10000, -10, -0.01, 0.01, 10, 10000 };
+
+	// |x / a| ranges: everything finite, close to the cosh overflow, past it
+	enum region { regular, near_overflow, overflow };
+	constexpr std::array<std::array<double, 2>, 3> regionBounds{ {
+		{ 0, 20 }, { 300, 710 }, { 710, 2000 }
+	} };
+
+	std::vector<double> abscissae(double x_max, size_t n = batchSize) {
+		std::mt19937_64 gen(42);
+		std::uniform_real_distribution<double> dist(-x_max, x_max);
+		std::vector<double> xs(n);
+		for (auto& x : xs) x = dist(gen);
+		return xs;
+	}
+
+	// n abscissae with |x / a| uniformly distributed over the region, random sign
+	std::vector<double> abscissae(double a, region r, size_t n = batchSize) {
+		std::mt19937_64 gen(42);
+		std::uniform_real_distribution<double> dist(regionBounds[r][0], regionBounds[r][1]);
+		std::bernoulli_distribution sign;
+		std::vector<double> xs(n);
+		for (auto& x : xs) x = (sign(gen) ? -1 : 1) * dist(gen) * std::abs(a);
+		return xs;
+	}
+
+	// state.range(0) indexes coeffValues, state.range(1) is the region
+	double coefficient(const benchmark::State& state) {
+		return coeffValues[static_cast<size_t>(state.range(0))];
+	}
+
+	region regionOf(const benchmark::State& state) {
+		return static_cast<region>(state.range(1));
+	}
+
+	void gridArgs(benchmark::internal::Benchmark* b) {
+		for (int64_t coeff = 0; coeff < static_cast<int64_t>(coeffValues.size()); ++coeff)
+			for (int64_t r = regular; r <= overflow; ++r)
+				b->Args({ coeff, r });
+		b->ArgNames({ "coeff", "region" });
+	}
+
+	void finish(benchmark::State& state, size_t perIteration) {
+		state.SetItemsProcessed(state.iterations() * perIteration);
+		state.SetBytesProcessed(state.iterations() * perIteration * sizeof(double));
+	}
+
+	// ---- construction, one curve per coefficient of the grid as the tests do
+
+	void BM_Construct(benchmark::State& state) {
+		for (auto _ : state)
+			for (double a : coeffValues) {
+				curve::Catenary c(a);
+				benchmark::DoNotOptimize(c);
+			}
+
+		state.SetItemsProcessed(state.iterations() * coeffValues.size());
+	}
+
+	void BM_Make(benchmark::State& state) {
+		for (auto _ : state)
+			for (double a : coeffValues) {
+				const std::optional<curve::Catenary> c = curve::Catenary::make(a);
+				benchmark::DoNotOptimize(c);
+			}
+
+		state.SetItemsProcessed(state.iterations() * coeffValues.size());
+	}
+
+	void BM_SetA(benchmark::State& state) {
+		curve::Catenary c;
+
+		for (auto _ : state)
+			for (double a : coeffValues) {
+				c.set_a(a);
+				benchmark::DoNotOptimize(c);
+			}
+
+		state.SetItemsProcessed(state.iterations() * coeffValues.size());
+	}
+
+	// ---- scalar methods
+
+	template <double (curve::Catenary::*method)(double) const>
+	void BM_Method(benchmark::State& state) {
+		const curve::Catenary c(coefficient(state));
+		const std::vector<double> xs = abscissae(c.get_a(), regionOf(state));
+
+		for (auto _ : state)
+			for (double x : xs)
+				benchmark::DoNotOptimize((c.*method)(x));
+
+		finish(state, xs.size());
+	}
+
+	void BM_S(benchmark::State& state) {
+		const curve::Catenary c(coefficient(state));
+		const std::vector<double> xs = abscissae(c.get_a(), regionOf(state));
+
+		for (auto _ : state)
+			for (size_t i = 1; i < xs.size(); ++i)
+				benchmark::DoNotOptimize(c.S(xs[i - 1], xs[i]));
+
+		finish(state, xs.size() - 1);
+	}
+
+	void BM_CurvatureCenterCoords(benchmark::State& state) {
+		const curve::Catenary c(coefficient(state));
+		const std::vector<double> xs = abscissae(c.get_a(), regionOf(state));
+
+		for (auto _ : state)
+			for (double x : xs)
+				benchmark::DoNotOptimize(c.CurvatureCenterCoords(x));
+
+		finish(state, xs.size());
+	}
+
+	// the exact cells of the test.cpp grid, overflowing ones included
+	void BM_TestGrid(benchmark::State& state) {
+		std::vector<curve::Catenary> curves(coeffValues.begin(), coeffValues.end());
+
+		for (auto _ : state)
+			for (const auto& c : curves)
+				for (double x : paramValues) {
+					benchmark::DoNotOptimize(c.y(x));
+					benchmark::DoNotOptimize(c.l(x));
+					benchmark::DoNotOptimize(c.R(x));
+					benchmark::DoNotOptimize(c.S(x, -x));
+					benchmark::DoNotOptimize(c.CurvatureCenterCoords(x));
+				}
+
+		state.SetItemsProcessed(state.iterations() * curves.size() * paramValues.size() * 5);
+	}
+
+	// ---- batch methods
+
+	template <void (curve::Catenary::*method)(const double*, double*, size_t) const>
+	void BM_Batch(benchmark::State& state) {
+		const curve::Catenary c(coefficient(state));
+		const std::vector<double> xs = abscissae(c.get_a(), regionOf(state));
+		std::vector<double> out(xs.size());
+
+		for (auto _ : state) {
+			(c.*method)(xs.data(), out.data(), xs.size());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, xs.size());
+	}
+
+	// the same through each instruction set's kernels, state.range(0)
+	// indexes isaNames; a set the CPU lacks is skipped
+	constexpr std::array<const char*, 4> isaNames{ "scalar", "sse2", "avx2", "avx512" };
+
+	template <void (curve::Catenary::*method)(const double*, double*, size_t) const>
+	void BM_BatchIsa(benchmark::State& state) {
+		const std::string started = curve::kernels::isa_name();
+		if (!curve::kernels::select_isa(isaNames[static_cast<size_t>(state.range(0))])) {
+			state.SkipWithError("instruction set not available");
+			return;
+		}
+
+		const curve::Catenary c(10);
+		const std::vector<double> xs = abscissae(c.get_a(), regular);
+		std::vector<double> out(xs.size());
+
+		for (auto _ : state) {
+			(c.*method)(xs.data(), out.data(), xs.size());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		curve::kernels::select_isa(started.c_str());
+		finish(state, xs.size());
+	}
+
+	void BM_BatchS(benchmark::State& state) {
+		const curve::Catenary c(coefficient(state));
+		const std::vector<double> xs = abscissae(c.get_a(), regionOf(state)),
+			x2s(xs.rbegin(), xs.rend());
+		std::vector<double> out(xs.size());
+
+		for (auto _ : state) {
+			c.S(xs.data(), x2s.data(), out.data(), xs.size());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, xs.size());
+	}
+
+	void BM_BatchCurvatureCenterCoords(benchmark::State& state) {
+		const curve::Catenary c(coefficient(state));
+		const std::vector<double> xs = abscissae(c.get_a(), regionOf(state));
+		curve::CoordBuffer first(xs.size()), second(xs.size());
+
+		for (auto _ : state) {
+			c.CurvatureCenterCoords(xs.data(), first.view(), second.view());
+			benchmark::DoNotOptimize(first.xs());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, xs.size());
+	}
+
+	void BM_BatchEvaluate(benchmark::State& state) {
+		const curve::Catenary c(coefficient(state));
+		const std::vector<double> xs = abscissae(c.get_a(), regionOf(state));
+		std::vector<curve::Catenary::point> out(xs.size());
+
+		for (auto _ : state) {
+			c.evaluate(xs.data(), out.data(), xs.size());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, xs.size());
+	}
+
+	template <void (curve::Catenary::*method)(const double*, curve::scaled*, size_t) const>
+	void BM_BatchScaled(benchmark::State& state) {
+		const curve::Catenary c(coefficient(state));
+		const std::vector<double> xs = abscissae(c.get_a(), regionOf(state));
+		std::vector<curve::scaled> out(xs.size());
+
+		for (auto _ : state) {
+			(c.*method)(xs.data(), out.data(), xs.size());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, xs.size());
+	}
+
+	// ---- precision: the batch forms in float, double and long double, each
+	// reporting its worst error in ulps of its own type (max_ulp) against
+	// cosh and sinh in long double from the same T inputs; where long double
+	// is double (MSVC) the double rows compare with themselves
+
+	enum method { ordinate, arc_length, curvature_radius };
+
+	long double exact(method m, long double a, long double x) {
+		const long double u = x / a;
+		switch (m) {
+		case ordinate: return a * std::cosh(u);
+		case arc_length: return a * std::sinh(u);
+		default: return a * std::cosh(u) * std::cosh(u);
+		}
+	}
+
+	// |got - exact| in ulps of T at exact, 0 where both are the same infinity
+	template <class T>
+	double ulps(T got, long double exact) {
+		if (got == exact) return 0;
+		const T near = static_cast<T>(exact);
+		const long double ulp = std::nextafter(std::abs(near), std::numeric_limits<T>::infinity()) - std::abs(near);
+		return static_cast<double>(std::abs(got - exact) / ulp);
+	}
+
+	template <class T, method m>
+	void BM_Typed(benchmark::State& state) {
+		const curve::BasicCatenary<T> c = *curve::BasicCatenary<T>::make(static_cast<T>(coefficient(state)));
+		const std::vector<double> xs = abscissae(c.get_a(), regular);
+		const std::vector<T> txs(xs.begin(), xs.end());
+		std::vector<T> out(txs.size());
+
+		for (auto _ : state) {
+			switch (m) {
+			case ordinate: c.y(txs.data(), out.data(), txs.size()); break;
+			case arc_length: c.l(txs.data(), out.data(), txs.size()); break;
+			default: c.R(txs.data(), out.data(), txs.size()); break;
+			}
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		double worst = 0;
+		for (size_t i = 0; i < txs.size(); ++i)
+			worst = std::max(worst, ulps(out[i], exact(m, c.get_a(), txs[i])));
+		state.counters["max_ulp"] = worst;
+		state.SetItemsProcessed(state.iterations() * txs.size());
+		state.SetBytesProcessed(state.iterations() * txs.size() * sizeof(T));
+	}
+
+	// double in and out within 10^-range(1) relative, |x / a| < 4 so float
+	// qualifies from 1e-5 on; max_ulp is in double ulps
+	template <method m>
+	void BM_Tolerance(benchmark::State& state) {
+		const curve::Catenary c(coefficient(state));
+		const double tolerance = std::pow(10.0, -static_cast<double>(state.range(1)));
+		std::vector<double> xs = abscissae(c.get_a(), regular);
+		for (double& x : xs) x /= 5;
+		std::vector<double> out(xs.size());
+
+		for (auto _ : state) {
+			switch (m) {
+			case ordinate: c.y(xs.data(), out.data(), xs.size(), tolerance); break;
+			case arc_length: c.l(xs.data(), out.data(), xs.size(), tolerance); break;
+			default: c.R(xs.data(), out.data(), xs.size(), tolerance); break;
+			}
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		double worst = 0;
+		for (size_t i = 0; i < xs.size(); ++i)
+			worst = std::max(worst, ulps(out[i], exact(m, c.get_a(), xs[i])));
+		state.counters["max_ulp"] = worst;
+		finish(state, xs.size());
+	}
+
+	void toleranceArgs(benchmark::internal::Benchmark* b) {
+		for (int64_t coeff = 0; coeff < static_cast<int64_t>(coeffValues.size()); ++coeff)
+			for (int64_t digits : { 4, 6, 15 })
+				b->Args({ coeff, digits });
+		b->ArgNames({ "coeff", "digits" });
+	}
+
+	// ---- many curves, one a per curve, x in the regular region of each
+
+	constexpr size_t fleetSize = 1 << 18;
+
+	std::vector<double> fleetCoefficients() {
+		std::mt19937_64 gen(7);
+		std::uniform_real_distribution<double> dist(0.5, 500);
+		std::vector<double> as(fleetSize);
+		for (auto& a : as) a = dist(gen);
+		return as;
+	}
+
+	std::vector<double> fleetAbscissae(const std::vector<double>& as) {
+		std::vector<double> xs = abscissae(1, fleetSize);
+		for (size_t i = 0; i < xs.size(); ++i) xs[i] *= 20 * as[i];
+		return xs;
+	}
+
+	void BM_FleetVector(benchmark::State& state) {
+		const std::vector<double> as = fleetCoefficients(), xs = fleetAbscissae(as);
+		std::vector<curve::Catenary> curves;
+		for (double a : as) curves.push_back(curve::Catenary(a));
+		std::vector<double> out(fleetSize);
+
+		for (auto _ : state) {
+			for (size_t i = 0; i < fleetSize; ++i) out[i] = curves[i].y(xs[i]);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, fleetSize);
+	}
+
+	void BM_FleetArray(benchmark::State& state) {
+		const std::vector<double> as = fleetCoefficients(), xs = fleetAbscissae(as);
+		const curve::CatenaryArray curves(as.data(), as.size());
+		std::vector<double> out(fleetSize);
+
+		for (auto _ : state) {
+			curves.y(xs.data(), out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, fleetSize);
+	}
+
+	void BM_FleetGather(benchmark::State& state) {
+		const std::vector<double> as = fleetCoefficients();
+		const curve::CatenaryArray curves(as.data(), as.size());
+		std::mt19937_64 gen(11);
+		std::uniform_int_distribution<std::uint32_t> pick(0, fleetSize - 1);
+		std::vector<std::uint32_t> idx(batchSize);
+		std::vector<double> xs(batchSize), out(batchSize);
+		for (size_t k = 0; k < batchSize; ++k) {
+			idx[k] = pick(gen);
+			xs[k] = as[idx[k]] * (static_cast<double>(k % 41) - 20);
+		}
+
+		for (auto _ : state) {
+			curves.y(idx.data(), xs.data(), out.data(), batchSize);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, batchSize);
+	}
+
+	void BM_FleetBuild(benchmark::State& state) {
+		const std::vector<double> as = fleetCoefficients();
+
+		for (auto _ : state) {
+			curve::CatenaryArray curves;
+			for (double a : as) curves.push_back(a);
+			benchmark::DoNotOptimize(curves.a());
+		}
+
+		state.SetItemsProcessed(state.iterations() * fleetSize);
+	}
+
+	// ---- query cache, a warm working set of 1024 queries read by every thread
+
+	curve::QueryCache sharedCache(1 << 14);
+
+	void BM_CachedHit(benchmark::State& state) {
+		const curve::CachedCatenary c(10, sharedCache);
+		const std::vector<double> xs = abscissae(200, 1024);
+		for (double x : xs) c.y(x);
+
+		for (auto _ : state)
+			for (double x : xs)
+				benchmark::DoNotOptimize(c.y(x));
+
+		finish(state, xs.size());
+	}
+
+	void BM_CachedMiss(benchmark::State& state) {
+		curve::QueryCache cache(1024);
+		const curve::CachedCatenary c(10, cache);
+		const std::vector<double> xs = abscissae(200, 1024);
+
+		for (auto _ : state) {
+			cache.clear();
+			for (double x : xs)
+				benchmark::DoNotOptimize(c.y(x));
+		}
+
+		finish(state, xs.size());
+	}
+
+	// ---- instrumentation, the cost a probe adds to what it measures; the
+	// profile is local, the global one exists only with CURVE_INSTRUMENT
+
+	void BM_HistogramRecord(benchmark::State& state) {
+		const std::unique_ptr<instrument::profile> p(new instrument::profile);
+		std::uint64_t ns = 0;
+
+		for (auto _ : state)
+			p->record(instrument::stage::ordinate, ns++ & 0xffff);
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_ProbedMethod(benchmark::State& state) {
+		const std::unique_ptr<instrument::profile> p(new instrument::profile);
+		const curve::Catenary c(10);
+		const std::vector<double> xs = abscissae(c.get_a(), regular);
+
+		for (auto _ : state)
+			for (double x : xs) {
+				const instrument::scope probe(*p, instrument::stage::ordinate);
+				benchmark::DoNotOptimize(c.y(x));
+			}
+
+		finish(state, xs.size());
+	}
+
+	// ---- uniform sweeps, a grid of |x / a| <= 20, by recurrence and by the batch kernel
+
+	void BM_SweepIterator(benchmark::State& state) {
+		const curve::Catenary c(coeffValues[static_cast<size_t>(state.range(0))]);
+		const double h = 40 * std::abs(c.get_a()) / batchSize;
+		const curve::UniformSweep sweep = c.sweep(-20 * std::abs(c.get_a()), h, batchSize);
+		std::vector<double> out(batchSize);
+
+		for (auto _ : state) {
+			double* p = out.data();
+			for (const curve::UniformSweep::point& pt : sweep) *p++ = pt.y;
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, batchSize);
+	}
+
+	void BM_SweepBatch(benchmark::State& state) {
+		const curve::Catenary c(coeffValues[static_cast<size_t>(state.range(0))]);
+		const double h = 40 * std::abs(c.get_a()) / batchSize;
+		const curve::UniformSweep sweep = c.sweep(-20 * std::abs(c.get_a()), h, batchSize);
+		std::vector<double> out(batchSize);
+
+		for (auto _ : state) {
+			sweep.y(out.data());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, batchSize);
+	}
+
+	void BM_SweepKernel(benchmark::State& state) {
+		const curve::Catenary c(coeffValues[static_cast<size_t>(state.range(0))]);
+		const double h = 40 * std::abs(c.get_a()) / batchSize;
+		const curve::UniformSweep sweep = c.sweep(-20 * std::abs(c.get_a()), h, batchSize);
+		std::vector<double> xs(batchSize), out(batchSize);
+		for (size_t i = 0; i < batchSize; ++i) xs[i] = sweep.x(i);
+
+		for (auto _ : state) {
+			c.y(xs.data(), out.data(), xs.size());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, batchSize);
+	}
+
+	// ---- polylines of 1024 curves over |x / a| <= 3 within 1e-3 of the unit a,
+	// state.range(0) is the thread count, 0 for run_serial; arc_step_ratio is
+	// how many times more vertices an even step in arc length would take
+
+	void BM_Polyline(benchmark::State& state) {
+		std::mt19937_64 gen(42);
+		std::uniform_real_distribution<double> dist(0.5, 50);
+		std::vector<curve::PolylineGenerator::span> spans(1024);
+		for (auto& c : spans) {
+			c.a = dist(gen);
+			c.x1 = -3 * c.a;
+			c.x2 = 3 * c.a;
+		}
+
+		const unsigned threads = static_cast<unsigned>(state.range(0));
+		curve::PolylineGenerator polyline(1e-3, std::max(threads, 1u));
+		std::vector<size_t> first(spans.size() + 1);
+		const size_t total = polyline.offsets(spans.data(), spans.size(), first.data());
+		curve::CoordBuffer vertices(total);
+		std::vector<double> s(total);
+
+		for (auto _ : state) {
+			if (threads) polyline.run(spans.data(), spans.size(), first.data(), vertices.view(), s.data());
+			else polyline.run_serial(spans.data(), spans.size(), first.data(), vertices.view(), s.data());
+			benchmark::DoNotOptimize(s.data());
+			benchmark::ClobberMemory();
+		}
+
+		double even = 0;
+		for (size_t i = 0; i < spans.size(); ++i) even += s[first[i + 1] - 1] / polyline.step(spans[i].a);
+		state.counters["arc_step_ratio"] = even / total;
+		finish(state, total);
+	}
+
+	// ---- inverse queries, the inputs are the forward results over the regular region
+
+	template <double (curve::Catenary::*forward)(double) const>
+	std::vector<double> forwardValues(const curve::Catenary& c) {
+		std::vector<double> vs = abscissae(c.get_a(), regular);
+		for (auto& v : vs) v = (c.*forward)(v);
+		return vs;
+	}
+
+	template <double (curve::Catenary::*forward)(double) const, double (curve::Catenary::*inverse)(double) const>
+	void BM_InverseMethod(benchmark::State& state) {
+		const curve::Catenary c(coeffValues[static_cast<size_t>(state.range(0))]);
+		const std::vector<double> vs = forwardValues<forward>(c);
+
+		for (auto _ : state)
+			for (double v : vs) benchmark::DoNotOptimize((c.*inverse)(v));
+
+		finish(state, vs.size());
+	}
+
+	template <double (curve::Catenary::*forward)(double) const,
+		void (curve::Catenary::*inverse)(const double*, double*, size_t) const>
+	void BM_InverseBatch(benchmark::State& state) {
+		const curve::Catenary c(coeffValues[static_cast<size_t>(state.range(0))]);
+		const std::vector<double> vs = forwardValues<forward>(c);
+		std::vector<double> out(vs.size());
+
+		for (auto _ : state) {
+			(c.*inverse)(vs.data(), out.data(), vs.size());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, vs.size());
+	}
+
+	void BM_InverseArea(benchmark::State& state) {
+		const curve::Catenary c(coeffValues[static_cast<size_t>(state.range(0))]);
+		const std::vector<double> x1s = abscissae(c.get_a(), regular),
+			Ss = forwardValues<&curve::Catenary::l>(c);
+		std::vector<double> out(x1s.size());
+
+		for (auto _ : state) {
+			c.x2_of_S(x1s.data(), Ss.data(), out.data(), x1s.size());
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, x1s.size());
+	}
+
+	// sag / span from 1e-6 to 1e3, log-uniform
+	void BM_FitA(benchmark::State& state) {
+		std::mt19937_64 gen(42);
+		std::uniform_real_distribution<double> dist(-6, 3);
+		std::vector<double> spans(batchSize, 10.0), sags(batchSize), out(batchSize);
+		for (auto& sag : sags) sag = 10 * std::pow(10.0, dist(gen));
+
+		for (auto _ : state) {
+			curve::Catenary::fit_a(spans.data(), sags.data(), out.data(), batchSize);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, batchSize);
+	}
+
+	// batchSize spans 0.1 to 1e3 wide at slopes up to 5 either way, the
+	// length 1e-8 to 10 of the chord beyond it, or the sag 1e-5 to 10 of the
+	// width; state.range(0) is 0 to fit the length, 1 the sag
+	void BM_Fit(benchmark::State& state) {
+		std::mt19937_64 gen(42);
+		std::uniform_real_distribution<double> unit(0, 1);
+		std::vector<curve::ShiftedCatenary::span> spans(batchSize);
+		std::vector<double> targets(batchSize);
+		std::vector<curve::ShiftedCatenary> out(batchSize);
+		for (size_t i = 0; i < batchSize; ++i) {
+			const double h = std::pow(10.0, 4 * unit(gen) - 1), v = h * (10 * unit(gen) - 5);
+			spans[i] = curve::ShiftedCatenary::span{ -h / 2, 0, h / 2, v };
+			targets[i] = state.range(0) ? h * std::pow(10.0, 6 * unit(gen) - 5)
+				: std::hypot(h, v) * (1 + std::pow(10.0, 9 * unit(gen) - 8));
+		}
+
+		for (auto _ : state) {
+			if (state.range(0)) curve::ShiftedCatenary::fit_sag(spans.data(), targets.data(), out.data(), batchSize);
+			else curve::ShiftedCatenary::fit_length(spans.data(), targets.data(), out.data(), batchSize);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, batchSize);
+	}
+
+	// ---- integrals over batchSize intervals of a = 10, x1 in the regular
+	// region and state.range(0) / 10 of |a| wide
+
+	std::pair<std::vector<double>, std::vector<double>> intervals(double a, double width) {
+		std::vector<double> x1s = abscissae(a, regular), x2s(x1s.size());
+		for (size_t i = 0; i < x1s.size(); ++i) x2s[i] = x1s[i] + width * std::abs(a);
+		return std::make_pair(std::move(x1s), std::move(x2s));
+	}
+
+	template <void (curve::Integrator::*method)(const double*, const double*, double*, size_t) const>
+	void BM_ClosedIntegral(benchmark::State& state) {
+		const curve::Integrator integrals(10);
+		const auto ends = intervals(integrals.get_a(), state.range(0) / 10.0);
+		std::vector<double> out(batchSize);
+
+		for (auto _ : state) {
+			(integrals.*method)(ends.first.data(), ends.second.data(), out.data(), batchSize);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, batchSize);
+	}
+
+	// the x2_ds integrand by quadrature, to set against its closed form
+	void BM_Quadrature(benchmark::State& state) {
+		const curve::Integrator integrals(10);
+		const auto ends = intervals(integrals.get_a(), state.range(0) / 10.0);
+		std::vector<double> out(batchSize);
+
+		for (auto _ : state) {
+			integrals.integrate(ends.first.data(), ends.second.data(), out.data(), batchSize,
+				[](const curve::Integrator::nodes& at, double* values) {
+					for (size_t j = 0; j < at.n; ++j) values[j] = at.x[j] * at.x[j];
+				});
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		finish(state, batchSize);
+	}
+
+	// ---- the double-double reference, what each query sampled by --verify
+	// costs on top; compare with the coeff:4 (a = 10) rows above, state.range(0)
+	// is the region
+
+	template <double (curve::ReferenceCatenary::*method)(double) const>
+	void BM_Reference(benchmark::State& state) {
+		const curve::ReferenceCatenary c(10);
+		const std::vector<double> xs = abscissae(c.get_a(), static_cast<region>(state.range(0)));
+
+		for (auto _ : state)
+			for (double x : xs)
+				benchmark::DoNotOptimize((c.*method)(x));
+
+		finish(state, xs.size());
+	}
+
+	// ---- a fixed at compile time, compare with the coeff:4 (a = 10) rows above;
+	// state.range(0) is the region
+
+	typedef curve::StaticCatenary<10> StaticTen;
+
+	template <double (StaticTen::*method)(double) const>
+	void BM_StaticMethod(benchmark::State& state) {
+		const StaticTen c;
+		const std::vector<double> xs = abscissae(c.get_a(), static_cast<region>(state.range(0)));
+
+		for (auto _ : state)
+			for (double x : xs)
+				benchmark::DoNotOptimize((c.*method)(x));
+
+		finish(state, xs.size());
+	}
+
+	// a 256-point table of y over [-20, 20) built by the compiler, against the same
+	// table filled at runtime (which is what it costs on every program start)
+	constexpr size_t tableSize = 256;
+	constexpr double tableStep = 40.0 / tableSize;
+
+	void BM_StaticTable(benchmark::State& state) {
+		for (auto _ : state) {
+			static constexpr auto table = curve::tabulate<tableSize>([](double x) { return StaticTen().y(x); }, -20, tableStep);
+			benchmark::DoNotOptimize(table.data());
+		}
+	}
+
+	void BM_RuntimeTable(benchmark::State& state) {
+		const curve::Catenary c(10);
+		std::array<double, tableSize> table;
+
+		for (auto _ : state) {
+			for (size_t i = 0; i < tableSize; ++i)
+				table[i] = c.y(-20 + static_cast<double>(i) * tableStep);
+			benchmark::DoNotOptimize(table.data());
+			benchmark::ClobberMemory();
+		}
+	}
+
+	// ---- tabulated curve, state.range(0) is -log10 of the table's max relative error
+
+	double tolerance(const benchmark::State& state) {
+		return std::pow(10.0, -static_cast<double>(state.range(0)));
+	}
+
+	template <double (curve::Catenary::*method)(double) const>
+	void BM_Direct(benchmark::State& state) {
+		const curve::Catenary c(10);
+		const std::vector<double> xs = abscissae(200);
+
+		for (auto _ : state)
+			for (double x : xs)
+				benchmark::DoNotOptimize((c.*method)(x));
+
+		finish(state, xs.size());
+	}
+
+	template <double (curve::TabulatedCatenary::*method)(double) const>
+	void BM_Tabulated(benchmark::State& state) {
+		const curve::TabulatedCatenary t(10, -200, 200, tolerance(state));
+		const std::vector<double> xs = abscissae(200);
+
+		for (auto _ : state)
+			for (double x : xs)
+				benchmark::DoNotOptimize((t.*method)(x));
+
+		finish(state, xs.size());
+		state.counters["nodes"] = static_cast<double>(t.nodes());
+	}
+
+	void BM_TabulatedBuild(benchmark::State& state) {
+		for (auto _ : state) {
+			curve::TabulatedCatenary t(10, -200, 200, tolerance(state));
+			benchmark::DoNotOptimize(t.nodes());
+		}
+	}
+
+	// ---- --batch streams: 2^16 text records, runs of 64 sharing a and op,
+	// through the serial loop and through the pipeline with range(0) workers
+
+	std::FILE* batchInput() {
+		std::mt19937_64 gen(3);
+		std::uniform_real_distribution<double> dist(-20, 20);
+		std::string text;
+		char line[96];
+		for (size_t i = 0; i < (1 << 16); ++i) {
+			const int op = batch::get_ordinate + static_cast<int>(i / 64 % 5);
+			const double a = 1 + static_cast<double>(i / 320 % 7), x = a * dist(gen);
+			std::snprintf(line, sizeof(line), op == batch::get_trapeze_area ? "%g %d %.9g %.9g\n" : "%g %d %.9g\n",
+				a, op, x, -x / 2);
+			text += line;
+		}
+		std::FILE* const f = std::tmpfile();
+		std::fwrite(text.data(), 1, text.size(), f);
+		return f;
+	}
+
+	template <bool pipelined>
+	void BM_BatchStream(benchmark::State& state) {
+		std::FILE* const in = batchInput();
+		std::FILE* const out = std::tmpfile();
+		batch::stats s{};
+
+		for (auto _ : state) {
+			std::rewind(in);
+			std::rewind(out);
+			s = pipelined
+				? batch::run_parallel(in, out, batch::format::text, static_cast<unsigned>(state.range(0)))
+				: batch::run(in, out, batch::format::text);
+		}
+
+		std::fclose(in);
+		std::fclose(out);
+		state.SetItemsProcessed(state.iterations() * s.records);
+	}
+
+	// ---- console input
+
+	class null_wbuf : public std::wstreambuf {
+	protected:
+		int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+		std::streamsize xsputn(const wchar_t*, std::streamsize n) override { return n; }
+	};
+
+	// feeds `lines` through sfio::safe_cin from a temporary file, std::wcout muted
+	template <class T, class Read>
+	void safeCinBench(benchmark::State& state, const std::string& line, Read read) {
+		constexpr size_t lines = 1024;
+		std::string input;
+		for (size_t i = 0; i < lines; ++i) input += line;
+
+		std::FILE* const source = std::tmpfile();
+		std::fwrite(input.data(), 1, input.size(), source);
+
+		null_wbuf sink;
+		std::wstreambuf* const wout = std::wcout.rdbuf(&sink);
+		std::FILE* const in = sfio::input();
+		sfio::input() = source;
+
+		for (auto _ : state) {
+			state.PauseTiming();
+			std::rewind(source);
+			state.ResumeTiming();
+
+			T value;
+			for (size_t i = 0; i < lines; ++i) {
+				read(value);
+				benchmark::DoNotOptimize(value);
+			}
+		}
+
+		sfio::input() = in;
+		std::wcout.rdbuf(wout);
+		std::fclose(source);
+		state.SetItemsProcessed(state.iterations() * lines);
+		state.SetBytesProcessed(state.iterations() * input.size());
+	}
+
+	void BM_SafeCinDouble(benchmark::State& state) {
+		safeCinBench<double>(state, "-1234.56789e-3\n", [](double& v) {
+			sfio::safe_cin(L"", v);
+		});
+	}
+
+	void BM_SafeCinRange(benchmark::State& state) {
+		safeCinBench<int>(state, "4\n", [](int& v) {
+			sfio::safe_cin(L"", v, 1, 6);
+		});
+	}
+
+	void BM_SafeCinExcept(benchmark::State& state) {
+		safeCinBench<double>(state, "10.5\n", [](double& v) {
+			sfio::safe_cin(L"", v, std::initializer_list<double>{ 0 });
+		});
+	}
+
+	// ---- number conversion, iostreams against <charconv>
+
+	std::string numberText(size_t n = batchSize) {
+		std::string text;
+		for (double x : abscissae(1e4, n)) {
+			text += std::to_string(x);
+			text += '\n';
+		}
+		return text;
+	}
+
+	void BM_IstreamParse(benchmark::State& state) {
+		const std::string text = numberText();
+
+		for (auto _ : state) {
+			std::istringstream in(text);
+			double v;
+			while (in >> v) benchmark::DoNotOptimize(v);
+		}
+
+		state.SetItemsProcessed(state.iterations() * batchSize);
+		state.SetBytesProcessed(state.iterations() * text.size());
+	}
+
+	void BM_CharconvParse(benchmark::State& state) {
+		std::string text = numberText();
+
+		for (auto _ : state) {
+			const char* p = text.data();
+			const char* const end = p + text.size();
+			while (p != end) {
+				const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+				double v;
+				sfio::parse(p, nl, v);
+				benchmark::DoNotOptimize(v);
+				p = nl + 1;
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * batchSize);
+		state.SetBytesProcessed(state.iterations() * text.size());
+	}
+
+	void BM_OstreamFormat(benchmark::State& state) {
+		const std::vector<double> xs = abscissae(1e4);
+
+		for (auto _ : state) {
+			std::ostringstream out;
+			for (double x : xs) out << x << '\n';
+			benchmark::DoNotOptimize(out.str().size());
+		}
+
+		state.SetItemsProcessed(state.iterations() * xs.size());
+	}
+
+	void BM_CharconvFormat(benchmark::State& state) {
+		const std::vector<double> xs = abscissae(1e4);
+		std::vector<char> out(xs.size() * sfio::max_chars);
+
+		for (auto _ : state) {
+			char* p = out.data();
+			for (double x : xs) {
+				p = sfio::format(p, out.data() + out.size(), x, 6);
+				*p++ = '\n';
+			}
+			benchmark::DoNotOptimize(p);
+		}
+
+		state.SetItemsProcessed(state.iterations() * xs.size());
+	}
+}
+
+BENCHMARK(BM_Construct);
+BENCHMARK(BM_Make);
+BENCHMARK(BM_SetA);
+
+BENCHMARK_TEMPLATE(BM_Method, &curve::Catenary::y)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_Method, &curve::Catenary::l)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_Method, &curve::Catenary::R)->Apply(gridArgs);
+BENCHMARK(BM_S)->Apply(gridArgs);
+BENCHMARK(BM_CurvatureCenterCoords)->Apply(gridArgs);
+BENCHMARK(BM_TestGrid);
+
+BENCHMARK_TEMPLATE(BM_Batch, &curve::Catenary::y)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_Batch, &curve::Catenary::l)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_Batch, &curve::Catenary::R)->Apply(gridArgs);
+BENCHMARK(BM_BatchS)->Apply(gridArgs);
+BENCHMARK(BM_BatchCurvatureCenterCoords)->Apply(gridArgs);
+BENCHMARK(BM_BatchEvaluate)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_BatchIsa, &curve::Catenary::y)->DenseRange(0, 3)->ArgName("isa");
+BENCHMARK_TEMPLATE(BM_BatchIsa, &curve::Catenary::l)->DenseRange(0, 3)->ArgName("isa");
+
+BENCHMARK_TEMPLATE(BM_Method, &curve::Catenary::log_y)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_Method, &curve::Catenary::log_R)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_Batch, &curve::Catenary::log_y)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_Batch, &curve::Catenary::log_R)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_BatchScaled, &curve::Catenary::scaled_y)->Apply(gridArgs);
+BENCHMARK_TEMPLATE(BM_BatchScaled, &curve::Catenary::scaled_R)->Apply(gridArgs);
+
+BENCHMARK_TEMPLATE(BM_Typed, float, ordinate)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_Typed, double, ordinate)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_Typed, long double, ordinate)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_Typed, float, arc_length)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_Typed, double, arc_length)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_Typed, long double, arc_length)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_Typed, float, curvature_radius)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_Typed, double, curvature_radius)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_Typed, long double, curvature_radius)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_Tolerance, ordinate)->Apply(toleranceArgs);
+BENCHMARK_TEMPLATE(BM_Tolerance, arc_length)->Apply(toleranceArgs);
+BENCHMARK_TEMPLATE(BM_Tolerance, curvature_radius)->Apply(toleranceArgs);
+
+BENCHMARK(BM_FleetVector)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FleetArray)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FleetGather);
+BENCHMARK(BM_FleetBuild)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_CachedHit)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_CachedMiss);
+
+BENCHMARK(BM_HistogramRecord)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ProbedMethod);
+
+BENCHMARK(BM_SweepIterator)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK(BM_SweepBatch)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK(BM_SweepKernel)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK(BM_Polyline)->Arg(0)->Arg(1)->Arg(4)->ArgName("threads")->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_InverseMethod, &curve::Catenary::y, &curve::Catenary::x_of_y)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_InverseMethod, &curve::Catenary::l, &curve::Catenary::x_of_l)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_InverseBatch, &curve::Catenary::y, &curve::Catenary::x_of_y)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK_TEMPLATE(BM_InverseBatch, &curve::Catenary::l, &curve::Catenary::x_of_l)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK(BM_InverseArea)->DenseRange(0, 5)->ArgName("coeff");
+BENCHMARK(BM_FitA);
+BENCHMARK(BM_Fit)->Arg(0)->Arg(1)->ArgName("sag");
+
+BENCHMARK_TEMPLATE(BM_ClosedIntegral, &curve::Integrator::y2_dx)->Arg(5)->ArgName("width");
+BENCHMARK_TEMPLATE(BM_ClosedIntegral, &curve::Integrator::x2_ds)->Arg(5)->ArgName("width");
+BENCHMARK_TEMPLATE(BM_ClosedIntegral, &curve::Integrator::y2_ds)->Arg(5)->ArgName("width");
+BENCHMARK(BM_Quadrature)->Arg(5)->Arg(40)->ArgName("width");
+
+BENCHMARK_TEMPLATE(BM_Reference, &curve::ReferenceCatenary::y)->DenseRange(regular, overflow)->ArgName("region");
+BENCHMARK_TEMPLATE(BM_Reference, &curve::ReferenceCatenary::l)->DenseRange(regular, overflow)->ArgName("region");
+BENCHMARK_TEMPLATE(BM_Reference, &curve::ReferenceCatenary::R)->DenseRange(regular, overflow)->ArgName("region");
+
+BENCHMARK_TEMPLATE(BM_StaticMethod, &StaticTen::y)->DenseRange(regular, overflow)->ArgName("region");
+BENCHMARK_TEMPLATE(BM_StaticMethod, &StaticTen::l)->DenseRange(regular, overflow)->ArgName("region");
+BENCHMARK_TEMPLATE(BM_StaticMethod, &StaticTen::R)->DenseRange(regular, overflow)->ArgName("region");
+BENCHMARK(BM_StaticTable);
+BENCHMARK(BM_RuntimeTable);
+
+BENCHMARK_TEMPLATE(BM_Direct, &curve::Catenary::y);
+BENCHMARK_TEMPLATE(BM_Tabulated, &curve::TabulatedCatenary::y)->DenseRange(6, 14, 4);
+BENCHMARK_TEMPLATE(BM_Direct, &curve::Catenary::l);
+BENCHMARK_TEMPLATE(BM_Tabulated, &curve::TabulatedCatenary::l)->DenseRange(6, 14, 4);
+BENCHMARK_TEMPLATE(BM_Direct, &curve::Catenary::R);
+BENCHMARK_TEMPLATE(BM_Tabulated, &curve::TabulatedCatenary::R)->DenseRange(6, 14, 4);
+BENCHMARK(BM_TabulatedBuild)->DenseRange(6, 14, 4)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(BM_BatchStream, false)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_BatchStream, true)->RangeMultiplier(2)->Range(1, 8)->ArgName("workers")
+	->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK(BM_SafeCinDouble);
+BENCHMARK(BM_SafeCinRange);
+BENCHMARK(BM_SafeCinExcept);
+
+BENCHMARK(BM_IstreamParse);
+BENCHMARK(BM_CharconvParse);
+BENCHMARK(BM_OstreamFormat);
+BENCHMARK(BM_CharconvFormat);
+
+int main(int argc, char** argv)
+{
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+	benchmark::AddCustomContext("isa", curve::kernels::isa_name());
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,188 @@
+#include "pch.h"
+#include "Catenary.h"
+#include "BasicCatenary.h"
+#include "ReferenceCatenary.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <vector>
+
+// Random (a, x) samples through the batch kernels on every core, each result
+// set against ReferenceCatenary from the same inputs. Every method prints its
+// worst error in ulps and the kernel throughput, and fails on any sample off
+// by more than a few ulps plus what the rounding of x / a alone costs.
+// $CURVE_PROPERTY_SAMPLES sets the samples per method (default 2^22).
+
+namespace
+{
+	// samples per task, all with one a: the batch methods take one curve
+	constexpr std::size_t block = 4096;
+
+	enum method { ordinate, arc_length, curvature_radius, area };
+	const char* const methodNames[] = { "y", "l", "R", "S" };
+
+	std::size_t sampleCount()
+	{
+		const char* s = std::getenv("CURVE_PROPERTY_SAMPLES");
+		const long long n = s ? std::atoll(s) : 0;
+		return n > 0 ? static_cast<std::size_t>(n) : std::size_t(1) << 22;
+	}
+
+	// the batch methods of double are Catenary's own
+	template <class T> struct curve_of { typedef curve::BasicCatenary<T> type; };
+	template <> struct curve_of<double> { typedef curve::Catenary type; };
+
+	template <class T>
+	void evaluate(method m, const typename curve_of<T>::type& c, const T* x1s, const T* xs, T* out, std::size_t n)
+	{
+		switch (m)
+		{
+		case ordinate: c.y(xs, out, n); break;
+		case arc_length: c.l(xs, out, n); break;
+		case curvature_radius: c.R(xs, out, n); break;
+		case area: c.S(x1s, xs, out, n); break;
+		}
+	}
+
+	// the correctly rounded result and the magnitude its error is measured
+	// against: the result itself, or for S the two terms it is the difference of
+	struct reference
+	{
+		double value, scale;
+	};
+
+	reference exact(method m, double a, double x1, double x)
+	{
+		const curve::ReferenceCatenary r(a);
+		switch (m)
+		{
+		case ordinate: return { r.y(x), r.y(x) };
+		case arc_length: return { r.l(x), r.l(x) };
+		case curvature_radius: return { r.R(x), r.R(x) };
+		default: return { r.S(x1, x), std::abs(a) * (std::abs(r.l(x1)) + std::abs(r.l(x))) };
+		}
+	}
+
+	// |got - exact| in ulps of T at scale
+	template <class T>
+	double ulps(T got, const reference& r)
+	{
+		if (got == r.value) return 0;
+		const T near = static_cast<T>(std::abs(r.scale));
+		const double ulp = static_cast<double>(std::nextafter(near, std::numeric_limits<T>::infinity())) - near;
+		return std::abs(got - r.value) / ulp;
+	}
+
+	struct outcome
+	{
+		std::size_t samples = 0, failures = 0;
+		double worst = 0, worst_a = 0, worst_x = 0;
+		std::chrono::nanoseconds kernel{ 0 };
+	};
+
+	// |x / a| up to u_max, |a| log-uniform over [1e-3, 1e3]; slack is the
+	// allowance in ulps on top of 2 (|u| + 1), the condition of cosh and sinh
+	// at u times the half ulp of x / a, doubled for R
+	template <class T>
+	outcome check(curve::ThreadPool& pool, method m, std::size_t samples, double u_max, double slack)
+	{
+		outcome total;
+		std::mutex merge;
+
+		pool.parallel_for((samples + block - 1) / block, [&](std::size_t task)
+		{
+			std::mt19937_64 gen(task * 4 + m);
+			std::uniform_real_distribution<double> exponent(-3, 3), us(-u_max, u_max);
+			const T a = static_cast<T>((gen() & 1 ? -1 : 1) * std::pow(10.0, exponent(gen)));
+			const typename curve_of<T>::type c = *curve_of<T>::type::make(a);
+
+			const std::size_t n = std::min(block, samples - task * block);
+			std::vector<T> x1s(n), xs(n), out(n);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				x1s[i] = static_cast<T>(us(gen) * std::abs(a));
+				xs[i] = static_cast<T>(us(gen) * std::abs(a));
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			evaluate<T>(m, c, x1s.data(), xs.data(), out.data(), n);
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+
+			outcome local;
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				const double e = ulps(out[i], exact(m, a, x1s[i], xs[i]));
+				const double u = std::max(std::abs(xs[i] / a), m == area ? std::abs(x1s[i] / a) : T(0));
+				if (!(e <= slack + (m == curvature_radius ? 4 : 2) * (u + 1))) ++local.failures;
+				if (!(e <= local.worst))
+				{
+					local.worst = e;
+					local.worst_a = a;
+					local.worst_x = xs[i];
+				}
+			}
+
+			const std::lock_guard<std::mutex> lock(merge);
+			total.samples += n;
+			total.failures += local.failures;
+			total.kernel += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+			if (!(local.worst <= total.worst))
+			{
+				total.worst = local.worst;
+				total.worst_a = local.worst_a;
+				total.worst_x = local.worst_x;
+			}
+		});
+
+		return total;
+	}
+
+	void report(const char* type, method m, const outcome& r, unsigned threads)
+	{
+		const double seconds = std::chrono::duration<double>(r.kernel).count();
+		std::printf("[ PROPERTY ] %s %s: %zu samples, max %.2f ulp (a = %g, x = %g), "
+			"%.1f M/s per thread on %u threads\n",
+			type, methodNames[m], r.samples, r.worst, r.worst_a, r.worst_x,
+			seconds > 0 ? r.samples / seconds * 1e-6 : 0.0, threads);
+	}
+}
+
+TEST(PropertyTest, DoubleKernelsCheck)
+{
+	curve::ThreadPool pool;
+	const std::size_t samples = sampleCount();
+
+	for (const method m : { ordinate, arc_length, curvature_radius, area })
+	{
+		const outcome r = check<double>(pool, m, samples, 40, 4);
+		report("double", m, r, pool.size());
+		EXPECT_EQ(samples, r.samples);
+		EXPECT_EQ(0u, r.failures) << methodNames[m] << ": worst " << r.worst
+			<< " ulp at a = " << r.worst_a << ", x = " << r.worst_x;
+	}
+}
+
+TEST(PropertyTest, FloatKernelsCheck)
+{
+	curve::ThreadPool pool;
+	const std::size_t samples = sampleCount();
+
+	// float overflows in R past |u| of about 40 for the larger a
+	for (const method m : { ordinate, arc_length, curvature_radius, area })
+	{
+		const outcome r = check<float>(pool, m, samples, 20, 4);
+		report("float", m, r, pool.size());
+		EXPECT_EQ(samples, r.samples);
+		EXPECT_EQ(0u, r.failures) << methodNames[m] << ": worst " << r.worst
+			<< " ulp at a = " << r.worst_a << ", x = " << r.worst_x;
+	}
+}
@@ -0,0 +1,2179 @@
+#include "pch.h"
+#include "Catenary.h"
+#include "BasicCatenary.h"
+#include "CatenaryArray.h"
+#include "SweepEngine.h"
+#include "TabulatedCatenary.h"
+#include "StaticCatenary.h"
+#include "bulk_io.h"
+#include "batch.h"
+#include "numeric_io.h"
+#include "QueryCache.h"
+#include "Instrument.h"
+#include "Ring.h"
+#include "Integrator.h"
+#include "ReferenceCatenary.h"
+#include "Verifier.h"
+#include "PolylineGenerator.h"
+#include "ShiftedCatenary.h"
+#include "hyperbolic.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct mydouble {
+		mydouble() : value(), eps(0.1) {}
+		mydouble(double v) : value(v), eps(0.1) {}
+		mydouble(double v, double e) : value(v), eps(e) {}
+		double value;
+		double eps;
+	};
+
+	bool double_equals(const mydouble a, const double b, const double epsilon = std::numeric_limits<double>::epsilon()) {
+		if (a.value == INFINITY && b == INFINITY || a.value == -INFINITY && b == -INFINITY) return true;
+		return std::abs(a.value - b) < epsilon;
+	}
+
+	bool double_close(const double a, const double b, const double scale, const double rel = 1e-14) {
+		if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+		if (std::isinf(a) || std::isinf(b)) return a == b;
+		return std::abs(a - b) <= rel * scale;
+	}
+
+	constexpr size_t paramValuesNum = 6,
+		coeffValuesNum = 6;
+
+	class Catenary_Test : public ::testing::Test
+	{
+	protected:
+		int failed;
+
+		Catenary_Test() : failed(0) {}
+
+		typedef std::array<double, coeffValuesNum> coeffValuesArray;
+		typedef std::array<double, paramValuesNum> paramValuesArray;
+		std::vector<coeffValuesArray> coeffsValues;
+		std::vector<paramValuesArray> paramsValues;
+
+		void addParamValues(paramValuesArray&& list) {
+			paramsValues.push_back(std::move(list));
+		}
+
+		void addCoeffValues(coeffValuesArray&& list) {
+			coeffsValues.push_back(std::move(list));
+		}
+
+
+		typedef	std::array<mydouble, coeffValuesNum * paramValuesNum> resultValuesArray;
+		std::vector<resultValuesArray> resultValues;
+
+		void addResultValues(resultValuesArray&& list) {
+			resultValues.push_back(list);
+		}
+
+		// order: coeffs loop first, then params loop
+
+		std::string EXPECT_failureinfo(mydouble expected, double found, double param, double coeff, const char* msg = "") {
+			std::ostringstream failureinfo;
+			failureinfo << "\t<" << msg << ">\n" << std::fixed << std::setprecision(9) <<
+				"\texpected: '" << expected.value << "'\n"
+				"\tfound: '" << found << "'\n"
+				"\tparameter = '" << param << "'\n"
+				"\tcoefficient = '" << coeff << "'\n";
+			++failed;
+			return failureinfo.str();
+		}
+
+		~Catenary_Test() {
+			coeffsValues.clear();
+			paramsValues.clear();
+
+			if (failed) {
+				std::cerr << "[   INFO   ] "
+					"CHECKS FAILED IN TEST: "
+					<< failed << "\n" << std::endl;
+				failed = 0;
+			}
+		}
+	};
+}
+
+TEST_F(Catenary_Test, OrdinateMethodCheck)
+{
+
+	addCoeffValues(
+		coeffValuesArray{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	addParamValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	addResultValues(
+		{
+			mydouble{ -15430.806, 0.001 },{ -10'000.005, 0.000'001 },{ -10'000, 0.1 },{ -10'000, 0.1 },{ -10'000.005, 0.000'001 },{ -15'430.806, 0.001 }, // for coeff is -10000
+			-INFINITY,{ -15.430'806, 0.000'001 },{ -10.000'005, 0.000'001 },{ -10.000'005, 0.000'001 },{ -15.430'806, 0.000'001 } , -INFINITY, // for coeff is -10, etc.
+			-INFINITY, -INFINITY,{ -0.015'430'806, 0.000'000'001 },{ -0.015'430'806, 0.000'000'001 }, -INFINITY, -INFINITY,
+			INFINITY, INFINITY,{ 0.015'430'806, 0.000'000'001 },{ 0.015'430'806, 0.000'000'001 }, INFINITY, INFINITY,
+			INFINITY,{ 15.430'806, 0.000'001 },{ 10.000'005, 0.000'001 },{ 10.000'005, 0.000'001 },{ 15.430'806, 0.000'001 }, INFINITY,
+			{ 15'430.806, 0.001 },{ 10'000.005, 0.000'001 },{ 10'000, 0.1 },{ 10'000, 0.1 },{ 10'000.005, 0.000'001 },{ 15'430.806, 0.001 }
+		}
+	);
+
+	auto resultIt = resultValues.at(0).begin();
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		curve::Catenary c(*coeffIt);
+
+		for (auto paramIt = paramsValues.at(0).begin();
+			paramIt != paramsValues.at(0).end() && resultIt != resultValues.at(0).end();
+			++paramIt, ++resultIt)
+		{
+			EXPECT_TRUE
+			(
+				double_equals
+				(
+					c.y(*paramIt),
+					resultIt->value,
+					resultIt->eps
+				)
+			)
+				<< EXPECT_failureinfo
+				(
+					resultIt->value,
+					c.y(*paramIt),
+					*paramIt,
+					*coeffIt
+				);
+		}
+	}
+}
+
+TEST_F(Catenary_Test, ArcLengthCheck)
+{
+
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	addParamValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	addResultValues(
+		{
+			mydouble{ -11752.012, 0.001 },{ -10.000'002, 0.000'001 },{ -0.01, 0.01 },{ 0.01, 0.01 },{ 10.000'002, 0.000'001 },{ 11752.012, 0.001 }, // for coeff is -10000
+			-INFINITY,{ -11.752'012, 0.000'001 },{ -0.01, 0.01 },{ 0.01, 0.01 },{ 11.752'012, 0.000'001 } , INFINITY, // for coeff is -10, etc.
+			-INFINITY, -INFINITY,{ -0.011'752'012, 0.000'000'001 },{ 0.011'752'012, 0.000'000'001 }, INFINITY, INFINITY,
+			-INFINITY, -INFINITY,{ -0.011'752'012, 0.000'000'001 },{ 0.011'752'012, 0.000'000'001 }, INFINITY, INFINITY,
+			-INFINITY,{ -11.752'012, 0.000'001 },{ -0.01, 0.01 },{ 0.01, 0.01 },{ 11.752'012, 0.000'001 } , INFINITY,
+			{ -11752.012, 0.001 },{ -10.000'002, 0.000'001 },{ -0.01, 0.01 },{ 0.01, 0.01 },{ 10.000'002, 0.000'001 },{ 11752.012, 0.001 }
+		}
+	);
+
+	auto resultIt = resultValues.at(0).begin();
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		curve::Catenary c(*coeffIt);
+
+		for (auto paramIt = paramsValues.at(0).begin();
+			paramIt != paramsValues.at(0).end() && resultIt != resultValues.at(0).end();
+			++paramIt, ++resultIt)
+		{
+			EXPECT_TRUE
+			(
+				double_equals
+				(
+					c.l(*paramIt),
+					resultIt->value,
+					resultIt->eps
+				)
+			)
+				<< EXPECT_failureinfo
+				(
+					resultIt->value,
+					c.l(*paramIt),
+					*paramIt,
+					*coeffIt
+				);
+		}
+	}
+}
+
+TEST_F(Catenary_Test, CurvatureRadiusCheck)
+{
+
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	addParamValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	addResultValues(
+		{
+			mydouble{ -23'810.978, 0.001 },{ -10'000.01, 0.01 },{ -10'000, 0.01 },{ -10'000, 0.01 },{ -10'000.01, 0.01 },{ -23810.978, 0.001 }, // for coeff is -10000
+			-INFINITY,{ -23.810'978, 0.000'001 },{ -10.000'010, 0.000'010 },{ -10.000'010, 0.000'010 },{ -23.810'978, 0.000'001 } , -INFINITY, // for coeff is -10, etc.
+			-INFINITY, -INFINITY,{ -0.023'810'978, 0.000'000'001 },{ -0.023'810'978, 0.000'000'001 }, -INFINITY, -INFINITY,
+			INFINITY, INFINITY,{ 0.023'810'978, 0.000'000'001 },{ 0.023'810'978, 0.000'000'001 }, INFINITY, INFINITY,
+			INFINITY,{ 23.810'978, 0.000'001 },{ 10.000'010, 0.000'010 },{ 10.000'010, 0.000'010 },{ 23.810'978, 0.000'001 } , INFINITY,
+			{ 23'810.978, 0.001 },{ 10'000.01, 0.01 },{ 10'000, 0.01 },{ 10'000, 0.01 },{ 10'000.01, 0.01 },{ 23810.978, 0.001 }
+		}
+	);
+
+	auto resultIt = resultValues.at(0).begin();
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		curve::Catenary c(*coeffIt);
+
+		for (auto paramIt = paramsValues.at(0).begin();
+			paramIt != paramsValues.at(0).end() && resultIt != resultValues.at(0).end();
+			++paramIt, ++resultIt)
+		{
+			EXPECT_TRUE
+			(
+				double_equals
+				(
+					c.R(*paramIt),
+					resultIt->value,
+					resultIt->eps
+				)
+			)
+				<< EXPECT_failureinfo
+				(
+					resultIt->value,
+					c.R(*paramIt),
+					*paramIt,
+					*coeffIt
+				);
+		}
+	}
+}
+
+TEST_F(Catenary_Test, TrapezeAreaCheck)
+{
+
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	addParamValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	addParamValues(
+		{ 10000, 10, 0.01, -0.01, -10, -10000 }
+	);
+
+	addResultValues(
+		{
+			mydouble{ -235'040'238.7, 0.1 },{ -200'000.03, 0.01 },{ -200, 0.1 },{ 200, 0.1 },{ 200'000.03, 0.01 },{ 235'040'238.7, 0.1 }, // for coeff is -10000
+			-INFINITY,{ -235.040'238, 0.000'001 },{ -0.200, 0.100 },{ 0.200, 0.100 },{ 235.040'238, 0.000'001 } , INFINITY, // for coeff is -10, etc.
+			-INFINITY, -INFINITY,{ -0.000'235'040, 0.000'000'001 },{ 0.000'235'040, 0.000'000'001 }, INFINITY, INFINITY,
+			INFINITY, INFINITY,{ 0.000'235'040, 0.000'000'001 },{ -0.000'235'040, 0.000'000'001 }, -INFINITY, -INFINITY,
+			INFINITY,{ 235.040'238, 0.000'001 },{ 0.200, 0.100 },{ -0.200, 0.100 },{ -235.040'238, 0.000'001 } , -INFINITY,
+			{ 235'040'238.7, 0.1 },{ 200'000.03, 0.01 },{ 200, 0.1 },{ -200, 0.1 },{ -200'000.03, 0.01 },{ -235'040'238.7, 0.1 }
+		}
+	);
+
+	auto resultIt = resultValues.at(0).begin();
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		curve::Catenary c(*coeffIt);
+
+		for (auto paramIt = paramsValues.at(0).begin(), paramIt1 = paramsValues.at(1).begin();
+			paramIt != paramsValues.at(0).end() && paramIt1 != paramsValues.at(1).end() && resultIt != resultValues.at(0).end();
+			++paramIt, ++paramIt1, ++resultIt)
+		{
+			EXPECT_TRUE
+			(
+				double_equals
+				(
+					c.S(*paramIt, *paramIt1),
+					resultIt->value,
+					resultIt->eps
+				)
+			)
+				<< EXPECT_failureinfo
+				(
+					resultIt->value,
+					c.S(*paramIt, *paramIt1),
+					*paramIt,
+					*coeffIt
+				);
+		}
+	}
+}
+
+TEST_F(Catenary_Test, CurvatureCenterCoordsCheck)
+{
+
+	addCoeffValues(
+		{ -20000, -10000, -5000, 5000, 10000, 20000 }
+	);
+
+	addParamValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	//x1
+	addResultValues(
+		{
+			mydouble{ 1752.011'936'438, 0.000'000'001 },{ 0.000'001'666, 0.000'000'001 },{ 0, 0.000'000'001 },{ 0, 0.000'000'001 },{ -0.000'001'666, 0.000'000'001 },{ -1752.011'936'438, 0.000'000'001 }, // for coeff is -20000
+			{ 8'134.302'039'235, 0.000'000'001 },{ 0.000'006'667, 0.000'000'001 },{ 0, 0.000'000'001 },{ 0, 0.000'000'001 },{ -0.000'006'667, 0.000'000'001 },{ -8'134.302'039'235, 0.000'000'001 }, // for coeff is -10000, etc.
+			{ 58'224.792'992'819, 0.000'000'001 },{ 0.000'026'666, 0.000'000'001 },{ 0, 0.000'000'001 },{ 0, 0.000'000'001 },{ -0.000'026'666, 0.000'000'001 },{ -58'224.792'992'819, 0.000'000'001 },
+			{ -78'224.792'992'819, 0.000'000'001 },{ -20.000'026'666, 0.000'000'001 },{ -0.02, 0.01 },{ 0.02, 0.01 },{ 20.000'026'666, 0.000'000'001 },{ 78'224.792'992'819, 0.000'000'001 },
+			{ -28'134.302'039'235, 0.000'000'001 },{ -20.000'006'666, 0.000'000'001 },{ -0.02, 0.01 },{ 0.02, 0.01 },{ 20.000'006'666, 0.000'000'001 },{ 28'134.302'039'235, 0.000'000'001 },
+			{ -21'752.011'936'438, 0.000'000'001 },{ -20.000'001'666, 0.000'000'001 },{ -0.02, 0.01 },{ 0.02, 0.1 },{ 20.000'001'666, 0.000'000'001 },{ 21'752.011'936'438, 0.000'000'001 }
+		}
+	);
+
+	//y1
+	addResultValues(
+		{
+			mydouble{ -45'105.038'608'255, 0.000'000'001 },{ -40'000.005, 0.001 },{ -40'000.000'000'005, 0.000'000'001 },{ -40'000.000'000'005, 0.000'000'001 },{ -40'000.005, 0.001 },{ -45'105.038'608'255, 0.000'000'001 }, // for coeff is -10000
+			{ -30'861.612'696'304, 0.000'000'001 },{ -20'000.01, 0.01 },{-20'000.000'000'010, 0.000'000'010},{-20'000.000'000'010, 0.000'000'010},{-20'000.01, 0.10},{-30'861.612'696'304, 0.000'000'001},	// for coeff is -10, etc.
+			{ -37'621.956'910'836, 0.000'000'001 },{ -10'000.020'000'006, 0.000'000'001 },{ -10'000.000'000'020, 0.000'000'010 },{ -10000.000'000'020, 0.000'000'010 },{ -10'000.02, 0.01 },{ -37'621.956'910'836, 0.000'000'001 },
+			0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0
+		}
+	);
+
+	//x2
+	addResultValues(
+		{
+			mydouble{ -21'752.011'936'438, 0.000'000'001 },{ -20.000'001'666, 0.000'000'001 },{ -0.02, 0.01 },{0.02, 0.01},{ 20.000'001'666, 0.000'000'001 },{ 21'752.011'936'438, 0.000'000'001 }, // for coeff is -10000
+			{ -28'134.302'039'235, 0.000'000'001 },{ -20.000'006'666, 0.000'000'001 },{-0.02, 0.01 },{ 0.02, 0.01 },{ 20.000'006'666, 0.000'000'001 },{ 28'134.302'039'235, 0.000'000'001 }, // for coeff is -10, etc.
+			{ -78'224.792'992'819, 0.000'000'001 },{ -20.000'026'666, 0.000'000'001 },{ -0.02, 0.01 },{ 0.02, 0.01 },{ 20.000'026'666, 0.000'000'001 }, { 78'224.792'992'819, 0.000'000'001 },
+			{ 58'224.792'992'819, 0.000'000'001 },{ 0.000'026'666, 0.000'000'001 },0,0,{-0.000'026'666, 0.000'000'001 },{ -58'224.792'992'819, 0.000'000'001 },
+			{ 8'134.302'039'235, 0.000'000'001 },{ 0.000'006'666, 0.000'000'001 },0,0,{ -0.000'006'666, 0.000'000'001 },{ -8'134.302'039'235, 0.000'000'001 },
+			{ 1'752.011'936'438, 0.000'000'001 },{ 0.000'001'666, 0.000'000'001 },0,0,{ -0.000'001'666, 0.000'000'001 },{ -1'752.011'936'438, 0.000'000'001 }
+		}
+	);
+
+	//y2
+	addResultValues(
+		{
+			0,0,0,0,0,0,
+			0,0,0,0,0,0,
+			0,0,0,0,0,0,
+			{ 37'621.956'910'836, 0.000'000'001 },{ 10'000.020, 0.01 },{ 10'000.000'000'020, 0.000'000'010 },{ 10'000.000'000'020, 0.000'000'010 },{ 10'000.02, 0.01 },{ 37'621.956'910'836, 0.000'000'001 },
+			{ 30'861.612'696'304, 0.000'000'001 },{ 20'000.01, 0.01 },{ 20'000.000'000'010, 0.000'000'010 },{ 20'000.000'000'010, 0.000'000'010 },{ 20'000.01, 0.01 },{ 30'861.612'696'304, 0.000'000'001 },
+			{ 45'105.038'608'255, 0.000'000'001 },{ 40'000.005, 0.001 }, { 40'000.000'000'005, 0.000'000'001 }, { 40'000.000'000'005, 0.000'000'001 },{ 40'000.005, 0.001 },{ 45'105.038'608'255, 0.000'000'001 }
+		}
+	);
+
+	auto resultIt = resultValues.at(0).begin(),
+		resultIt1 = resultValues.at(1).begin(),
+		resultIt2 = resultValues.at(2).begin(),
+		resultIt3 = resultValues.at(3).begin();
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		curve::Catenary c(*coeffIt);
+
+		for (auto paramIt = paramsValues.at(0).begin();
+			paramIt != paramsValues.at(0).end() && 
+			resultIt != resultValues.at(0).end() &&
+			resultIt1 != resultValues.at(1).end() &&
+			resultIt2 != resultValues.at(2).end() &&
+			resultIt3 != resultValues.at(3).end();
+			++paramIt, 
+			++resultIt, ++resultIt1, ++resultIt2, ++resultIt3)
+		{
+			// x1
+			EXPECT_TRUE
+			(
+				double_equals
+				(
+					c.CurvatureCenterCoords(*paramIt).first.first,
+					resultIt->value,
+					resultIt->eps
+				)
+			)
+				<< EXPECT_failureinfo
+				(
+					resultIt->value,
+					c.CurvatureCenterCoords(*paramIt).first.first,
+					*paramIt,
+					*coeffIt,
+					"X1 CHECK"
+				);
+
+			// y1
+			EXPECT_TRUE
+			(
+				double_equals
+				(
+					c.CurvatureCenterCoords(*paramIt).first.second,
+					resultIt1->value,
+					resultIt1->eps
+				)
+			)
+				<< EXPECT_failureinfo
+				(
+					resultIt1->value,
+					c.CurvatureCenterCoords(*paramIt).first.second,
+					*paramIt,
+					*coeffIt,
+					"Y1 CHECK"
+				);
+
+			// x2
+			EXPECT_TRUE
+			(
+				double_equals
+				(
+					c.CurvatureCenterCoords(*paramIt).second.first,
+					resultIt2->value,
+					resultIt2->eps
+				)
+			)
+				<< EXPECT_failureinfo
+				(
+					resultIt2->value,
+					c.CurvatureCenterCoords(*paramIt).second.first,
+					*paramIt,
+					*coeffIt,
+					"X2 CHECK"
+				);
+
+			// y2
+			EXPECT_TRUE 
+			(
+				double_equals
+				(
+					c.CurvatureCenterCoords(*paramIt).second.second,
+					resultIt3->value,
+					resultIt3->eps
+				)
+			)
+				<< EXPECT_failureinfo
+				(
+					resultIt3->value,
+					c.CurvatureCenterCoords(*paramIt).second.second,
+					*paramIt,
+					*coeffIt,
+					"Y2 CHECK"
+				);
+		}
+	}
+}
+
+TEST_F(Catenary_Test, BatchMethodsCheck)
+{
+
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	// the test grid plus a dense sweep through the overflow boundary and the small |x / a| region
+	std::vector<double> xs{ -10000, -10, -0.01, 0.01, 10, 10000, 0 };
+	for (int i = -1000; i <= 1000; ++i)
+		xs.push_back(i * 0.7137);
+	std::vector<double> x2s(xs.rbegin(), xs.rend());
+
+	std::vector<double> ys(xs.size()), ls(xs.size()), Rs(xs.size()), Ss(xs.size());
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		curve::Catenary c(*coeffIt);
+		const double a = std::abs(*coeffIt);
+
+		c.y(xs.data(), ys.data(), xs.size());
+		c.l(xs.data(), ls.data(), xs.size());
+		c.R(xs.data(), Rs.data(), xs.size());
+		c.S(xs.data(), x2s.data(), Ss.data(), xs.size());
+
+		for (size_t i = 0; i < xs.size(); ++i)
+		{
+			EXPECT_TRUE(double_close(ys[i], c.y(xs[i]), std::abs(c.y(xs[i]))))
+				<< EXPECT_failureinfo(c.y(xs[i]), ys[i], xs[i], *coeffIt, "BATCH Y");
+			EXPECT_TRUE(double_close(ls[i], c.l(xs[i]), std::abs(c.l(xs[i]))))
+				<< EXPECT_failureinfo(c.l(xs[i]), ls[i], xs[i], *coeffIt, "BATCH L");
+			EXPECT_TRUE(double_close(Rs[i], c.R(xs[i]), std::abs(c.R(xs[i]))))
+				<< EXPECT_failureinfo(c.R(xs[i]), Rs[i], xs[i], *coeffIt, "BATCH R");
+			EXPECT_TRUE(double_close(Ss[i], c.S(xs[i], x2s[i]), a * (std::abs(c.l(xs[i])) + std::abs(c.l(x2s[i])))))
+				<< EXPECT_failureinfo(c.S(xs[i], x2s[i]), Ss[i], xs[i], *coeffIt, "BATCH S");
+		}
+	}
+}
+
+TEST_F(Catenary_Test, EvaluateCheck)
+{
+
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	addParamValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	std::vector<curve::Catenary::point> points(paramValuesNum);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		curve::Catenary c(*coeffIt);
+		c.evaluate(paramsValues.at(0).data(), points.data(), paramValuesNum);
+
+		for (size_t i = 0; i < paramValuesNum; ++i)
+		{
+			const double x = paramsValues.at(0)[i];
+			const curve::Catenary::point p = c.evaluate(x);
+
+			EXPECT_TRUE(double_close(p.y, c.y(x), std::abs(c.y(x))))
+				<< EXPECT_failureinfo(c.y(x), p.y, x, *coeffIt, "EVALUATE Y");
+			EXPECT_TRUE(double_close(p.l, c.l(x), std::abs(c.l(x))))
+				<< EXPECT_failureinfo(c.l(x), p.l, x, *coeffIt, "EVALUATE L");
+			EXPECT_TRUE(double_close(p.R, c.R(x), std::abs(c.R(x))))
+				<< EXPECT_failureinfo(c.R(x), p.R, x, *coeffIt, "EVALUATE R");
+			EXPECT_TRUE(double_close(p.S, c.S(0, x), std::abs(c.S(0, x))))
+				<< EXPECT_failureinfo(c.S(0, x), p.S, x, *coeffIt, "EVALUATE S");
+
+			EXPECT_TRUE(double_close(points[i].y, p.y, std::abs(p.y)))
+				<< EXPECT_failureinfo(p.y, points[i].y, x, *coeffIt, "BATCH EVALUATE Y");
+			EXPECT_TRUE(double_close(points[i].centers.second.first, p.centers.second.first,
+				std::abs(x) + std::abs(*coeffIt * p.l)))
+				<< EXPECT_failureinfo(p.centers.second.first, points[i].centers.second.first, x, *coeffIt, "BATCH EVALUATE X2");
+			EXPECT_TRUE(double_close(points[i].centers.second.second, p.centers.second.second, 2 * std::abs(p.y)))
+				<< EXPECT_failureinfo(p.centers.second.second, points[i].centers.second.second, x, *coeffIt, "BATCH EVALUATE Y2");
+		}
+	}
+}
+
+
+TEST_F(Catenary_Test, CoordBufferCheck)
+{
+
+	addCoeffValues(
+		{ -20000, -10000, -5000, 5000, 10000, 20000 }
+	);
+
+	addParamValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	curve::CoordBuffer first(paramValuesNum), second;
+	second.resize(paramValuesNum);
+
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first.xs()) % curve::CoordBuffer::alignment, 0u);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first.ys()) % curve::CoordBuffer::alignment, 0u);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		curve::Catenary c(*coeffIt);
+		c.CurvatureCenterCoords(paramsValues.at(0).data(), first.view(), second.view());
+
+		for (size_t i = 0; i < paramValuesNum; ++i)
+		{
+			const double x = paramsValues.at(0)[i];
+			const curve::coords_pair expected = c.CurvatureCenterCoords(x);
+
+			EXPECT_TRUE(double_equals(first[i].first, expected.first.first, 0.000'000'001))
+				<< EXPECT_failureinfo(expected.first.first, first[i].first, x, *coeffIt, "BUFFER X1");
+			EXPECT_TRUE(double_equals(first[i].second, expected.first.second, 0.000'000'001))
+				<< EXPECT_failureinfo(expected.first.second, first[i].second, x, *coeffIt, "BUFFER Y1");
+			EXPECT_TRUE(double_equals(second[i].first, expected.second.first, 0.000'000'001))
+				<< EXPECT_failureinfo(expected.second.first, second[i].first, x, *coeffIt, "BUFFER X2");
+			EXPECT_TRUE(double_equals(second[i].second, expected.second.second, 0.000'000'001))
+				<< EXPECT_failureinfo(expected.second.second, second[i].second, x, *coeffIt, "BUFFER Y2");
+		}
+	}
+
+	// a second view shorter than the first is refused, not overrun
+	const curve::coord_view short_view = second.view().subview(0, paramValuesNum - 1);
+	EXPECT_THROW(curve::Catenary(2).CurvatureCenterCoords(paramsValues.at(0).data(), first.view(), short_view),
+		std::invalid_argument);
+	EXPECT_THROW(curve::ShiftedCatenary(2, 1, 1).CurvatureCenterCoords(paramsValues.at(0).data(), first.view(), short_view),
+		std::invalid_argument);
+}
+
+
+TEST_F(Catenary_Test, SweepEngineCheck)
+{
+
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	std::vector<double> xs;
+	for (int i = -5000; i < 5000; ++i)
+		xs.push_back(i * 0.37);
+
+	const size_t cells = coeffValuesNum * xs.size();
+	std::vector<double> serial(cells), parallel(cells), row(xs.size());
+
+	curve::SweepEngine engine(4);
+
+	for (auto q : { curve::quantity::ordinate, curve::quantity::arc_length,
+		curve::quantity::curvature_radius, curve::quantity::area })
+	{
+		engine.run_serial(q, coeffsValues.at(0).data(), coeffValuesNum, xs.data(), xs.size(), serial.data());
+		engine.run(q, coeffsValues.at(0).data(), coeffValuesNum, xs.data(), xs.size(), parallel.data());
+
+		EXPECT_EQ(0, std::memcmp(serial.data(), parallel.data(), cells * sizeof(double)));
+
+		curve::Catenary c(coeffsValues.at(0)[1]);
+		c.y(xs.data(), row.data(), xs.size());
+		if (q == curve::quantity::ordinate)
+		{
+			EXPECT_EQ(0, std::memcmp(row.data(), serial.data() + xs.size(), xs.size() * sizeof(double)));
+		}
+	}
+
+	// a throwing task reaches the caller only after the workers let go of it,
+	// and the pool runs the next loop in full
+	curve::ThreadPool pool(4);
+	std::atomic<std::size_t> calls(0);
+	EXPECT_THROW(pool.parallel_for(10000, [&](std::size_t i) {
+		calls.fetch_add(1);
+		if (i % 1000 == 7) throw std::runtime_error("task failed");
+	}), std::runtime_error);
+	EXPECT_LE(calls.load(), 10000u);
+	calls = 0;
+	pool.parallel_for(10000, [&](std::size_t) { calls.fetch_add(1); });
+	EXPECT_EQ(10000u, calls.load());
+}
+
+
+TEST_F(Catenary_Test, TabulatedCatenaryCheck)
+{
+
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	for (const double tolerance : { 1e-6, 1e-10, 1e-13 })
+	{
+		for (auto coeffIt = coeffsValues.at(0).begin();
+			coeffIt != coeffsValues.at(0).end();
+			++coeffIt)
+		{
+			const double x_max = std::abs(*coeffIt) * 20;
+			const curve::Catenary c(*coeffIt);
+			const curve::TabulatedCatenary t(*coeffIt, -x_max, x_max, tolerance);
+
+			for (int i = -999; i <= 999; ++i)
+			{
+				const double x = x_max * i / 1000.3;
+
+				EXPECT_TRUE(double_close(t.y(x), c.y(x), std::abs(c.y(x)), tolerance))
+					<< EXPECT_failureinfo(c.y(x), t.y(x), x, *coeffIt, "TABLE Y");
+				EXPECT_TRUE(double_close(t.l(x), c.l(x), std::abs(c.l(x)), tolerance))
+					<< EXPECT_failureinfo(c.l(x), t.l(x), x, *coeffIt, "TABLE L");
+				EXPECT_TRUE(double_close(t.R(x), c.R(x), std::abs(c.R(x)), tolerance))
+					<< EXPECT_failureinfo(c.R(x), t.R(x), x, *coeffIt, "TABLE R");
+				EXPECT_TRUE(double_close(t.S(-x / 3, x), c.S(-x / 3, x),
+					std::abs(*coeffIt) * (std::abs(c.l(x)) + std::abs(c.l(-x / 3))), tolerance))
+					<< EXPECT_failureinfo(c.S(-x / 3, x), t.S(-x / 3, x), x, *coeffIt, "TABLE S");
+			}
+		}
+	}
+
+	EXPECT_THROW(curve::TabulatedCatenary(1, 1, -1), std::invalid_argument);
+	EXPECT_THROW(curve::TabulatedCatenary(1, -1, 1, 1e-20), std::invalid_argument);
+	EXPECT_THROW(curve::TabulatedCatenary(1, -1000, 1), std::invalid_argument);
+}
+
+TEST_F(Catenary_Test, UniformSweepCheck)
+{
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const curve::Catenary c(*coeffIt);
+
+		// the last one runs into the overflow half way
+		for (const double u0 : { -20.0, 0.0, 690.0 })
+		{
+			const double x0 = u0 * std::abs(*coeffIt), h = 0.0371 * std::abs(*coeffIt);
+			const curve::UniformSweep sweep = c.sweep(x0, h, 1003);
+			std::vector<double> ys(sweep.size()), ls(sweep.size()), Rs(sweep.size()), ys2(sweep.size()), ls2(sweep.size());
+			sweep.y(ys.data());
+			sweep.l(ls.data());
+			sweep.R(Rs.data());
+			sweep.evaluate(ys2.data(), ls2.data());
+
+			std::size_t i = 0;
+			for (const curve::UniformSweep::point& p : sweep)
+			{
+				const double x = x0 + i * h, y = c.y(x), l = c.l(x);
+				EXPECT_EQ(x, p.x);
+
+				if (std::isinf(y))
+				{
+					EXPECT_EQ(y, p.y);
+					EXPECT_EQ(y, ys[i]);
+					EXPECT_EQ(l, ls[i]);
+				}
+				else
+				{
+					// sinh drifts on the scale of cosh, and rounding x / a
+					// costs |x / a| ulp in the reference itself
+					const double rel = 1e-13 + 2e-16 * std::abs(x / *coeffIt);
+					EXPECT_TRUE(double_close(p.y, y, std::abs(y), rel))
+						<< EXPECT_failureinfo(y, p.y, x, *coeffIt, "SWEEP Y");
+					EXPECT_TRUE(double_close(p.l, l, std::abs(y), rel))
+						<< EXPECT_failureinfo(l, p.l, x, *coeffIt, "SWEEP L");
+					EXPECT_TRUE(double_close(ys[i], y, std::abs(y), rel))
+						<< EXPECT_failureinfo(y, ys[i], x, *coeffIt, "BATCH SWEEP Y");
+					EXPECT_TRUE(double_close(ls[i], l, std::abs(y), rel))
+						<< EXPECT_failureinfo(l, ls[i], x, *coeffIt, "BATCH SWEEP L");
+					EXPECT_TRUE(double_close(Rs[i], c.R(x), std::abs(c.R(x)), 2 * rel))
+						<< EXPECT_failureinfo(c.R(x), Rs[i], x, *coeffIt, "BATCH SWEEP R");
+				}
+				EXPECT_EQ(0, std::memcmp(&ys[i], &ys2[i], sizeof(double)));
+				EXPECT_EQ(0, std::memcmp(&ls[i], &ls2[i], sizeof(double)));
+				++i;
+			}
+			EXPECT_EQ(sweep.size(), i);
+		}
+	}
+
+	const curve::UniformSweep empty(1, 0, 1, 0);
+	EXPECT_TRUE(empty.begin() == empty.end());
+	empty.y(nullptr);
+	EXPECT_THROW(curve::UniformSweep(0, 0, 1, 10), std::invalid_argument);
+	EXPECT_THROW(curve::UniformSweep(1, 0, INFINITY, 10), std::invalid_argument);
+}
+
+TEST_F(Catenary_Test, StaticCatenaryCheck)
+{
+	constexpr curve::StaticCatenary<1> unit;
+	static_assert(unit.y(0) == 1 && unit.l(0) == 0 && unit.R(0) == 1, "constexpr evaluation");
+	constexpr auto table = curve::tabulate<33>([](double x) { return curve::StaticCatenary<-5, 2>().y(x); }, -8, 0.5);
+	static_assert(table[16] == -2.5, "constexpr table");
+
+	const curve::Catenary c(-2.5);
+	const curve::StaticCatenary<-5, 2> s;
+	EXPECT_EQ(-2.5, s.get_a());
+	// the compile-time cosh is not libm's, but agrees with it
+	for (std::size_t i = 0; i < table.size(); ++i)
+	{
+		const double x = -8 + 0.5 * static_cast<double>(i);
+		EXPECT_TRUE(double_close(table[i], s.y(x), std::abs(s.y(x)), 1e-14 * (1 + std::abs(x / 2.5))))
+			<< EXPECT_failureinfo(s.y(x), table[i], x, -2.5, "CONSTEXPR Y");
+	}
+	EXPECT_EQ(c.get_a(), s.runtime().get_a());
+
+	for (int i = -2000; i <= 2000; ++i)
+	{
+		const double x = i * 0.8501;
+		// x * (1 / a) and x / a may differ in the last bit, which cosh / sinh scale by |x / a|
+		const double rel = 1e-14 * (1 + std::abs(x / 2.5));
+
+		EXPECT_TRUE(double_close(s.y(x), c.y(x), std::abs(c.y(x)), rel))
+			<< EXPECT_failureinfo(c.y(x), s.y(x), x, -2.5, "STATIC Y");
+		EXPECT_TRUE(double_close(s.l(x), c.l(x), std::abs(c.l(x)), rel))
+			<< EXPECT_failureinfo(c.l(x), s.l(x), x, -2.5, "STATIC L");
+		EXPECT_TRUE(double_close(s.R(x), c.R(x), std::abs(c.R(x)), 2 * rel))
+			<< EXPECT_failureinfo(c.R(x), s.R(x), x, -2.5, "STATIC R");
+		EXPECT_TRUE(double_close(s.S(-x / 3, x), c.S(-x / 3, x), 2.5 * (std::abs(c.l(x)) + std::abs(c.l(-x / 3))), rel))
+			<< EXPECT_failureinfo(c.S(-x / 3, x), s.S(-x / 3, x), x, -2.5, "STATIC S");
+
+		const curve::coords_pair expected(c.CurvatureCenterCoords(x)), centers(s.CurvatureCenterCoords(x));
+		EXPECT_TRUE(double_close(centers.second.first, expected.second.first, std::abs(x) + std::abs(c.l(x) * c.y(x) / 2.5), 2 * rel))
+			<< EXPECT_failureinfo(expected.second.first, centers.second.first, x, -2.5, "STATIC X2");
+		EXPECT_TRUE(double_close(centers.second.second, expected.second.second, 2 * std::abs(c.y(x)), rel))
+			<< EXPECT_failureinfo(expected.second.second, centers.second.second, x, -2.5, "STATIC Y2");
+	}
+
+	EXPECT_EQ(-INFINITY, s.y(2000));
+	EXPECT_EQ(INFINITY, s.l(2000));
+	EXPECT_TRUE(std::isnan(s.y(std::numeric_limits<double>::quiet_NaN())));
+
+	for (int i = 0; i < 33; ++i)
+		EXPECT_TRUE(double_close(table[i], c.y(-8 + 0.5 * i), std::abs(c.y(-8 + 0.5 * i)), 1e-13));
+}
+
+TEST_F(Catenary_Test, LogDomainCheck)
+{
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const curve::Catenary c(*coeffIt);
+		std::vector<double> xs;
+		for (int i = -2000; i <= 2000; ++i)
+			xs.push_back(*coeffIt * i * 0.7499);
+		xs.push_back(*coeffIt * 1e7);
+		xs.push_back(-*coeffIt * 1e300);
+
+		std::vector<double> log_ys(xs.size()), log_Rs(xs.size());
+		std::vector<curve::scaled> ys(xs.size()), Rs(xs.size());
+		c.log_y(xs.data(), log_ys.data(), xs.size());
+		c.log_R(xs.data(), log_Rs.data(), xs.size());
+		c.scaled_y(xs.data(), ys.data(), xs.size());
+		c.scaled_R(xs.data(), Rs.data(), xs.size());
+
+		for (std::size_t i = 0; i < xs.size(); ++i)
+		{
+			const double x = xs[i], u = std::abs(x / *coeffIt);
+			// ln cosh(u) is u - ln2 once e^-2u is below an ulp
+			const double log_y = u < 300 ? std::log(std::abs(c.y(x))) : std::log(std::abs(*coeffIt)) + u - std::log(2.0),
+				log_R = u < 300 ? std::log(std::abs(c.R(x))) : std::log(std::abs(*coeffIt)) + 2 * (u - std::log(2.0)),
+				scale = 1 + std::abs(log_R);
+
+			EXPECT_TRUE(double_close(c.log_y(x), log_y, scale))
+				<< EXPECT_failureinfo(log_y, c.log_y(x), x, *coeffIt, "LOG Y");
+			EXPECT_TRUE(double_close(c.log_R(x), log_R, scale))
+				<< EXPECT_failureinfo(log_R, c.log_R(x), x, *coeffIt, "LOG R");
+			EXPECT_TRUE(double_close(log_ys[i], log_y, scale))
+				<< EXPECT_failureinfo(log_y, log_ys[i], x, *coeffIt, "BATCH LOG Y");
+			EXPECT_TRUE(double_close(log_Rs[i], log_R, scale))
+				<< EXPECT_failureinfo(log_R, log_Rs[i], x, *coeffIt, "BATCH LOG R");
+
+			for (const curve::scaled& v : { c.scaled_y(x), c.scaled_R(x), ys[i], Rs[i] })
+			{
+				EXPECT_TRUE(std::abs(v.mantissa) >= 1 && std::abs(v.mantissa) < 2);
+				EXPECT_EQ(std::floor(v.exponent), v.exponent);
+				EXPECT_EQ(std::signbit(*coeffIt), std::signbit(v.mantissa));
+			}
+			EXPECT_TRUE(double_close(c.scaled_y(x).log(), log_y, scale))
+				<< EXPECT_failureinfo(log_y, c.scaled_y(x).log(), x, *coeffIt, "SCALED Y");
+			EXPECT_TRUE(double_close(c.scaled_R(x).log(), log_R, scale))
+				<< EXPECT_failureinfo(log_R, c.scaled_R(x).log(), x, *coeffIt, "SCALED R");
+			EXPECT_TRUE(double_close(ys[i].log(), log_y, scale))
+				<< EXPECT_failureinfo(log_y, ys[i].log(), x, *coeffIt, "BATCH SCALED Y");
+			EXPECT_TRUE(double_close(Rs[i].log(), log_R, scale))
+				<< EXPECT_failureinfo(log_R, Rs[i].log(), x, *coeffIt, "BATCH SCALED R");
+
+			if (u < 300)
+			{
+				EXPECT_TRUE(double_close(ys[i].value(), c.y(x), std::abs(c.y(x)), 1e-13))
+					<< EXPECT_failureinfo(c.y(x), ys[i].value(), x, *coeffIt, "SCALED Y VALUE");
+				EXPECT_TRUE(double_close(Rs[i].value(), c.R(x), std::abs(c.R(x)), 1e-13))
+					<< EXPECT_failureinfo(c.R(x), Rs[i].value(), x, *coeffIt, "SCALED R VALUE");
+			}
+		}
+	}
+
+	const curve::Catenary c(1);
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	double out[2];
+	const double in[2] = { nan, INFINITY };
+	c.log_y(in, out, 2);
+	EXPECT_TRUE(std::isnan(out[0]));
+	EXPECT_EQ(INFINITY, out[1]);
+	EXPECT_TRUE(std::isnan(c.log_R(nan)));
+	EXPECT_EQ(INFINITY, c.log_R(-INFINITY));
+	EXPECT_TRUE(std::isnan(c.scaled_y(nan).mantissa));
+	EXPECT_EQ(INFINITY, c.scaled_y(INFINITY).exponent);
+}
+
+TEST_F(Catenary_Test, MakeCheck)
+{
+	static_assert(std::is_nothrow_constructible<curve::Catenary, double>::value, "noexcept construction");
+	static_assert(std::is_trivially_copyable<curve::Catenary>::value, "trivially copyable");
+	constexpr curve::Catenary unit;
+	static_assert(unit.get_a() == 1 && curve::Catenary(-2.5).get_a() == -2.5, "constexpr construction");
+	static_assert(curve::Catenary::make(3)->get_a() == 3 && !curve::Catenary::make(0), "constexpr make");
+
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const std::optional<curve::Catenary> c = curve::Catenary::make(*coeffIt);
+		ASSERT_TRUE(c.has_value());
+		EXPECT_EQ(*coeffIt, c->get_a());
+		EXPECT_EQ(curve::Catenary(*coeffIt).y(1), c->y(1));
+	}
+
+	for (double a : std::initializer_list<double>{ 0, -0.0, INFINITY, -INFINITY, std::numeric_limits<double>::quiet_NaN() })
+		EXPECT_FALSE(curve::Catenary::make(a).has_value()) << a;
+
+	// the constructor and set_a keep replacing a == 0 by 1
+	curve::Catenary c(0);
+	EXPECT_EQ(1, c.get_a());
+	c.set_a(-4);
+	EXPECT_EQ(-4, c.get_a());
+	c.set_a(0);
+	EXPECT_EQ(1, c.get_a());
+}
+
+TEST_F(Catenary_Test, CatenaryArrayCheck)
+{
+	addCoeffValues(
+		{ -10000, -10, -0.01, 0.01, 10, 10000 }
+	);
+
+	// every grid coefficient, scaled a little differently each time
+	const std::size_t n = 3001;
+	curve::CatenaryArray curves;
+	std::vector<double> xs(n), x2s(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		const double a = coeffsValues.at(0)[i % coeffValuesNum] * (1 + i * 1e-4);
+		curves.push_back(a);
+		xs[i] = a * (static_cast<double>(i % 701) / 20 - 17.5);
+		x2s[i] = -xs[i] / 3;
+	}
+	ASSERT_EQ(n, curves.size());
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(curves.a()) % curve::CatenaryArray::alignment);
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(curves.inv_a()) % curve::CatenaryArray::alignment);
+
+	std::vector<double> ys(n), ls(n), Rs(n), Ss(n);
+	curves.y(xs.data(), ys.data());
+	curves.l(xs.data(), ls.data());
+	curves.R(xs.data(), Rs.data());
+	curves.S(xs.data(), x2s.data(), Ss.data());
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		const curve::Catenary c = curves[i];
+		const double x = xs[i], a = c.get_a();
+		// the stored 1 / a adds a rounding to u, cosh / sinh grow it by |u|
+		const double rel = 1e-14 * (1 + std::abs(x / a));
+		EXPECT_EQ(1 / a, curves.inv_a()[i]);
+		EXPECT_EQ(a * a, curves.a2()[i]);
+
+		EXPECT_TRUE(double_close(ys[i], c.y(x), std::abs(c.y(x)), rel))
+			<< EXPECT_failureinfo(c.y(x), ys[i], x, a, "ARRAY Y");
+		EXPECT_TRUE(double_close(ls[i], c.l(x), std::abs(c.l(x)), rel))
+			<< EXPECT_failureinfo(c.l(x), ls[i], x, a, "ARRAY L");
+		EXPECT_TRUE(double_close(Rs[i], c.R(x), std::abs(c.R(x)), 2 * rel))
+			<< EXPECT_failureinfo(c.R(x), Rs[i], x, a, "ARRAY R");
+		EXPECT_TRUE(double_close(Ss[i], c.S(x, x2s[i]), std::abs(a) * (std::abs(c.l(x)) + std::abs(c.l(x2s[i]))), rel))
+			<< EXPECT_failureinfo(c.S(x, x2s[i]), Ss[i], x, a, "ARRAY S");
+	}
+
+	// a gather through a permutation runs the same kernels on the same values
+	std::vector<std::uint32_t> idx(n);
+	std::vector<double> gx(n), gx2(n);
+	for (std::size_t k = 0; k < n; ++k)
+	{
+		idx[k] = static_cast<std::uint32_t>(k * 1237 % n);
+		gx[k] = xs[idx[k]];
+		gx2[k] = x2s[idx[k]];
+	}
+	std::vector<double> gy(n), gl(n), gR(n), gS(n);
+	curves.y(idx.data(), gx.data(), gy.data(), n);
+	curves.l(idx.data(), gx.data(), gl.data(), n);
+	curves.R(idx.data(), gx.data(), gR.data(), n);
+	curves.S(idx.data(), gx.data(), gx2.data(), gS.data(), n);
+	for (std::size_t k = 0; k < n; ++k)
+	{
+		EXPECT_EQ(0, std::memcmp(&ys[idx[k]], &gy[k], sizeof(double)));
+		EXPECT_EQ(0, std::memcmp(&ls[idx[k]], &gl[k], sizeof(double)));
+		EXPECT_EQ(0, std::memcmp(&Rs[idx[k]], &gR[k], sizeof(double)));
+		EXPECT_EQ(0, std::memcmp(&Ss[idx[k]], &gS[k], sizeof(double)));
+	}
+
+	curve::CatenaryArray copy(curves.a(), curves.size());
+	copy.set_a(5, 2);
+	EXPECT_EQ(2, copy[5].get_a());
+	EXPECT_EQ(4, copy.a2()[5]);
+	EXPECT_EQ(curves[6].get_a(), copy[6].get_a());
+	EXPECT_THROW(copy.push_back(0), std::invalid_argument);
+	EXPECT_THROW(copy.set_a(0, std::numeric_limits<double>::quiet_NaN()), std::invalid_argument);
+	// a Catenary, but 1 / a overflows to inf
+	ASSERT_TRUE(curve::Catenary::make(1e-310));
+	EXPECT_THROW(copy.push_back(1e-310), std::invalid_argument);
+	EXPECT_THROW(copy.set_a(0, -1e-310), std::invalid_argument);
+	EXPECT_EQ(curves[0].get_a(), copy[0].get_a());
+	EXPECT_EQ(n, copy.size());
+	copy.push_back(1e-300);
+	EXPECT_EQ(n + 1, copy.size());
+}
+
+TEST_F(Catenary_Test, SinglePrecisionCheck)
+{
+	addCoeffValues(
+		{ -100, -1, -0.01, 0.01, 1, 100 }
+	);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const double a = *coeffIt;
+		const curve::Catenary c(a);
+		const curve::BasicCatenary<float> cf = *curve::BasicCatenary<float>::make(static_cast<float>(a));
+		std::vector<double> xs;
+		std::vector<float> xfs;
+		// |u| <= 5 in the first blocks, then out to 35
+		for (int i = -1000; i <= 1300; ++i)
+		{
+			xs.push_back(a * (i <= 1000 ? i / 200.0 : (i - 950) / 10.0));
+			xfs.push_back(static_cast<float>(xs.back()));
+		}
+		const std::size_t n = xs.size();
+
+		std::vector<float> yf(n), lf(n), Rf(n);
+		cf.y(xfs.data(), yf.data(), n);
+		cf.l(xfs.data(), lf.data(), n);
+		cf.R(xfs.data(), Rf.data(), n);
+
+		// loose enough for float32 up to |u| = 5, R included, and not much further
+		const double tolerance = 30 * FLT_EPSILON;
+		std::vector<double> ys(n), ls(n), Rs(n);
+		c.y(xs.data(), ys.data(), n, tolerance);
+		c.l(xs.data(), ls.data(), n, tolerance);
+		c.R(xs.data(), Rs.data(), n, tolerance);
+
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const double x = xs[i], au = std::abs(x / a);
+			// the float path from its own float input, then the tolerance forms
+			const float uf = xfs[i] / cf.get_a();
+			const double bound = (3 + 2 * au) * FLT_EPSILON;
+			if (au < 40)
+			{
+				const double y = cf.get_a() * std::cosh(static_cast<double>(uf));
+				EXPECT_TRUE(double_close(yf[i], y, std::abs(y), bound)) << EXPECT_failureinfo(y, yf[i], x, a, "FLOAT Y");
+				const double l = cf.get_a() * std::sinh(static_cast<double>(uf));
+				EXPECT_TRUE(double_close(lf[i], l, std::abs(l), bound)) << EXPECT_failureinfo(l, lf[i], x, a, "FLOAT L");
+				const double R = y * std::cosh(static_cast<double>(uf));
+				EXPECT_TRUE(double_close(Rf[i], R, std::abs(R), 2 * bound)) << EXPECT_failureinfo(R, Rf[i], x, a, "FLOAT R");
+			}
+			EXPECT_TRUE(double_close(ys[i], c.y(x), std::abs(c.y(x)), tolerance))
+				<< EXPECT_failureinfo(c.y(x), ys[i], x, a, "TOLERANCE Y");
+			EXPECT_TRUE(double_close(ls[i], c.l(x), std::abs(c.l(x)), tolerance))
+				<< EXPECT_failureinfo(c.l(x), ls[i], x, a, "TOLERANCE L");
+			EXPECT_TRUE(double_close(Rs[i], c.R(x), std::abs(c.R(x)), tolerance))
+				<< EXPECT_failureinfo(c.R(x), Rs[i], x, a, "TOLERANCE R");
+		}
+	}
+
+	EXPECT_EQ(curve::precision::float32, curve::select_precision(2, 0, 2, 1, 1e-6));
+	EXPECT_EQ(curve::precision::float64, curve::select_precision(2, 0, 2, 1, 1e-9));
+	EXPECT_EQ(curve::precision::float64, curve::select_precision(2, 0, 200, 1, 1));
+	EXPECT_EQ(curve::precision::float64, curve::select_precision(1e-300, 0, 1e-300, 1, 1));
+	EXPECT_EQ(curve::precision::float64, curve::select_precision(2, 1e-200, 2, 1, 1));
+	// x / a underflows a float although x and a do not
+	EXPECT_EQ(curve::precision::float64, curve::select_precision(1e30, 1e-30, 1e-29, 1, 1e-3));
+	// a < 1 keeps a * cosh^power finite well past where cosh^power overflows a float
+	EXPECT_EQ(curve::precision::float64, curve::select_precision(1e-3, 0, 0.093, 1, 1e-3));
+	EXPECT_EQ(curve::precision::float64, curve::select_precision(1e-3, 0, 0.047, 2, 1e-3));
+	const curve::Catenary small(1e-3);
+	std::vector<double> edge, edgeY, edgeR;
+	// |u| from 40 to 100, across the float overflow of cosh and cosh^2
+	for (int i = 0; i <= 600; ++i) edge.push_back(1e-3 * (40 + i / 10.0));
+	edgeY.resize(edge.size());
+	edgeR.resize(edge.size());
+	small.y(edge.data(), edgeY.data(), edge.size(), 1e-3);
+	small.R(edge.data(), edgeR.data(), edge.size(), 1e-3);
+	for (std::size_t i = 0; i < edge.size(); ++i)
+	{
+		const double x = edge[i];
+		EXPECT_TRUE(double_close(edgeY[i], small.y(x), std::abs(small.y(x)), 1e-3))
+			<< EXPECT_failureinfo(small.y(x), edgeY[i], x, 1e-3, "SMALL A Y");
+		EXPECT_TRUE(double_close(edgeR[i], small.R(x), std::abs(small.R(x)), 1e-3))
+			<< EXPECT_failureinfo(small.R(x), edgeR[i], x, 1e-3, "SMALL A R");
+	}
+	const curve::Catenary huge(1e30);
+	const double tiny[] = { 1e-30, 2e-30, 5e-30, 1e-29 };
+	double tinyL[4];
+	huge.l(tiny, tinyL, 4, 1e-3);
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		EXPECT_TRUE(double_close(tinyL[i], tiny[i], tiny[i], 1e-3)) << EXPECT_failureinfo(tiny[i], tinyL[i], tiny[i], 1e30, "TINY L");
+	}
+
+	// long double has no kernels, its batch forms loop over the scalar ones
+	const curve::BasicCatenary<long double> cl = *curve::BasicCatenary<long double>::make(2.5L);
+	const long double xl[] = { -3, 0, 0.5L, 7 };
+	long double yl[4], Rl[4];
+	cl.y(xl, yl, 4);
+	cl.R(xl, Rl, 4);
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		EXPECT_EQ(cl.y(xl[i]), yl[i]);
+		EXPECT_EQ(cl.R(xl[i]), Rl[i]);
+	}
+	EXPECT_FALSE(curve::BasicCatenary<float>::make(0));
+	EXPECT_FALSE(curve::BasicCatenary<float>::make(INFINITY));
+	EXPECT_FALSE(curve::BasicCatenary<double>::make(0));
+	EXPECT_FALSE(curve::BasicCatenary<long double>::make(-NAN));
+	static_assert(noexcept(curve::BasicCatenary<double>::make(0)), "make never throws");
+	EXPECT_EQ(2.5, cl.runtime().get_a());
+}
+
+TEST_F(Catenary_Test, InverseCheck)
+{
+	addCoeffValues(
+		{ -100, -1, -0.01, 0.01, 1, 100 }
+	);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const double a = *coeffIt;
+		const curve::Catenary c(a);
+		std::vector<double> xs, ys, ls, x1s, Ss;
+		for (int i = -600; i <= 600; ++i)
+		{
+			const double x = std::abs(a) * i * 0.0333;
+			xs.push_back(x);
+			ys.push_back(c.y(x));
+			ls.push_back(c.l(x));
+			x1s.push_back(-x / 3);
+			Ss.push_back(c.S(-x / 3, x));
+		}
+
+		std::vector<double> from_y(xs.size()), from_l(xs.size()), from_S(xs.size());
+		c.x_of_y(ys.data(), from_y.data(), xs.size());
+		c.x_of_l(ls.data(), from_l.data(), xs.size());
+		c.x2_of_S(x1s.data(), Ss.data(), from_S.data(), xs.size());
+
+		for (std::size_t i = 0; i < xs.size(); ++i)
+		{
+			const double x = xs[i], u = std::abs(x / a);
+			// dx = dy / sinh(u), the rounding of y costs digits next to the vertex
+			const double y_rel = u < 1 ? 1e-13 / std::max(u, 1e-3) : 1e-14;
+
+			EXPECT_TRUE(double_close(c.x_of_y(ys[i]), std::abs(x), std::abs(a) * (1 + u), y_rel))
+				<< EXPECT_failureinfo(std::abs(x), c.x_of_y(ys[i]), ys[i], a, "X OF Y");
+			EXPECT_TRUE(double_close(from_y[i], std::abs(x), std::abs(a) * (1 + u), y_rel))
+				<< EXPECT_failureinfo(std::abs(x), from_y[i], ys[i], a, "BATCH X OF Y");
+			EXPECT_TRUE(double_close(c.x_of_l(ls[i]), x, std::abs(a) * (1 + u)))
+				<< EXPECT_failureinfo(x, c.x_of_l(ls[i]), ls[i], a, "X OF L");
+			EXPECT_TRUE(double_close(from_l[i], x, std::abs(a) * (1 + u)))
+				<< EXPECT_failureinfo(x, from_l[i], ls[i], a, "BATCH X OF L");
+			EXPECT_TRUE(double_close(c.x2_of_S(x1s[i], Ss[i]), x, std::abs(a) * (1 + u)))
+				<< EXPECT_failureinfo(x, c.x2_of_S(x1s[i], Ss[i]), Ss[i], a, "X2 OF S");
+			EXPECT_TRUE(double_close(from_S[i], x, std::abs(a) * (1 + u)))
+				<< EXPECT_failureinfo(x, from_S[i], Ss[i], a, "BATCH X2 OF S");
+		}
+
+		// no point of the curve lies between the vertex and the x axis
+		EXPECT_TRUE(std::isnan(c.x_of_y(a / 2)));
+		EXPECT_TRUE(std::isnan(c.x_of_y(-a)));
+	}
+
+	for (double span : { 1e-3, 1.0, 250.0 })
+		for (double ratio : { 1e-6, 0.01, 0.5, 3.0, 40.0 })
+		{
+			const double sag = span * ratio;
+			const double a = curve::Catenary::fit_a(span, sag);
+			ASSERT_TRUE(a > 0) << span << " " << sag;
+			// y(span / 2) - a without the cancellation of a shallow curve
+			const double fitted = 2 * a * std::pow(std::sinh(span / (4 * a)), 2);
+			EXPECT_TRUE(double_close(fitted, sag, sag, 1e-13))
+				<< EXPECT_failureinfo(sag, fitted, span, a, "FIT A");
+
+			double batch_a;
+			curve::Catenary::fit_a(&span, &sag, &batch_a, 1);
+			EXPECT_EQ(a, batch_a);
+		}
+
+	EXPECT_TRUE(std::isnan(curve::Catenary::fit_a(0, 1)));
+	EXPECT_TRUE(std::isnan(curve::Catenary::fit_a(1, -1)));
+	EXPECT_TRUE(std::isnan(curve::Catenary::fit_a(INFINITY, 1)));
+}
+
+TEST_F(Catenary_Test, IntegratorCheck)
+{
+	addCoeffValues(
+		{ -100, -1, -0.01, 0.01, 1, 100 }
+	);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const double a = *coeffIt;
+		const curve::Catenary c(a);
+		const curve::Integrator integrals(a);
+
+		// short, panel-sized and many-panel intervals, some of them reversed
+		std::vector<double> x1s, x2s;
+		for (const double width : { 1e-3, 0.7, 5.0, -9.0, 41.0 })
+			for (int i = -40; i <= 40; ++i)
+			{
+				x1s.push_back(std::abs(a) * i * 0.137);
+				x2s.push_back(x1s.back() + std::abs(a) * width);
+			}
+		const std::size_t n = x1s.size();
+
+		typedef void (curve::Integrator::*closed_form)(const double*, const double*, double*, std::size_t) const;
+		struct { closed_form f; double (*integrand)(double x, double y); const char* name; } forms[] = {
+			{ &curve::Integrator::y_dx, [](double, double y) { return y; }, "Y DX" },
+			{ &curve::Integrator::y2_dx, [](double, double y) { return y * y; }, "Y2 DX" },
+			{ &curve::Integrator::ds, [](double, double) { return 1.0; }, "DS" },
+			{ &curve::Integrator::x_ds, [](double x, double) { return x; }, "X DS" },
+			{ &curve::Integrator::y_ds, [](double, double y) { return y; }, "Y DS" },
+			{ &curve::Integrator::x2_ds, [](double x, double) { return x * x; }, "X2 DS" },
+			{ &curve::Integrator::y2_ds, [](double, double y) { return y * y; }, "Y2 DS" }
+		};
+
+		for (std::size_t k = 0; k < sizeof(forms) / sizeof(*forms); ++k)
+		{
+			const bool over_dx = k < 2;
+			std::vector<double> closed(n), quadrature(n), scale(n);
+			(integrals.*forms[k].f)(x1s.data(), x2s.data(), closed.data(), n);
+			integrals.integrate(x1s.data(), x2s.data(), quadrature.data(), n,
+				[&](const curve::Integrator::nodes& at, double* values) {
+					for (std::size_t j = 0; j < at.n; ++j)
+						values[j] = forms[k].integrand(at.x[j], at.y[j]) / (over_dx ? at.ds[j] : 1.0);
+				});
+			// the integral of |f|, which the rounding of either is relative to
+			integrals.integrate(x1s.data(), x2s.data(), scale.data(), n,
+				[&](const curve::Integrator::nodes& at, double* values) {
+					for (std::size_t j = 0; j < at.n; ++j)
+						values[j] = std::abs(forms[k].integrand(at.x[j], at.y[j]) / (over_dx ? at.ds[j] : 1.0));
+				});
+
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				// the closed forms difference values at the ends
+				const double ends = std::abs(x1s[i]) + std::abs(x2s[i]) + std::abs(a),
+					rel = 1e-13 * std::max(1.0, ends / std::abs(x2s[i] - x1s[i]));
+				EXPECT_TRUE(double_close(closed[i], quadrature[i], std::abs(scale[i]), rel))
+					<< EXPECT_failureinfo(quadrature[i], closed[i], x2s[i], a, forms[k].name);
+			}
+		}
+
+		std::vector<double> areas(n), cxs(n), cys(n), lengths(n), xds(n), yds(n);
+		integrals.y_dx(x1s.data(), x2s.data(), areas.data(), n);
+		integrals.centroid(x1s.data(), x2s.data(), cxs.data(), cys.data(), n);
+		integrals.ds(x1s.data(), x2s.data(), lengths.data(), n);
+		integrals.x_ds(x1s.data(), x2s.data(), xds.data(), n);
+		integrals.y_ds(x1s.data(), x2s.data(), yds.data(), n);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			EXPECT_TRUE(double_close(areas[i], c.S(x1s[i], x2s[i]), std::abs(a) * (std::abs(c.l(x1s[i])) + std::abs(c.l(x2s[i])))))
+				<< EXPECT_failureinfo(c.S(x1s[i], x2s[i]), areas[i], x2s[i], a, "AREA");
+			EXPECT_TRUE(double_close(cxs[i], xds[i] / lengths[i], std::abs(xds[i] / lengths[i])))
+				<< EXPECT_failureinfo(xds[i] / lengths[i], cxs[i], x2s[i], a, "CENTROID X");
+			EXPECT_TRUE(double_close(cys[i], yds[i] / lengths[i], std::abs(yds[i] / lengths[i])))
+				<< EXPECT_failureinfo(yds[i] / lengths[i], cys[i], x2s[i], a, "CENTROID Y");
+		}
+
+		// next to the vertex int x^2 ds = a^3 (u^3 / 3 + u^5 / 10 + u^7 / 168 + ...)
+		const double x0 = 0, x1 = 1e-3 * a, u = 1e-3;
+		double inertia;
+		integrals.x2_ds(&x0, &x1, &inertia, 1);
+		EXPECT_TRUE(double_close(inertia, a * a * a * (u * u * u / 3 + std::pow(u, 5) / 10 + std::pow(u, 7) / 168), std::abs(inertia)))
+			<< EXPECT_failureinfo(a * a * a * u * u * u / 3, inertia, x1, a, "VERTEX X2 DS");
+	}
+
+	EXPECT_THROW(curve::Integrator(0), std::invalid_argument);
+	EXPECT_THROW(curve::Integrator(NAN), std::invalid_argument);
+}
+
+TEST_F(Catenary_Test, ReferenceCatenaryCheck)
+{
+	// correctly rounded values, worked out to 80 digits elsewhere
+	struct { double a, x, y, l, R; } points[] = {
+		{ 1, 0.5, 1.1276259652063807, 0.5210953054937474, 1.2715403174076219 },
+		{ -2.5, 3.75, -5.8810240381081185, 5.323198637737044, -13.834577494722208 },
+		{ 10, -27.3, 76.99053154787663, -76.33833865119534, 592.7541948024585 },
+		{ 0.01, 0.35, 7930067261567.131, 7930067261567.131, 6.28859667729788e+27 },
+		// cosh(750) overflows, a cosh(750) does not
+		{ 1e-300, 7.5e-298, 2.6292472707273194e+25, 2.6292472707273194e+25, INFINITY },
+		{ 100, 1e-06, 100.0, 1e-06, 100.00000000000001 },
+		{ 3, 120.0, 3.5307790025553e+17, 3.5307790025553e+17, 4.155466788295132e+34 },
+		{ -7, 2000.0, -4.248207594551184e+124, 4.248207594551184e+124, -2.578181109486052e+248 }
+	};
+	for (const auto& p : points)
+	{
+		const curve::ReferenceCatenary r(p.a);
+		EXPECT_EQ(p.y, r.y(p.x)) << p.a << " " << p.x;
+		EXPECT_EQ(p.l, r.l(p.x)) << p.a << " " << p.x;
+		EXPECT_EQ(p.R, r.R(p.x)) << p.a << " " << p.x;
+	}
+
+	struct { double a, x1, x2, S; } areas[] = {
+		{ 1, 0.5, 0.5000001, 1.1276259906676154e-07 },
+		{ 10, -27.3, 27.3, 1526.766773023907 },
+		{ -4, 1.0, -3.0, 17.19886477990397 },
+		{ 1e-300, 7e-298, 7.1e-298, 1.1169466714780793e-292 }
+	};
+	for (const auto& p : areas)
+		EXPECT_EQ(p.S, curve::ReferenceCatenary(p.a).S(p.x1, p.x2)) << p.a << " " << p.x1 << " " << p.x2;
+
+	const curve::coords_pair centers = curve::ReferenceCatenary(2).CurvatureCenterCoords(1.5);
+	EXPECT_EQ(3.6292794550948173, centers.first.first);
+	EXPECT_EQ(0.0, centers.first.second);
+	EXPECT_EQ(-0.6292794550948175, centers.second.first);
+	EXPECT_EQ(5.178733138707379, centers.second.second);
+	const curve::coords_pair below = curve::ReferenceCatenary(-0.5).CurvatureCenterCoords(0.25);
+	EXPECT_EQ(-0.043800298410950365, below.first.first);
+	EXPECT_EQ(-1.1276259652063807, below.first.second);
+	EXPECT_EQ(0.5438002984109503, below.second.first);
+	EXPECT_EQ(0.0, below.second.second);
+	// near the vertex one center is x - a sinh(u) cosh(u), some u^2 below x
+	struct { double a, x, first, second; } vertex[] = {
+		{ 1, 1e-8, 2e-08, -6.666666666666667e-25 },
+		{ 1, 1e-10, 2e-10, -6.6666666666666675e-31 },
+		{ -2.5, 2.5e-12, -1.6666666666666662e-36, 5e-12 },
+		{ 3, 3e-5, 6.0000000002e-05, -2.00000000004e-15 },
+		{ 1, 0.4, 0.8440529910938116, -0.044052991093811514 },
+		{ 1e300, 1e180, 2e180, -6.666666666666666e-61 }
+	};
+	for (const auto& p : vertex)
+	{
+		const curve::coords_pair c = curve::ReferenceCatenary(p.a).CurvatureCenterCoords(p.x);
+		EXPECT_EQ(p.first, c.first.first) << p.a << " " << p.x;
+		EXPECT_EQ(p.second, c.second.first) << p.a << " " << p.x;
+	}
+
+	// the scalar methods stay within a few ulps of it where x / a is exact
+	addCoeffValues(
+		{ -1024, -1, -0.125, 0.125, 1, 1024 }
+	);
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const curve::Catenary c(*coeffIt);
+		const curve::ReferenceCatenary r(*coeffIt);
+		for (int i = -400; i <= 400; ++i)
+		{
+			const double x = *coeffIt * i / 16.0;
+			EXPECT_TRUE(double_close(c.y(x), r.y(x), std::abs(r.y(x)), 4 * DBL_EPSILON))
+				<< EXPECT_failureinfo(r.y(x), c.y(x), x, *coeffIt, "REFERENCE Y");
+			EXPECT_TRUE(double_close(c.l(x), r.l(x), std::abs(r.l(x)), 4 * DBL_EPSILON))
+				<< EXPECT_failureinfo(r.l(x), c.l(x), x, *coeffIt, "REFERENCE L");
+			EXPECT_TRUE(double_close(c.R(x), r.R(x), std::abs(r.R(x)), 8 * DBL_EPSILON))
+				<< EXPECT_failureinfo(r.R(x), c.R(x), x, *coeffIt, "REFERENCE R");
+		}
+	}
+
+	EXPECT_EQ(0.0, curve::ReferenceCatenary(3).S(2, 2));
+	EXPECT_TRUE(std::isnan(curve::ReferenceCatenary(3).y(NAN)));
+	EXPECT_EQ(INFINITY, curve::ReferenceCatenary(3).y(1e300));
+	EXPECT_THROW(curve::ReferenceCatenary(0), std::invalid_argument);
+
+	// the verifier measures in ulps of the reference result
+	curve::Verifier verifier(3);
+	EXPECT_TRUE(verifier.due(0));
+	EXPECT_FALSE(verifier.due(4));
+	const double y = 1.1276259652063807, off = std::nextafter(std::nextafter(y, 2.0), 2.0), nan = NAN;
+	EXPECT_EQ(0.0, verifier.check(curve::query::ordinate, 1, 0.5, 0, &y));
+	EXPECT_EQ(2.0, verifier.check(curve::query::ordinate, 1, 0.5, 0, &off));
+	EXPECT_EQ(INFINITY, verifier.check(curve::query::ordinate, 1, 0.5, 0, &nan));
+	const curve::Verifier::summary v = verifier.result(curve::query::ordinate);
+	EXPECT_EQ(3u, v.checked);
+	EXPECT_EQ(INFINITY, v.max_ulps);
+	EXPECT_EQ(0u, verifier.result(curve::query::area).checked);
+	EXPECT_THROW(curve::Verifier(0), std::invalid_argument);
+}
+
+TEST_F(Catenary_Test, PolylineCheck)
+{
+	addCoeffValues(
+		{ -200, -10, -0.5, 0.5, 3, 200 }
+	);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const curve::Catenary c(*coeffIt);
+		const double r = std::abs(*coeffIt), x1 = -8 * r, x2 = 5 * r;
+
+		for (const double tolerance : { 1e-4 * r, 1e-2 * r, 2 * r })
+		{
+			const curve::PolylineGenerator polyline(tolerance, 1);
+			curve::CoordBuffer vertices(polyline.count(*coeffIt, x1, x2));
+			std::vector<double> s(vertices.size());
+			ASSERT_EQ(vertices.size(), polyline.generate(*coeffIt, x1, x2, vertices.view(), s.data()));
+
+			EXPECT_EQ(x1, vertices.xs()[0]);
+			EXPECT_EQ(x2, vertices.xs()[vertices.size() - 1]);
+			EXPECT_EQ(0.0, s[0]);
+			EXPECT_EQ(std::abs(c.l(x2) - c.l(x1)), s[vertices.size() - 1]);
+			// fewer vertices than an even step in arc length would need
+			EXPECT_GT(s.back() / polyline.step(*coeffIt) / 3, vertices.size());
+
+			// each chord against the point of the arc where the slope is the chord's
+			double worst = 0;
+			for (std::size_t i = 0; i + 1 < vertices.size(); ++i)
+			{
+				const double x = vertices.xs()[i], y = vertices.ys()[i];
+				EXPECT_TRUE(double_close(y, c.y(x), std::abs(c.y(x)), 1e-13))
+					<< EXPECT_failureinfo(c.y(x), y, x, *coeffIt, "POLYLINE Y");
+				EXPECT_LT(s[i], s[i + 1]);
+
+				const double m = (vertices.ys()[i + 1] - y) / (vertices.xs()[i + 1] - x),
+					tangent = *coeffIt * std::asinh(m);
+				worst = std::max(worst, std::abs(y + m * (tangent - x) - c.y(tangent)) / std::sqrt(1 + m * m));
+			}
+			EXPECT_GE(tolerance * (1 + 1e-6), worst) << *coeffIt << " " << tolerance;
+			EXPECT_LE(tolerance / 4, worst) << *coeffIt << " " << tolerance;
+		}
+	}
+
+	// many curves, either way along x
+	std::vector<curve::PolylineGenerator::span> spans;
+	for (int i = 0; i < 300; ++i)
+	{
+		const double a = (i % 2 ? -1 : 1) * (0.5 + i % 17);
+		spans.push_back(curve::PolylineGenerator::span{ a, -0.3 * i, i % 3 ? 2.5 * a : -4.0 });
+	}
+	curve::PolylineGenerator polyline(0.01, 4);
+	std::vector<std::size_t> first(spans.size() + 1);
+	const std::size_t total = polyline.offsets(spans.data(), spans.size(), first.data());
+	curve::CoordBuffer serial(total), parallel(total);
+	std::vector<double> s1(total), s2(total);
+	polyline.run_serial(spans.data(), spans.size(), first.data(), serial.view(), s1.data());
+	polyline.run(spans.data(), spans.size(), first.data(), parallel.view(), s2.data());
+	EXPECT_EQ(0, std::memcmp(serial.xs(), parallel.xs(), total * sizeof(double)));
+	EXPECT_EQ(0, std::memcmp(serial.ys(), parallel.ys(), total * sizeof(double)));
+	EXPECT_EQ(0, std::memcmp(s1.data(), s2.data(), total * sizeof(double)));
+
+	const curve::PolylineGenerator::span& one = spans[137];
+	curve::CoordBuffer single(polyline.count(one.a, one.x1, one.x2));
+	std::vector<double> s3(single.size());
+	polyline.generate(one.a, one.x1, one.x2, single.view(), s3.data());
+	EXPECT_EQ(first[138] - first[137], single.size());
+	EXPECT_EQ(0, std::memcmp(single.ys(), serial.ys() + first[137], single.size() * sizeof(double)));
+
+	EXPECT_EQ(2u, polyline.count(1, 3, 3));
+	EXPECT_THROW(polyline.generate(1, 0, 10, serial.view().subview(0, 3), s1.data()), std::invalid_argument);
+	EXPECT_THROW(polyline.count(1, 0, INFINITY), std::invalid_argument);
+	EXPECT_THROW(polyline.count(0, 0, 1), std::invalid_argument);
+	EXPECT_THROW(curve::PolylineGenerator(0, 1), std::invalid_argument);
+}
+
+TEST_F(Catenary_Test, ShiftedCatenaryCheck)
+{
+	addCoeffValues(
+		{ -3, -0.5, 0.5, 2, 40, 1000 }
+	);
+
+	std::vector<double> xs;
+	for (int i = -20; i <= 20; ++i) xs.push_back(1.7 * i);
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const curve::Catenary c(*coeffIt);
+		const curve::ShiftedCatenary shifted(*coeffIt, 4.5, -12);
+		EXPECT_EQ(*coeffIt, shifted.centered().get_a());
+
+		std::vector<double> y(xs.size()), l(xs.size()), R(xs.size()), S(xs.size()), x2s(xs.size());
+		curve::CoordBuffer first(xs.size()), second(xs.size());
+		for (std::size_t i = 0; i < xs.size(); ++i) x2s[i] = xs[i] + 3;
+		shifted.y(xs.data(), y.data(), xs.size());
+		shifted.l(xs.data(), l.data(), xs.size());
+		shifted.R(xs.data(), R.data(), xs.size());
+		shifted.S(xs.data(), x2s.data(), S.data(), xs.size());
+		shifted.CurvatureCenterCoords(xs.data(), first.view(), second.view());
+
+		for (std::size_t i = 0; i < xs.size(); ++i)
+		{
+			const double x = xs[i], u = x - 4.5;
+			EXPECT_EQ(c.y(u) - 12, shifted.y(x));
+			EXPECT_EQ(c.l(u), shifted.l(x));
+			EXPECT_EQ(c.R(u), shifted.R(x));
+			EXPECT_TRUE(double_close(c.S(u, u + 3) - 36, shifted.S(x, x + 3), std::abs(c.S(u, u + 3)) + 36, 1e-14))
+				<< EXPECT_failureinfo(c.S(u, u + 3) - 36, shifted.S(x, x + 3), x, *coeffIt, "SHIFTED S");
+			const curve::coords_pair centers = shifted.CurvatureCenterCoords(x);
+			EXPECT_EQ(c.CurvatureCenterCoords(u).first.second - 12, centers.first.second);
+
+			const double a = std::abs(*coeffIt), along = std::abs(x) + std::abs(c.l(u) * (c.y(u) / a)) + 4.5;
+			EXPECT_TRUE(double_close(shifted.y(x), y[i], std::abs(c.y(u)) + 12))
+				<< EXPECT_failureinfo(shifted.y(x), y[i], x, *coeffIt, "SHIFTED BATCH Y");
+			EXPECT_TRUE(double_close(shifted.l(x), l[i], std::abs(c.l(u))))
+				<< EXPECT_failureinfo(shifted.l(x), l[i], x, *coeffIt, "SHIFTED BATCH L");
+			EXPECT_TRUE(double_close(shifted.R(x), R[i], std::abs(c.R(u))))
+				<< EXPECT_failureinfo(shifted.R(x), R[i], x, *coeffIt, "SHIFTED BATCH R");
+			EXPECT_TRUE(double_close(shifted.S(x, x2s[i]), S[i], a * (std::abs(c.l(u)) + std::abs(c.l(u + 3))) + 36))
+				<< EXPECT_failureinfo(shifted.S(x, x2s[i]), S[i], x, *coeffIt, "SHIFTED BATCH S");
+			EXPECT_TRUE(double_close(centers.first.first, first.xs()[i], along))
+				<< EXPECT_failureinfo(centers.first.first, first.xs()[i], x, *coeffIt, "SHIFTED BATCH CENTER X");
+			EXPECT_TRUE(double_close(centers.second.second, second.ys()[i], 2 * std::abs(c.y(u)) + 12))
+				<< EXPECT_failureinfo(centers.second.second, second.ys()[i], x, *coeffIt, "SHIFTED BATCH CENTER Y");
+		}
+	}
+
+	// supports at every slope and either way round, lengths and sags from
+	// barely above the chord to deep
+	std::vector<curve::ShiftedCatenary::span> spans;
+	std::vector<double> lengths, sags;
+	for (int i = 0; i < 600; ++i)
+	{
+		const double x1 = -50 + i % 23, h = std::pow(10.0, (i % 7) / 2.0 - 1), v = h * ((i % 11) - 5) * (i % 5 ? 0.4 : 6), y1 = (i % 13) - 6;
+		curve::ShiftedCatenary::span e{ x1, y1, x1 + h, y1 + v };
+		if (i % 2)
+		{
+			std::swap(e.x1, e.x2);
+			std::swap(e.y1, e.y2);
+		}
+		spans.push_back(e);
+		lengths.push_back(std::hypot(h, v) * (1 + std::pow(10.0, (i % 9) - 7)));
+		sags.push_back(h * std::pow(10.0, (i % 6) - 4));
+	}
+	std::vector<curve::ShiftedCatenary> by_length(spans.size()), by_sag(spans.size());
+	curve::ShiftedCatenary::fit_length(spans.data(), lengths.data(), by_length.data(), spans.size());
+	curve::ShiftedCatenary::fit_sag(spans.data(), sags.data(), by_sag.data(), spans.size());
+
+	for (std::size_t i = 0; i < spans.size(); ++i)
+	{
+		const curve::ShiftedCatenary::span& e = spans[i];
+		for (const curve::ShiftedCatenary& fitted : { by_length[i], by_sag[i] })
+		{
+			ASSERT_GT(fitted.get_a(), 0) << i;
+			// y at a support moves with x0 times the slope l / a there
+			const double a = fitted.get_a(), scale = std::abs(e.y1) + std::abs(e.y2) + a + std::abs(fitted.get_y0())
+				+ std::abs(e.x1) * std::abs(fitted.l(e.x1) / a) + std::abs(e.x2) * std::abs(fitted.l(e.x2) / a);
+			EXPECT_TRUE(double_close(e.y1, fitted.y(e.x1), scale, 1e-14)) << i;
+			EXPECT_TRUE(double_close(e.y2, fitted.y(e.x2), scale, 1e-14)) << i;
+		}
+		EXPECT_TRUE(double_close(lengths[i], std::abs(by_length[i].l(e.x2) - by_length[i].l(e.x1)), lengths[i], 1e-9)) << i;
+		const double middle = 0.5 * (e.x1 + e.x2), a = by_sag[i].get_a(),
+			scale = std::abs(e.y1) + std::abs(e.y2) + a + std::abs(by_sag[i].get_y0()) + std::abs(middle) * std::abs(by_sag[i].l(middle) / a);
+		EXPECT_TRUE(double_close(sags[i], 0.5 * (e.y1 + e.y2) - by_sag[i].y(middle), scale, 1e-13)) << i;
+
+		const std::optional<curve::ShiftedCatenary> one = curve::ShiftedCatenary::fit_length(e, lengths[i]);
+		ASSERT_TRUE(one.has_value());
+		EXPECT_EQ(by_length[i].get_a(), one->get_a());
+		EXPECT_EQ(by_length[i].get_x0(), one->get_x0());
+	}
+
+	// level supports: the sag is the vertex's and the vertex in the middle
+	for (const double sag : { 1e-3, 0.7, 25.0 })
+	{
+		const std::optional<curve::ShiftedCatenary> level = curve::ShiftedCatenary::fit_sag({ 3, 2, 13, 2 }, sag);
+		ASSERT_TRUE(level.has_value());
+		EXPECT_TRUE(double_close(curve::Catenary::fit_a(10, sag), level->get_a(), level->get_a(), 1e-12)) << sag;
+		EXPECT_NEAR(8, level->get_x0(), 1e-12);
+	}
+
+	const curve::ShiftedCatenary::span e{ 0, 0, 3, 4 };
+	EXPECT_FALSE(curve::ShiftedCatenary::fit_length(e, 5).has_value());
+	EXPECT_FALSE(curve::ShiftedCatenary::fit_length(e, 4).has_value());
+	EXPECT_FALSE(curve::ShiftedCatenary::fit_length(e, NAN).has_value());
+	EXPECT_FALSE(curve::ShiftedCatenary::fit_sag(e, 0).has_value());
+	EXPECT_FALSE(curve::ShiftedCatenary::fit_sag(e, -1).has_value());
+	EXPECT_FALSE(curve::ShiftedCatenary::fit_sag({ 1, 0, 1, 4 }, 1).has_value());
+	EXPECT_TRUE(curve::ShiftedCatenary::fit_length(e, 5.001).has_value());
+}
+
+TEST_F(Catenary_Test, KernelDispatchCheck)
+{
+	addCoeffValues(
+		{ -30, -1, -0.02, 0.02, 1, 30 }
+	);
+
+	const std::string started = curve::kernels::isa_name();
+	EXPECT_TRUE(curve::kernels::select_isa(started.c_str()));
+	EXPECT_FALSE(curve::kernels::select_isa("mmx"));
+	EXPECT_EQ(started, curve::kernels::isa_name());
+
+	// every set this CPU runs against the scalar one, which is always there
+	std::vector<std::string> sets;
+	for (const char* name : { "avx512", "avx2", "sse2", "scalar" })
+		if (curve::kernels::select_isa(name)) sets.push_back(name);
+	ASSERT_EQ("scalar", sets.back());
+
+	for (auto coeffIt = coeffsValues.at(0).begin();
+		coeffIt != coeffsValues.at(0).end();
+		++coeffIt)
+	{
+		const double a = *coeffIt;
+		std::vector<double> xs, as, inv_as;
+		std::vector<float> xfs;
+		// odd length for the tails, out past the overflow of cosh
+		for (int i = -357; i <= 357; ++i)
+		{
+			xs.push_back(a * i / 7.0 * (i % 5 ? 1 : 2));
+			xfs.push_back(static_cast<float>(xs.back()) / 8);
+			as.push_back(a * (1 + (i & 3)));
+			inv_as.push_back(1 / as.back());
+		}
+		xs.push_back(NAN);
+		xs.push_back(0);
+		xfs.push_back(NAN);
+		xfs.push_back(0);
+		as.insert(as.end(), { a, a });
+		inv_as.insert(inv_as.end(), { 1 / a, 1 / a });
+		const std::size_t n = xs.size();
+
+		const auto run = [&](std::vector<std::vector<double>>& out, std::vector<float>& single, double (&range)[2], bool& finite)
+		{
+			out.assign(8, std::vector<double>(n));
+			single.assign(n, 0);
+			curve::kernels::ordinate(a, xs.data(), out[0].data(), n);
+			curve::kernels::arc_length(a, xs.data(), out[1].data(), n);
+			curve::kernels::curvature_radius(a, xs.data(), out[2].data(), n);
+			curve::kernels::log_ordinate(a, xs.data(), out[3].data(), n);
+			curve::kernels::inverse_arc_length(a, out[1].data(), out[4].data(), n);
+			curve::kernels::ordinate_each(as.data(), inv_as.data(), xs.data(), out[5].data(), n);
+			curve::kernels::hyperbolic(a, xs.data(), out[6].data(), out[7].data(), n);
+			curve::kernels::ordinate(static_cast<float>(a), xfs.data(), single.data(), n);
+			finite = curve::kernels::magnitude_range(xs.data(), n - 2, range[0], range[1]);
+		};
+
+		std::vector<std::vector<double>> expected;
+		std::vector<float> expected_single;
+		double expected_range[2];
+		bool expected_finite;
+		run(expected, expected_single, expected_range, expected_finite);
+
+		for (const std::string& name : sets)
+		{
+			ASSERT_TRUE(curve::kernels::select_isa(name.c_str()));
+			EXPECT_EQ(name, curve::kernels::isa_name());
+
+			std::vector<std::vector<double>> got;
+			std::vector<float> single;
+			double range[2];
+			bool finite;
+			run(got, single, range, finite);
+
+			for (std::size_t k = 0; k < got.size(); ++k)
+				for (std::size_t i = 0; i < n; ++i)
+					EXPECT_TRUE(double_close(expected[k][i], got[k][i], std::abs(expected[k][i]), 4e-15))
+						<< EXPECT_failureinfo(expected[k][i], got[k][i], xs[i], a, name.c_str()) << " kernel " << k;
+			for (std::size_t i = 0; i < n; ++i)
+				EXPECT_TRUE(double_close(expected_single[i], single[i], std::abs(expected_single[i]), 4 * FLT_EPSILON))
+					<< EXPECT_failureinfo(expected_single[i], single[i], xfs[i], a, name.c_str());
+			EXPECT_EQ(expected_finite, finite) << name;
+			EXPECT_EQ(expected_range[0], range[0]) << name;
+			EXPECT_EQ(expected_range[1], range[1]) << name;
+		}
+	}
+
+	EXPECT_TRUE(curve::kernels::select_isa(started.c_str()));
+}
+
+TEST(QueryCacheTest, CachedCatenaryCheck)
+{
+	curve::QueryCache cache(1024, 4);
+	EXPECT_EQ(1024u, cache.capacity());
+
+	curve::CachedCatenary cached(2.5, cache);
+	const curve::Catenary c(2.5), other(-7);
+	curve::CachedCatenary cached_other(-7, cache);
+
+	for (int pass = 0; pass < 2; ++pass)
+		for (int i = 0; i < 50; ++i)
+		{
+			const double x = i * 0.37 - 9;
+			EXPECT_EQ(c.y(x), cached.y(x));
+			EXPECT_EQ(c.l(x), cached.l(x));
+			EXPECT_EQ(c.S(x, -x), cached.S(x, -x));
+			EXPECT_EQ(c.CurvatureCenterCoords(x), cached.CurvatureCenterCoords(x));
+			EXPECT_EQ(other.R(x), cached_other.R(x));
+		}
+
+	// the first pass misses, the second hits
+	EXPECT_EQ(250u, cache.counters().misses);
+	EXPECT_EQ(250u, cache.counters().hits);
+	EXPECT_EQ(250u, cache.size());
+
+	// set_a leaves the old curve's entries, invalidate drops them and no other
+	cached.set_a(3);
+	EXPECT_EQ(250u, cache.size());
+	EXPECT_EQ(curve::Catenary(3).y(1), cached.y(1));
+	EXPECT_EQ(251u, cache.size());
+	cache.invalidate(2.5);
+	EXPECT_EQ(51u, cache.size());
+	EXPECT_EQ(other.R(1), cached_other.R(1));
+
+	// a full shard replaces entries, the ones in use survive
+	cache.clear();
+	for (int i = 0; i < 5000; ++i)
+	{
+		cached_other.y(0.5);
+		cached_other.y(i);
+	}
+	EXPECT_GE(cache.capacity(), cache.size());
+	const std::uint64_t misses = cache.counters().misses;
+	cached_other.y(0.5);
+	EXPECT_EQ(misses, cache.counters().misses);
+
+	// concurrent readers of a warm cache
+	std::vector<std::thread> readers;
+	std::vector<int> wrong(4);
+	for (int t = 0; t < 4; ++t)
+		readers.emplace_back([&, t] {
+			for (int k = 0; k < 20000; ++k)
+				if (cached_other.y(0.5) != other.y(0.5) || cached_other.l(k % 64) != other.l(k % 64)) ++wrong[t];
+		});
+	for (auto& r : readers) r.join();
+	for (int t = 0; t < 4; ++t) EXPECT_EQ(0, wrong[t]);
+
+	EXPECT_THROW(curve::QueryCache(0), std::invalid_argument);
+}
+
+TEST(NumericIoTest, ParseCheck)
+{
+	auto parse_double = [](const char* text, double& value) {
+		return sfio::parse(text, text + std::strlen(text), value);
+	};
+	auto parse_int = [](const char* text, int& value) {
+		return sfio::parse(text, text + std::strlen(text), value);
+	};
+
+	double d = 0;
+	int i = 0;
+
+	EXPECT_EQ(sfio::parse_result::ok, parse_double("  -1234.5e-3", d));
+	EXPECT_EQ(-1.2345, d);
+	EXPECT_EQ(sfio::parse_result::ok, parse_double("+10", d));
+	EXPECT_EQ(10, d);
+	EXPECT_EQ(sfio::parse_result::ok, parse_double(".5", d));
+	EXPECT_EQ(0.5, d);
+
+	EXPECT_EQ(sfio::parse_result::empty, parse_double(" \t", d));
+	EXPECT_EQ(sfio::parse_result::invalid, parse_double("abc", d));
+	EXPECT_EQ(sfio::parse_result::invalid, parse_double("+-1", d));
+	EXPECT_EQ(sfio::parse_result::invalid, parse_double("inf", d));
+	EXPECT_EQ(sfio::parse_result::invalid, parse_double("1e999", d));
+	EXPECT_EQ(sfio::parse_result::trailing, parse_double("1.5 ", d));
+	EXPECT_EQ(sfio::parse_result::trailing, parse_double("1.5x", d));
+	EXPECT_EQ(0.5, d);
+
+	EXPECT_EQ(sfio::parse_result::ok, parse_int("4", i));
+	EXPECT_EQ(4, i);
+	EXPECT_EQ(sfio::parse_result::trailing, parse_int("4.5", i));
+	EXPECT_EQ(sfio::parse_result::invalid, parse_int("99999999999", i));
+	EXPECT_EQ(4, i);
+
+	char buf[sfio::max_chars];
+	EXPECT_EQ("15.4308", std::string(buf, sfio::format(buf, buf + sizeof(buf), 15.430806348152437, 6)));
+	EXPECT_EQ("1e+100", std::string(buf, sfio::format(buf, buf + sizeof(buf), 1e100, 6)));
+	EXPECT_EQ("0.1", std::string(buf, sfio::format(buf, buf + sizeof(buf), 0.1)));
+
+	// the fast paths against the general ones: exact ties and near-ties,
+	// every branch of %g, then random values of every magnitude
+	std::vector<double> values = { 0.5, 2.5, -2.5, 1.5e-5, 999999.5, 9.9999995, 123456.5, 0.000123456,
+		0.0001, 0.00009999995, 1e15, 123456789012345.0, 1e-22, 1e22, 5e-324, -0.0, 0.0, 1.0 / 3 };
+	std::mt19937_64 gen(7);
+	std::uniform_real_distribution<double> mantissa(1, 10);
+	std::uniform_int_distribution<int> exponent(-30, 30);
+	for (int k = 0; k < 20000; ++k)
+		values.push_back((k & 1 ? -1 : 1) * mantissa(gen) * std::pow(10.0, exponent(gen)));
+
+	char expected[64], text[64];
+	for (double v : values)
+		for (int precision = 1; precision <= 17; ++precision)
+		{
+			std::snprintf(expected, sizeof(expected), "%.*g", precision, v);
+			char* const end = sfio::format(text, text + sizeof(text), v, precision);
+			EXPECT_EQ(std::string(expected), std::string(text, end)) << precision;
+		}
+
+	for (double v : values)
+		for (int precision : { 6, 10, 15, 17 })
+		{
+			// plain decimals take the fast path, "%e" forms the general one
+			for (const char* form : { "%.*f", "%.*e" })
+			{
+				const int n = std::snprintf(text, sizeof(text), form, precision, v);
+				double parsed = 0, reference = 0;
+				ASSERT_EQ(sfio::parse_result::ok, sfio::parse(text, text + n, parsed)) << text;
+				std::from_chars(text, text + n, reference);
+				EXPECT_EQ(0, std::memcmp(&reference, &parsed, sizeof(double))) << text;
+			}
+		}
+	EXPECT_EQ(sfio::parse_result::ok, parse_double("-.5", d));
+	EXPECT_EQ(-0.5, d);
+	EXPECT_EQ(sfio::parse_result::ok, parse_double("12345678901234567890123", d));
+	EXPECT_EQ(std::strtod("12345678901234567890123", nullptr), d);
+	EXPECT_EQ(sfio::parse_result::ok, parse_double("9007199254740993", d));
+	EXPECT_EQ(9007199254740992.0, d);
+	EXPECT_EQ(sfio::parse_result::ok, parse_double("5.", d));
+	EXPECT_EQ(5, d);
+	EXPECT_EQ(sfio::parse_result::trailing, parse_double("1.2.3", d));
+	EXPECT_EQ(sfio::parse_result::invalid, parse_double("-", d));
+}
+
+TEST(BulkIoTest, RoundTripCheck)
+{
+	const char* input = "bulk_io_test.in";
+	const char* output = "bulk_io_test.out";
+	const double a = -2.5;
+	const std::size_t n = 1000;
+	const curve::Catenary c(a);
+
+	for (std::int32_t op : { batch::get_ordinate, batch::get_curvature_center_coordinates, batch::get_trapeze_area })
+	{
+		{
+			bulk::writer job(input, bulk::make_header(a, op, bulk::input_columns(op), n));
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				job.column(0)[i] = -50 + 0.1 * i;
+				if (op == batch::get_trapeze_area) job.column(1)[i] = 0.05 * i;
+			}
+		}
+
+		EXPECT_EQ(n, bulk::run(input, output));
+
+		const bulk::reader in(input);
+		const bulk::reader result(output);
+		ASSERT_EQ(bulk::output_columns(op), result.info().columns);
+		ASSERT_EQ(n, result.info().count);
+		EXPECT_EQ(a, result.info().a);
+
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const double x = in.column(0)[i];
+			if (op == batch::get_ordinate)
+				EXPECT_TRUE(double_close(std::abs(c.y(x)), result.column(0)[i], std::abs(c.y(x))));
+			else if (op == batch::get_trapeze_area)
+			{
+				const double s = std::abs(c.S(x, in.column(1)[i]));
+				EXPECT_TRUE(double_close(s, result.column(0)[i], s + std::abs(a * c.l(x))));
+			}
+			else
+			{
+				const curve::coords_pair centers(c.CurvatureCenterCoords(x));
+				const double x_scale = std::abs(x) + std::abs(c.l(x) * c.y(x) / a), y_scale = 2 * std::abs(c.y(x));
+				EXPECT_TRUE(double_close(centers.first.first, result.column(0)[i], x_scale));
+				EXPECT_TRUE(double_close(centers.first.second, result.column(1)[i], y_scale));
+				EXPECT_TRUE(double_close(centers.second.first, result.column(2)[i], x_scale));
+				EXPECT_TRUE(double_close(centers.second.second, result.column(3)[i], y_scale));
+			}
+		}
+	}
+
+	// writing the result over the job would truncate it while it is mapped,
+	// with fewer output than input columns reads run past the new end
+	EXPECT_THROW(bulk::run(input, input), std::runtime_error);
+	{
+		const bulk::reader in(input);
+		ASSERT_EQ(bulk::input_columns(batch::get_trapeze_area), in.info().columns);
+		ASSERT_EQ(n, in.info().count);
+		EXPECT_EQ(0.05 * (n - 1), in.column(1)[n - 1]);
+	}
+
+	{
+		bulk::writer job(input, bulk::make_header(a, 42, 1, n));
+	}
+	EXPECT_THROW(bulk::run(input, output), std::runtime_error);
+	EXPECT_THROW(bulk::reader("bulk_io_test.missing"), std::runtime_error);
+
+	// a column count that would overflow the size is refused before any use
+	{
+		std::FILE* f = std::fopen(input, "r+b");
+		ASSERT_NE(nullptr, f);
+		const std::uint32_t columns = 0x80000000u;
+		std::fseek(f, offsetof(bulk::header, columns), SEEK_SET);
+		std::fwrite(&columns, sizeof(columns), 1, f);
+		std::fclose(f);
+	}
+	EXPECT_THROW(bulk::reader{ input }, std::runtime_error);
+	EXPECT_THROW(bulk::writer(output, bulk::make_header(a, batch::get_ordinate, 0, n)), std::runtime_error);
+
+	std::remove(input);
+	std::remove(output);
+}
+
+TEST(InstrumentTest, HistogramCheck)
+{
+	// every value lies in its bucket, and buckets are within 1/16 of their values
+	for (std::uint64_t v : { 0ull, 1ull, 15ull, 16ull, 17ull, 31ull, 32ull, 1000ull, 123456789ull, 1ull << 47 })
+	{
+		const std::size_t b = instrument::histogram::index(v);
+		EXPECT_LE(instrument::histogram::lower(b), v);
+		EXPECT_GE(instrument::histogram::upper(b), v);
+		EXPECT_LE(instrument::histogram::upper(b) - instrument::histogram::lower(b), v / 16);
+	}
+	EXPECT_EQ(instrument::histogram::bucket_count - 1, instrument::histogram::index(UINT64_MAX));
+
+	const std::unique_ptr<instrument::profile> p(new instrument::profile);
+	for (std::uint64_t v = 1; v <= 1000; ++v)
+		p->record(instrument::stage::area, v * 100);
+	p->add(instrument::stage::flush, 4096);
+	{
+		const instrument::scope probe(*p, instrument::stage::flush);
+	}
+
+	const instrument::histogram& h = p->latency(instrument::stage::area);
+	EXPECT_EQ(1000u, h.count());
+	EXPECT_EQ(100u, h.min());
+	EXPECT_EQ(100000u, h.max());
+	EXPECT_EQ(50050000u, h.sum());
+	EXPECT_NEAR(50000.0, static_cast<double>(h.percentile(0.5)), 50000.0 / 16);
+	EXPECT_NEAR(99000.0, static_cast<double>(h.percentile(0.99)), 99000.0 / 16);
+	EXPECT_EQ(100000u, h.percentile(1));
+	EXPECT_EQ(1u, p->latency(instrument::stage::flush).count());
+	EXPECT_EQ(4096u, p->items(instrument::stage::flush));
+
+	// only the stages seen make it into the dump
+	std::FILE* f = std::tmpfile();
+	ASSERT_NE(nullptr, f);
+	p->write_json(f);
+	std::rewind(f);
+	std::string json;
+	char chunk[4096];
+	for (std::size_t got; (got = std::fread(chunk, 1, sizeof(chunk), f)) != 0; )
+		json.append(chunk, got);
+	std::fclose(f);
+
+	EXPECT_NE(std::string::npos, json.find("\"name\": \"area\""));
+	EXPECT_NE(std::string::npos, json.find("\"count\": 1000,"));
+	EXPECT_NE(std::string::npos, json.find("\"items\": 4096,"));
+	EXPECT_EQ(std::string::npos, json.find("\"ordinate\""));
+	EXPECT_EQ('{', json.front());
+	EXPECT_EQ(std::string("}\n"), json.substr(json.size() - 2));
+
+	p->reset();
+	EXPECT_EQ(0u, h.count());
+	EXPECT_EQ(0u, h.min());
+}
+
+TEST(RingTest, TransferCheck)
+{
+	// one producer, one consumer: everything arrives, in order
+	curve::SpscRing<std::uint64_t> spsc(100);
+	EXPECT_EQ(128u, spsc.capacity());
+	const std::uint64_t n = 200000;
+	std::thread producer([&]
+	{
+		for (std::uint64_t i = 1; i <= n; ++i)
+			while (!spsc.try_push(i)) std::this_thread::yield();
+	});
+	std::uint64_t expected = 1;
+	while (expected <= n)
+	{
+		std::uint64_t v;
+		if (!spsc.try_pop(v)) { std::this_thread::yield(); continue; }
+		ASSERT_EQ(expected, v);
+		++expected;
+	}
+	producer.join();
+
+	// many of each: everything arrives exactly once
+	curve::MpmcRing<std::uint64_t> mpmc(64);
+	std::uint64_t v;
+	EXPECT_FALSE(mpmc.try_pop(v));
+	const unsigned producers = 3, consumers = 3;
+	const std::uint64_t per_producer = 50000;
+	std::atomic<std::uint64_t> sum{ 0 }, count{ 0 };
+	std::vector<std::thread> threads;
+	for (unsigned p = 0; p < producers; ++p)
+		threads.emplace_back([&, p]
+		{
+			for (std::uint64_t i = 1; i <= per_producer; ++i)
+				while (!mpmc.try_push(p * per_producer + i)) std::this_thread::yield();
+		});
+	for (unsigned c = 0; c < consumers; ++c)
+		threads.emplace_back([&]
+		{
+			while (count.load() < producers * per_producer)
+			{
+				std::uint64_t got;
+				if (!mpmc.try_pop(got)) { std::this_thread::yield(); continue; }
+				sum += got;
+				++count;
+			}
+		});
+	for (std::thread& t : threads) t.join();
+	const std::uint64_t total = producers * per_producer;
+	EXPECT_EQ(total, count.load());
+	EXPECT_EQ(total * (total + 1) / 2, sum.load());
+
+	for (std::uint64_t i = 0; i < mpmc.capacity(); ++i) EXPECT_TRUE(mpmc.try_push(i));
+	EXPECT_FALSE(mpmc.try_push(0));
+}
+
+TEST(BatchTest, PipelineCheck)
+{
+	// long runs of one curve and op, short ones, and bad records in between
+	std::string text;
+	std::vector<batch::record> records;
+	for (int i = 0; i < 20000; ++i)
+	{
+		batch::record r{};
+		r.a = i % 7000 < 5000 ? 2.5 : -0.5 - i % 3;
+		r.op = batch::get_ordinate + (i / 900 + (i % 7000 < 5000 ? 0 : i)) % 5;
+		r.x = (i % 301) / 10.0 - 15;
+		r.x2 = r.x / 3 + 1;
+		if (i % 997 == 0) r.a = 0;
+		if (i % 1999 == 0) r.op = 9;
+		records.push_back(r);
+
+		char line[160];
+		std::snprintf(line, sizeof(line), r.op == batch::get_trapeze_area ? "%.17g %d %.17g %.17g\n" : "%.17g %d %.17g\n",
+			r.a, r.op, r.x, r.x2);
+		text += line;
+		if (i % 4999 == 0) text += "1 2 garbage\n\n";
+	}
+
+	for (batch::format f : { batch::format::text, batch::format::binary })
+	{
+		const char* source = "pipeline_test.in";
+		{
+			std::FILE* in = std::fopen(source, "wb");
+			ASSERT_NE(nullptr, in);
+			if (f == batch::format::text) std::fwrite(text.data(), 1, text.size(), in);
+			else std::fwrite(records.data(), sizeof(batch::record), records.size(), in);
+			std::fclose(in);
+		}
+
+		std::string outputs[2];
+		batch::stats stats[2];
+		std::unique_ptr<curve::Verifier> verifiers[2] = {
+			std::unique_ptr<curve::Verifier>(new curve::Verifier(7)), std::unique_ptr<curve::Verifier>(new curve::Verifier(7))
+		};
+		for (int parallel = 0; parallel < 2; ++parallel)
+		{
+			std::FILE* in = std::fopen(source, "rb");
+			std::FILE* out = std::tmpfile();
+			ASSERT_NE(nullptr, in);
+			ASSERT_NE(nullptr, out);
+			stats[parallel] = parallel
+				? batch::run_parallel(in, out, f, 3, verifiers[1].get())
+				: batch::run(in, out, f, nullptr, verifiers[0].get());
+			std::fclose(in);
+
+			std::rewind(out);
+			char chunk[4096];
+			for (std::size_t got; (got = std::fread(chunk, 1, sizeof(chunk), out)) != 0; )
+				outputs[parallel].append(chunk, got);
+			std::fclose(out);
+		}
+		std::remove(source);
+
+		EXPECT_EQ(stats[0].records, stats[1].records);
+		EXPECT_EQ(stats[0].errors, stats[1].errors);
+		EXPECT_LT(0u, stats[0].errors);
+
+		// both sample the same records, and either is a few ulp off the reference
+		for (int q = 0; q < 5; ++q)
+		{
+			const curve::Verifier::summary v[2] = {
+				verifiers[0]->result(static_cast<curve::query>(q)), verifiers[1]->result(static_cast<curve::query>(q))
+			};
+			EXPECT_LT(0u, v[0].checked);
+			EXPECT_EQ(v[0].checked, v[1].checked);
+			for (int k = 0; k < 2; ++k)
+				EXPECT_GT(32, v[k].max_ulps) << q << ' ' << k << ": a = " << v[k].worst_a << ", x = " << v[k].worst_x;
+		}
+
+		// the same numbers in the same order, to the few ulp the kernels differ by
+		std::vector<double> serial, parallel;
+		if (f == batch::format::binary)
+		{
+			ASSERT_EQ(outputs[0].size(), outputs[1].size());
+			serial.resize(outputs[0].size() / sizeof(double));
+			parallel.resize(serial.size());
+			std::memcpy(serial.data(), outputs[0].data(), outputs[0].size());
+			std::memcpy(parallel.data(), outputs[1].data(), outputs[1].size());
+		}
+		else
+		{
+			EXPECT_EQ(std::count(outputs[0].begin(), outputs[0].end(), '\n'), std::count(outputs[1].begin(), outputs[1].end(), '\n'));
+			for (int k = 0; k < 2; ++k)
+			{
+				std::vector<double>& numbers = k ? parallel : serial;
+				const char* p = outputs[k].c_str();
+				for (char* next; ; p = next)
+				{
+					const double v = std::strtod(p, &next);
+					if (next == p) break;
+					numbers.push_back(v);
+				}
+			}
+		}
+		// centers and areas cancel, so every number is held to its record's terms
+		std::vector<double> scales;
+		for (std::size_t i = 0; i < records.size(); ++i)
+		{
+			const batch::record& r = records[i];
+			const bool bad = r.a == 0 || r.op < batch::get_ordinate || r.op > batch::get_trapeze_area;
+			const int n = r.op == batch::get_curvature_center_coordinates && (!bad || f == batch::format::binary) ? 4 : 1;
+			const curve::Catenary c(bad ? 1 : r.a);
+			const double scale = std::abs(r.x) + 2 * std::abs(c.y(r.x)) + std::abs(c.l(r.x) * c.y(r.x) / c.get_a())
+				+ std::abs(c.get_a()) * (std::abs(c.l(r.x)) + std::abs(c.l(r.x2)));
+			scales.insert(scales.end(), n, scale);
+			if (f == batch::format::text && i % 4999 == 0) scales.push_back(0);
+		}
+
+		ASSERT_EQ(scales.size(), serial.size());
+		ASSERT_EQ(serial.size(), parallel.size());
+		for (std::size_t i = 0; i < serial.size(); ++i)
+			EXPECT_TRUE(double_close(serial[i], parallel[i], scales[i], 1e-13)) << i << ' ' << serial[i] << ' ' << parallel[i];
+	}
+
+	// empty input: nothing written, nothing counted
+	std::FILE* in = std::tmpfile();
+	std::FILE* out = std::tmpfile();
+	const batch::stats none = batch::run_parallel(in, out, batch::format::text, 2);
+	EXPECT_EQ(0u, none.records);
+	EXPECT_EQ(0L, std::ftell(out));
+	std::fclose(in);
+	std::fclose(out);
+
+	// a truncated last record is one more error, answered with NaN
+	for (int parallel = 0; parallel < 2; ++parallel)
+	{
+		std::FILE* in = std::tmpfile();
+		std::FILE* out = std::tmpfile();
+		std::fwrite(records.data() + 1, sizeof(batch::record), 2, in);
+		std::fwrite(records.data() + 3, 1, 12, in);
+		std::rewind(in);
+		const batch::stats cut = parallel
+			? batch::run_parallel(in, out, batch::format::binary, 2)
+			: batch::run(in, out, batch::format::binary);
+		EXPECT_EQ(3u, cut.records);
+		EXPECT_EQ(1u, cut.errors);
+
+		double results[4];
+		std::rewind(out);
+		ASSERT_EQ(3u, std::fread(results, sizeof(double), 4, out));
+		const double y = curve::Catenary(records[1].a).y(records[1].x);
+		EXPECT_TRUE(double_close(y, results[0], y)) << parallel;
+		EXPECT_TRUE(std::isnan(results[2]));
+		std::fclose(in);
+		std::fclose(out);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}